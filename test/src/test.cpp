@@ -36,7 +36,25 @@ int main() {
     tp.natnet_params.cmd_port        = 1510;
     tp.natnet_params.data_port       = 1511;
     tp.natnet_params.con_type        = tracking::NatNetDevicePool::ConnectionType::UniCast;
+    tp.natnet_params.multicast_ip    = "";                     // Group announced by server
+    tp.natnet_params.multicast_ip_len = 0;
+    tp.natnet_params.receive_buffer_size = 0;
     tp.natnet_params.verbose_client  = false;
+    tp.natnet_params.native_client   = false;   // Built-in client is always used without NatNet SDK
+    tp.natnet_params.prediction.model             = tracking::PosePredictor::Model::ConstantVelocity;
+    tp.natnet_params.prediction.horizon           = 0.05f;      // Maximal prediction in seconds
+    tp.natnet_params.prediction.process_noise     = 500.0f;
+    tp.natnet_params.prediction.measurement_noise = 0.0000005f;
+    tp.natnet_params.subscription    = false;    // Markers and skeletons are dropped with subscription
+    tp.natnet_params.connect_timeout = 0.0f;     // Default timeout of requests to the server
+    std::string cache_file           = "tracking.cache"; // Leave empty to always look up rigid bodies on connect
+    tp.natnet_params.cache_file      = cache_file.c_str();
+    tp.natnet_params.cache_file_len  = cache_file.length();
+    tp.natnet_params.servers         = nullptr;  // Further Motive servers merged into one tracking space
+    tp.natnet_params.server_count    = 0;
+    tp.natnet_params.standby_servers = nullptr;  // Servers replacing the server above if it stops sending frames
+    tp.natnet_params.standby_count   = 0;
+    tp.natnet_params.failover_timeout = 0.0f;    // Silence in seconds before reconnecting, to the next server if any (0 to disable)
 
     tracking::VrpnDevice<vrpn_Button_Remote>::Params bp;
     std::string device_name          =  "ControlBox"; // Leave empty to disable use of VRPN device
@@ -53,6 +71,8 @@ int main() {
 
     tp.vrpn_params                   = bps.data();
     tp.vrpn_params_count             = bps.size();
+    tp.vrpn_tracker_params           = nullptr;  // Rigid bodies fed by VRPN trackers instead of NatNet (e.g. from vrpn_Tracker_NULL)
+    tp.vrpn_tracker_params_count     = 0;
 
     /// TrackingUtilizer Parameters
     tracking::TrackingUtilizer::Params tup; 
@@ -124,6 +144,7 @@ int main() {
     float inters_x, inters_y;
     bool state;
 
+    uint64_t frame_sequence = tracker->GetFrameSequence();
     bool exit = false;
     while (!exit) {
 
@@ -140,8 +161,9 @@ int main() {
             }
             std::cout << std::endl;
 
-            // Intersection
-            state = tu.GetIntersection(inters_x, inters_y);
+            // Intersection (predicted to the time the result is shown, e.g. next vsync)
+            double display_time = tracking::GetLocalTime() + 0.016;
+            state = tu.GetIntersection(display_time, inters_x, inters_y);
             std::cout << std::fixed << std::setprecision(4) <<
                 "[INFO] [test] RIGID-BODY \"" << tu.GetRigidBodyName() << "\" - INTERSECTION (valid = "
                 << ((state) ? ("TRUE") : ("FALSE")) << ") ";
@@ -153,6 +175,18 @@ int main() {
         }
         std::cout << std::endl;
 
+        // Latency between camera exposure and reading the data
+        const char* stage_names[] = { "EXPOSURE->TRANSMIT", "TRANSMIT->RECEIVE", "RECEIVE->READ" };
+        for (int i = 0; i < tracking::NatNetDevicePool::LATENCY_STAGE_COUNT; ++i) {
+            tracking::LatencyHistogram::Statistics stats;
+            if (tracker->GetLatencyStatistics(static_cast<tracking::NatNetDevicePool::LatencyStage>(i), stats)) {
+                std::cout << std::fixed << std::setprecision(2) <<
+                    "[INFO] [test] LATENCY " << stage_names[i] << " [ms] - Mean: " << (stats.mean * 1000.0) << 
+                    " - P95: " << (stats.p95 * 1000.0) << " - Max: " << (stats.max * 1000.0) << " (" << stats.count << " samples)" << std::endl;
+            }
+        }
+        std::cout << std::endl;
+
         // Wait for user input (press 'ESC') to end loop
         std::cout << "[Press 'ESC' to exit program]" << std::endl << std::endl;
         int key = 0x1B; // ESC
@@ -160,8 +194,10 @@ int main() {
             exit = true;
         }
 
-        // Sleep some ms to limit data output
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        // Sleep some ms to limit data output, then sleep until new data arrives (at most 500 ms to check for 'ESC').
+        // Input threads can wait on tracker->GetFrameDescriptor() with poll/epoll (WaitForMultipleObjects on Windows) instead.
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        frame_sequence = tracker->WaitForFrame(frame_sequence, 0.5);
     }
 
     return 0;
@@ -0,0 +1,185 @@
+/**
+ * FailoverTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetDevicePool.h"
+#include "NatNetTestData.h"
+#include "NatNetTestServer.h"
+#include "UnitTest.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Failover between two stand-in servers on the loopback interface: the
+* pool connects to the first server, which stops streaming, and has to
+* switch to the standby server. The standby server streams the same
+* rigid body and skeleton under other streaming IDs plus a new skeleton.
+* Handles, names and published skeletons have to stay unchanged (the new
+* skeleton is appended), while a reader thread queries the skeleton table
+* during the failover.
+*
+* Usage: ./FailoverTest
+*
+******************************************************************************/
+
+namespace {
+
+    tracking::test::Checker check("FailoverTest");
+
+    /** Skeleton with two bones (bone 2 is a child of bone 1). */
+    tracking::test::TestSkeleton make_skeleton(int32_t id, const std::string& name, float t) {
+        tracking::test::TestSkeleton s;
+        s.id = id;
+        s.name = name;
+        s.bones.emplace_back(tracking::test::MakeRigidBody(1, name + "_Hip", t));
+        s.bones.emplace_back(tracking::test::MakeRigidBody(2, name + "_Spine", t));
+        s.bones[1].parent_id = 1;
+        return s;
+    }
+
+    /** Frame source of a server streaming the rigid body and skeletons at position t. */
+    tracking::test::NatNetTestServer::FrameSource make_source(int32_t rigid_body_id, const std::vector<tracking::test::TestSkeleton>& skeletons, float t) {
+        return [=](int32_t frame) {
+            tracking::test::TestFrame f;
+            f.frame = frame;
+            f.rigid_bodies.emplace_back(tracking::test::MakeRigidBody(rigid_body_id, "", t));
+            f.skeletons               = skeletons;
+            f.timestamp               = 0.01 * frame;
+            f.mid_exposure_timestamp  = 0;
+            f.data_received_timestamp = 0;
+            f.transmit_timestamp      = 0;
+            f.params                  = 0;
+            return tracking::test::BuildFrame(4, 1, f);
+        };
+    }
+}
+
+
+int main(int argc, char** argv) {
+
+    // Primary server: rigid body "Wand" as ID 1, skeleton "Bob" as ID 1.
+    tracking::test::NatNetTestServer primary(4, 1);
+    std::vector<tracking::test::TestSkeleton> primary_skeletons = { make_skeleton(1, "Bob", 1.0f) };
+    primary.SetModelDef(tracking::test::BuildModelDef(4, 1, { tracking::test::MakeRigidBody(1, "Wand", 0.0f) }, primary_skeletons));
+    primary.SetStreaming(true, make_source(1, primary_skeletons, 1.0f));
+
+    // Standby server: "Wand" as ID 3, "Bob" as ID 5 and the new skeleton "Alice".
+    tracking::test::NatNetTestServer standby(4, 1);
+    std::vector<tracking::test::TestSkeleton> standby_skeletons = { make_skeleton(5, "Bob", 2.0f), make_skeleton(6, "Alice", 2.0f) };
+    standby.SetModelDef(tracking::test::BuildModelDef(4, 1, { tracking::test::MakeRigidBody(3, "Wand", 0.0f) }, standby_skeletons));
+    standby.SetStreaming(true, make_source(3, standby_skeletons, 2.0f));
+
+    if (!primary.Start(0) || !standby.Start(0)) {
+        return 1;
+    }
+
+    tracking::NatNetDevicePool::ServerParams sp;
+    sp.server_ip     = "127.0.0.1";
+    sp.server_ip_len = 9;
+    sp.cmd_port      = standby.GetPort();
+    sp.data_port     = 0;
+    sp.orientation   = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    sp.position      = glm::vec3(0.0f, 0.0f, 0.0f);
+
+    tracking::NatNetDevicePool::Params p;
+    p.client_ip                    = "127.0.0.1";
+    p.client_ip_len                = 9;
+    p.server_ip                    = "127.0.0.1";
+    p.server_ip_len                = 9;
+    p.cmd_port                     = primary.GetPort();
+    p.data_port                    = 0;
+    p.con_type                     = tracking::NatNetDevicePool::ConnectionType::UniCast;
+    p.multicast_ip                 = "";
+    p.multicast_ip_len             = 0;
+    p.receive_buffer_size          = 0;
+    p.verbose_client               = false;
+    p.native_client                = true;
+    p.prediction.model             = tracking::PosePredictor::Model::None;
+    p.prediction.horizon           = 0.0f;
+    p.prediction.process_noise     = 500.0f;
+    p.prediction.measurement_noise = 0.0000005f;
+    p.subscription                 = false;
+    p.connect_timeout              = 0.2f;
+    p.cache_file                   = "";
+    p.cache_file_len               = 0;
+    p.servers                      = nullptr;
+    p.server_count                 = 0;
+    p.standby_servers              = &sp;
+    p.standby_count                = 1;
+    p.failover_timeout             = 0.2f;
+
+    tracking::NatNetDevicePool pool;
+    if (!pool.Initialise(p) || !pool.Connect()) {
+        std::cerr << "[ERROR] [FailoverTest] Failed to connect to the primary server." << std::endl;
+        return 1;
+    }
+
+    int wand = pool.ResolveRigidBody("Wand");
+    int bob = pool.ResolveSkeleton("Bob");
+    std::vector<std::string> bone_names;
+    std::vector<int> bone_parents;
+    check((wand >= 0) && (bob >= 0) && pool.GetSkeletonBones(bob, bone_names, bone_parents), "Resolving primary descriptions");
+    check((bone_names.size() == 2) && (bone_parents.size() == 2) && (bone_parents[0] == -1) && (bone_parents[1] == 0), "Bone hierarchy");
+
+    tracking::NatNetDevicePool::RigidBodyData data;
+    check(tracking::test::WaitFor([&]() { return pool.GetRigidBodyData(wand, data) && (data.frame > 0) && (data.position.x == 1.0f); }, 2.0), "Receiving frames of the primary server");
+
+    // Polling the same frame records its read latency once.
+    pool.ResetLatencyStatistics();
+    size_t frames = 0;
+    int frame = -1;
+    for (int i = 0; i < 200; ++i) {
+        if (pool.GetRigidBodyData(wand, data) && !data.stale && (data.frame != frame)) {
+            frame = data.frame;
+            frames++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    tracking::LatencyHistogram::Statistics latency;
+    bool recorded = pool.GetLatencyStatistics(tracking::NatNetDevicePool::ReceiveToRead, latency);
+    check(recorded && (latency.count > 0) && (latency.count <= frames),
+        "Read latency once per frame (" + std::to_string(latency.count) + " records of " + std::to_string(frames) + " frames)");
+
+    // Consumers query the skeleton table during the failover.
+    std::atomic<bool> stop(false);
+    std::atomic<int> inconsistent(0);
+    std::thread reader([&]() {
+        std::vector<std::string> names;
+        std::vector<int> parents;
+        while (!stop.load()) {
+            if ((pool.ResolveSkeleton("Bob") != bob) || (pool.GetSkeletonNames().empty()) || (pool.GetSkeletonNames()[0] != "Bob") ||
+                !pool.GetSkeletonBones(bob, names, parents) || (names != bone_names) || (parents != bone_parents)) {
+                inconsistent++;
+            }
+        }
+    });
+
+    primary.SetStreaming(false);
+
+    tracking::NatNetDevicePool::FailoverStatistics stats;
+    check(tracking::test::WaitFor([&]() { pool.GetFailoverStatistics(stats); return (stats.server == 1) && (stats.failovers >= 1); }, 5.0), "Switching to the standby server");
+    check(tracking::test::WaitFor([&]() { return pool.GetRigidBodyData(wand, data) && (data.frame > 0) && (data.position.x == 2.0f); }, 2.0), "Receiving frames of the standby server");
+
+    stop.store(true);
+    reader.join();
+
+    // Handles and published skeletons are unchanged, "Bob" is mapped to its new ID and "Alice" is appended.
+    check(inconsistent.load() == 0, "Published skeleton unchanged during failover (" + std::to_string(inconsistent.load()) + " inconsistent reads)");
+    int alice = pool.ResolveSkeleton("Alice");
+    check((pool.ResolveRigidBody("Wand") == wand) && (pool.ResolveSkeleton("Bob") == bob) && (alice == bob + 1) && (pool.GetSkeletonCount() == 2), "Handles after failover");
+    check(tracking::test::WaitFor([&]() {
+        tracking::NatNetDevicePool::FramePtr frame = pool.GetLatestFrame();
+        return (frame && (frame->skeletons.size() == 2) && (frame->skeletons[bob].frame > 0) && (frame->skeletons[bob].bones.size() == 2) &&
+            (frame->skeletons[alice].frame > 0));
+    }, 2.0), "Skeleton tracked by the standby server");
+    check(tracking::test::WaitFor([&]() { pool.GetFailoverStatistics(stats); return (stats.last_latency >= p.failover_timeout); }, 2.0), "Failover latency");
+
+    pool.Disconnect();
+    primary.Stop();
+    standby.Stop();
+
+    std::cout << "[FailoverTest] " << stats.failovers << " failovers, latency " << stats.last_latency << " s: " << ((check.Passed()) ? ("PASSED") : ("FAILED")) << std::endl;
+    return (check.Passed()) ? (0) : (1);
+}
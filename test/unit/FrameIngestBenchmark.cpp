@@ -0,0 +1,162 @@
+/**
+ * FrameIngestBenchmark.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetDevicePool.h"
+#include "NatNetTestData.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Times the frame ingest path of the pool (decoding, streaming ID lookup,
+* storing the rigid bodies and publishing the frame) for 1 up to
+* MAX_RIGIDBODIES tracked rigid bodies per frame and prints the cost per
+* frame and per rigid body, without and with pose prediction. Frames are
+* fed to the callback of the built-in client directly, so no network is
+* involved. Build with CMAKE_BUILD_TYPE=Release for meaningful numbers.
+*
+* Usage: ./FrameIngestBenchmark [rigid body updates per body count]
+*
+******************************************************************************/
+
+namespace tracking {
+
+    /** Access to the frame callback of the pool (friend of NatNetDevicePool). */
+    class NatNetDevicePoolTest {
+    public:
+
+        /** Add rigid bodies with streaming IDs 1 to count and attach an unconnected built-in client (NatNet 4.1). */
+        static bool Prepare(NatNetDevicePool& pool, int count) {
+            std::lock_guard<std::mutex> lock(pool.m_table_mutex);
+            for (int id = 1; id <= count; ++id) {
+                if (!pool.add_rigid_body(id, "rb" + std::to_string(id), true)) {
+                    return false;
+                }
+            }
+            pool.m_native_client = std::make_unique<tracking::NatNetNativeClient>();
+            return pool.m_decoder.SetVersion(4, 1);
+        }
+
+        static void Ingest(NatNetDevicePool& pool, const char* payload, size_t size, double receive_time) {
+            NatNetDevicePool::on_packet(payload, size, receive_time, &pool);
+        }
+    };
+}
+
+
+namespace {
+
+    bool initialise(tracking::NatNetDevicePool& pool, tracking::PosePredictor::Model model) {
+        tracking::NatNetDevicePool::Params p;
+        p.client_ip                    = "";
+        p.client_ip_len                = 0;
+        p.server_ip                    = "";             /// No NatNet server, frames are fed directly.
+        p.server_ip_len                = 0;
+        p.cmd_port                     = 1510;
+        p.data_port                    = 1511;
+        p.con_type                     = tracking::NatNetDevicePool::ConnectionType::UniCast;
+        p.multicast_ip                 = "";
+        p.multicast_ip_len             = 0;
+        p.receive_buffer_size          = 0;
+        p.verbose_client               = false;
+        p.native_client                = true;
+        p.prediction.model             = model;
+        p.prediction.horizon           = 0.05f;
+        p.prediction.process_noise     = 500.0f;
+        p.prediction.measurement_noise = 0.0000005f;
+        p.subscription                 = false;
+        p.connect_timeout              = 0.0f;
+        p.cache_file                   = "";
+        p.cache_file_len               = 0;
+        p.servers                      = nullptr;
+        p.server_count                 = 0;
+        p.standby_servers              = nullptr;
+        p.standby_count                = 0;
+        p.failover_timeout             = 0.0f;
+        return pool.Initialise(p);
+    }
+
+    /**
+    * Ingest frames with count tracked rigid bodies.
+    *
+    * @return The mean time per frame in seconds, negative on failure.
+    */
+    double run(int count, tracking::PosePredictor::Model model, size_t updates) {
+        tracking::NatNetDevicePool pool;
+        if (!initialise(pool, model) || !tracking::NatNetDevicePoolTest::Prepare(pool, count)) {
+            return -1.0;
+        }
+
+        tracking::test::TestFrame f;
+        f.frame = 0;
+        for (int id = 1; id <= count; ++id) {
+            f.rigid_bodies.emplace_back(tracking::test::MakeRigidBody(id, "", 0.001f * static_cast<float>(id)));
+        }
+        f.timestamp               = 0.0;
+        f.mid_exposure_timestamp  = 0;
+        f.data_received_timestamp = 0;
+        f.transmit_timestamp      = 0;
+        f.params                  = 0;
+        std::vector<char> payload = tracking::test::BuildFrame(4, 1, f);
+
+        // Frame numbers have to increase, otherwise frames are dropped as duplicates.
+        size_t frames = (std::max)(static_cast<size_t>(100), updates / static_cast<size_t>(count));
+        int32_t frame = 0;
+        double time = tracking::GetLocalTime();
+        for (size_t i = 0; i < frames / 10; ++i) { /// Warm up (allocates the pool of published frames).
+            ++frame;
+            std::memcpy(payload.data(), &frame, sizeof(int32_t));
+            tracking::NatNetDevicePoolTest::Ingest(pool, payload.data(), payload.size(), time + 0.001 * frame);
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < frames; ++i) {
+            ++frame;
+            std::memcpy(payload.data(), &frame, sizeof(int32_t));
+            tracking::NatNetDevicePoolTest::Ingest(pool, payload.data(), payload.size(), time + 0.001 * frame);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        // All frames have to be published with all rigid bodies.
+        tracking::NatNetDevicePool::FramePtr latest = pool.GetLatestFrame();
+        if (!latest || (latest->frame != frame) || (latest->rigid_bodies.size() != static_cast<size_t>(count)) ||
+            (latest->rigid_bodies[count - 1].frame != frame)) {
+            return -1.0;
+        }
+        return elapsed / static_cast<double>(frames);
+    }
+}
+
+
+int main(int argc, char** argv) {
+
+    size_t updates = (argc > 1) ? (static_cast<size_t>(std::atol(argv[1]))) : (200000);
+    if (updates == 0) {
+        std::cerr << "Usage: " << argv[0] << " [rigid body updates per body count]" << std::endl;
+        return 1;
+    }
+
+    std::vector<int> counts;
+    for (int count = 1; count < MAX_RIGIDBODIES; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(MAX_RIGIDBODIES);
+
+    std::cout << "[FrameIngestBenchmark] Rigid bodies | us per frame | ns per rigid body | us per frame (prediction) | ns per rigid body (prediction)" << std::endl;
+    bool ok = true;
+    for (int count : counts) {
+        double plain = run(count, tracking::PosePredictor::Model::None, updates);
+        double predicted = run(count, tracking::PosePredictor::Model::ConstantVelocity, updates);
+        if ((plain < 0.0) || (predicted < 0.0)) {
+            std::cerr << "[ERROR] [FrameIngestBenchmark] Ingest of " << count << " rigid bodies failed." << std::endl;
+            ok = false;
+            continue;
+        }
+        std::printf("[FrameIngestBenchmark] %12d | %12.2f | %17.1f | %25.2f | %30.1f\n", count,
+            plain * 1.0e6, plain * 1.0e9 / count, predicted * 1.0e6, predicted * 1.0e9 / count);
+    }
+
+    return (ok) ? (0) : (1);
+}
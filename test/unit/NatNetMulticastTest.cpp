@@ -0,0 +1,141 @@
+/**
+ * NatNetMulticastTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetPacketDecoder.h"
+#include "NatNetNativeClient.h"
+#include "NatNetTestData.h"
+#include "NatNetTestServer.h"
+#include "UnitTest.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Replays frames from a stand-in server streaming to a multicast group on
+* the loopback interface. Two built-in NatNet clients join the group
+* announced by the server (sharing the data port) and both have to
+* receive all replayed frames in order.
+*
+* Usage: ./NatNetMulticastTest
+*
+******************************************************************************/
+
+using namespace tracking::test;
+
+namespace {
+
+    /** Multicast group of the test (not the default group of Motive). */
+    const char* const GROUP = "239.255.42.123";
+
+    /** Number of replayed frames. */
+    const int FRAME_COUNT = 50;
+
+    tracking::test::Checker check("NatNetMulticastTest");
+
+    /** Frames received by one client. */
+    struct Receiver {
+        tracking::NatNetPacketDecoder decoder;
+        std::atomic<int> frames;
+        std::atomic<int> malformed;
+        int32_t latest;                                  // Receive thread only
+    };
+
+    /** Frame with one rigid body whose pose is derived from the frame number. */
+    std::vector<char> make_frame(int32_t frame) {
+        TestFrame f;
+        f.frame = frame;
+        f.rigid_bodies.emplace_back(MakeRigidBody(1, "", static_cast<float>(frame)));
+        f.timestamp               = 0.01 * frame;
+        f.mid_exposure_timestamp  = 0;
+        f.data_received_timestamp = 0;
+        f.transmit_timestamp      = 0;
+        f.params                  = 0;
+        return BuildFrame(4, 1, f);
+    }
+
+    void __cdecl on_frame(const char* payload, size_t size, double receive_time, void* user_data) {
+        Receiver* receiver = static_cast<Receiver*>(user_data);
+        tracking::NatNetPacketDecoder::Frame frame;
+        tracking::NatNetPacketDecoder::RigidBody rb;
+        if (!receiver->decoder.DecodeFrame(payload, size, frame) || (frame.rigid_body_count != 1) || (frame.frame <= receiver->latest)) {
+            receiver->malformed++;
+            return;
+        }
+        tracking::NatNetPacketDecoder::ReadRigidBody(frame.rigid_bodies, rb);
+        if ((rb.id != 1) || (rb.position.x != static_cast<float>(frame.frame))) {
+            receiver->malformed++;
+            return;
+        }
+        receiver->latest = frame.frame;
+        receiver->frames++;
+    }
+}
+
+
+int main(void) {
+
+    NatNetTestServer server(4, 1);
+    server.SetMulticast(GROUP, 0);
+    if (!server.Start(0)) {
+        return 1;
+    }
+    server.SetModelDef(BuildModelDef(4, 1, { MakeRigidBody(1, "Wand", 0.0f) }, {}));
+
+    tracking::NatNetNativeClient::Params params;
+    params.local_address       = "127.0.0.1";
+    params.server_address      = "127.0.0.1";
+    params.command_port        = server.GetPort();
+    params.data_port           = 0;
+    params.multicast           = true;
+    params.multicast_address   = "";                 /// Group announced by the server.
+    params.receive_buffer_size = 0;
+    params.timeout             = 1.0;
+
+    tracking::NatNetNativeClient clients[2];
+    Receiver receivers[2];
+    for (int i = 0; i < 2; ++i) {
+        std::string label = "Client " + std::to_string(i);
+        sSender_Server info;
+        if (!clients[i].Connect(params, info)) {
+            check(false, label + ": connect");
+            return 1;
+        }
+        check(info.IsMulticast && (info.DataPort == server.GetDataPort()), label + ": multicast announced");
+        receivers[i].frames = 0;
+        receivers[i].malformed = 0;
+        receivers[i].latest = 0;
+        receivers[i].decoder.SetVersion(info.Common.NatNetVersion[0], info.Common.NatNetVersion[1]);
+        check(clients[i].Start(&on_frame, &receivers[i]), label + ": start");
+    }
+
+    // The server sends FRAME_COUNT frames to the group.
+    server.SetStreaming(true, [](int32_t frame) {
+        return make_frame(frame);
+    }, 0.002);
+    double timeout = tracking::GetLocalTime() + 5.0;
+    while ((server.GetFramesSent() < FRAME_COUNT) && (tracking::GetLocalTime() < timeout)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    server.SetStreaming(false);
+    int sent = server.GetFramesSent();
+    timeout = tracking::GetLocalTime() + 2.0;
+    while (((receivers[0].frames.load() < sent) || (receivers[1].frames.load() < sent)) && (tracking::GetLocalTime() < timeout)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& client : clients) {
+        client.Disconnect();
+    }
+    server.Stop();
+
+    for (int i = 0; i < 2; ++i) {
+        std::string label = "Client " + std::to_string(i);
+        check(receivers[i].frames.load() == sent, label + ": " + std::to_string(receivers[i].frames.load()) + " of " + std::to_string(sent) + " frames received");
+        check(receivers[i].malformed.load() == 0, label + ": " + std::to_string(receivers[i].malformed.load()) + " malformed or reordered frames");
+    }
+
+    std::cout << "[NatNetMulticastTest] " << sent << " frames sent, " << check.GetFailures() << " failures: " << ((check.Passed()) ? ("PASSED") : ("FAILED")) << std::endl;
+
+    return (check.Passed()) ? (0) : (1);
+}
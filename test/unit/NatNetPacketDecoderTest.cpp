@@ -0,0 +1,345 @@
+/**
+ * NatNetPacketDecoderTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetPacketDecoder.h"
+#include "NatNetNativeClient.h"
+#include "NatNetTestData.h"
+#include "NatNetTestServer.h"
+#include "UnitTest.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Feeds NAT_FRAMEOFDATA and NAT_MODELDEF payloads in the layouts of NatNet
+* 3.1, 4.0 and 4.1 through the decoder, including every truncation of the
+* payloads and negative counts, and replays frames from a stand-in server
+* on the loopback interface into the built-in NatNet client.
+*
+* Usage: ./NatNetPacketDecoderTest
+*
+******************************************************************************/
+
+using namespace tracking::test;
+
+namespace {
+
+    tracking::test::Checker check("NatNetPacketDecoderTest");
+
+    bool near(float a, float b) {
+        return (std::fabs(a - b) < 0.00001f);
+    }
+
+    std::vector<TestRigidBody> rigid_body_descriptions(void) {
+        std::vector<TestRigidBody> rbs;
+        rbs.emplace_back(MakeRigidBody(1, "Wand", 0.25f));
+        rbs.emplace_back(MakeRigidBody(7, "Head", 0.5f));
+        return rbs;
+    }
+
+    std::vector<TestSkeleton> skeleton_descriptions(void) {
+        TestSkeleton s;
+        s.id = 5;
+        s.name = "Bob";
+        s.bones.emplace_back(MakeRigidBody(1, "Hip", 1.0f));
+        s.bones.emplace_back(MakeRigidBody(2, "Chest", 0.5f));
+        s.bones[1].parent_id = 1;
+        return std::vector<TestSkeleton>(1, s);
+    }
+
+    TestFrame make_frame(int32_t frame) {
+        float t = 0.01f * static_cast<float>(frame);
+        TestFrame f;
+        f.frame = frame;
+        f.rigid_bodies.emplace_back(MakeRigidBody(1, "Wand", t));
+        f.rigid_bodies.emplace_back(MakeRigidBody(7, "Head", -t));
+        f.rigid_bodies[1].orientation = glm::quat(0.0f, 1.0f, 0.0f, 0.0f);
+        f.skeletons = skeleton_descriptions();
+        TestMarker m;
+        m.id       = (1 << 16) | 3;
+        m.position = glm::vec3(t, 0.0f, 1.0f);
+        m.size     = 0.014f;
+        m.params   = 0x04;
+        m.residual = 0.0002f;
+        f.labeled_markers.assign(2, m);
+        f.labeled_markers[1].id = 0x10;
+        f.timestamp               = 0.01 * static_cast<double>(frame);
+        f.mid_exposure_timestamp  = 1000 + frame;
+        f.data_received_timestamp = 2000 + frame;
+        f.transmit_timestamp      = 3000 + frame;
+        f.params                  = 2;
+        return f;
+    }
+
+    /** Check the decoded frame against make_frame(). */
+    bool check_frame(const tracking::NatNetPacketDecoder::Frame& frame, int32_t number, const std::string& label) {
+        TestFrame expected = make_frame(number);
+        int before = check.GetFailures();
+
+        check(frame.frame == number, label + ": frame number");
+        check(frame.rigid_body_count == 2, label + ": rigid body count");
+        for (int32_t i = 0; (i < frame.rigid_body_count) && (i < 2); ++i) {
+            tracking::NatNetPacketDecoder::RigidBody rb;
+            tracking::NatNetPacketDecoder::ReadRigidBody(frame.rigid_bodies + i * tracking::NatNetPacketDecoder::RIGID_BODY_SIZE, rb);
+            const TestRigidBody& e = expected.rigid_bodies[i];
+            check((rb.id == e.id) && near(rb.position.x, e.position.x) && near(rb.position.y, e.position.y) && near(rb.position.z, e.position.z) &&
+                near(rb.orientation.w, e.orientation.w) && near(rb.orientation.x, e.orientation.x) && near(rb.mean_error, e.mean_error) &&
+                (rb.params == e.params), label + ": rigid body " + std::to_string(i));
+        }
+
+        check(frame.skeleton_count == 1, label + ": skeleton count");
+        if (frame.skeleton_count == 1) {
+            int32_t id = 0;
+            int32_t bones = 0;
+            const char* record = tracking::NatNetPacketDecoder::ReadSkeleton(frame.skeletons, id, bones);
+            check((id == 5) && (bones == 2), label + ": skeleton header");
+            tracking::NatNetPacketDecoder::RigidBody bone;
+            tracking::NatNetPacketDecoder::ReadRigidBody(record + tracking::NatNetPacketDecoder::RIGID_BODY_SIZE, bone);
+            check((bone.id == ((5 << 16) | 2)) && near(bone.position.y, 1.0f), label + ": bone");
+        }
+
+        check(frame.labeled_marker_count == 2, label + ": labeled marker count");
+        if (frame.labeled_marker_count == 2) {
+            tracking::NatNetPacketDecoder::LabeledMarker m;
+            tracking::NatNetPacketDecoder::ReadLabeledMarker(frame.labeled_markers, m);
+            check((m.id == expected.labeled_markers[0].id) && near(m.position.x, expected.labeled_markers[0].position.x) && near(m.size, 0.014f) &&
+                (m.params == 0x04) && near(m.residual, 0.0002f), label + ": labeled marker");
+            tracking::NatNetPacketDecoder::ReadLabeledMarker(frame.labeled_markers + tracking::NatNetPacketDecoder::LABELED_MARKER_SIZE, m);
+            check(m.id == 0x10, label + ": second labeled marker");
+        }
+
+        check((frame.timestamp == expected.timestamp) && (frame.mid_exposure_timestamp == expected.mid_exposure_timestamp) &&
+            (frame.data_received_timestamp == expected.data_received_timestamp) && (frame.transmit_timestamp == expected.transmit_timestamp) &&
+            (frame.params == 2), label + ": frame suffix");
+
+        return (check.GetFailures() == before);
+    }
+
+    void set_int(std::vector<char>& payload, size_t offset, int32_t value) {
+        std::memcpy(payload.data() + offset, &value, sizeof(int32_t));
+    }
+
+    size_t find_string(const std::vector<char>& payload, const std::string& str) {
+        auto it = std::search(payload.begin(), payload.end(), str.c_str(), str.c_str() + str.length() + 1);
+        return static_cast<size_t>(it - payload.begin());
+    }
+
+    void test_frames(int major, int minor) {
+        std::string label = "NatNet " + std::to_string(major) + "." + std::to_string(minor) + " frame";
+        bool sized = HasSectionSizes(major, minor);
+        tracking::NatNetPacketDecoder decoder;
+        check(decoder.SetVersion(major, minor), label + ": version");
+
+        std::vector<char> payload = BuildFrame(major, minor, make_frame(42));
+        tracking::NatNetPacketDecoder::Frame frame;
+        check(decoder.DecodeFrame(payload.data(), payload.size(), frame), label + ": decode");
+        if (!check_frame(frame, 42, label)) {
+            return;
+        }
+
+        // Every truncation fails and reports no records.
+        size_t accepted = 0;
+        for (size_t size = 0; size < payload.size(); ++size) {
+            std::vector<char> truncated(payload.begin(), payload.begin() + size);
+            tracking::NatNetPacketDecoder::Frame f;
+            if (decoder.DecodeFrame(truncated.data(), truncated.size(), f) || (f.rigid_body_count != 0) || (f.skeleton_count != 0) || (f.labeled_marker_count != 0)) {
+                accepted++;
+            }
+        }
+        check(accepted == 0, label + ": " + std::to_string(accepted) + " truncated payloads accepted");
+
+        // Negative counts fail (offsets of the counts from the decoded sections).
+        size_t header = (sized) ? (8) : (4);
+        std::vector<std::pair<std::string, size_t>> counts = {
+            { "marker set count", 4 },
+            { "rigid body count", static_cast<size_t>(frame.rigid_bodies - payload.data()) - header },
+            { "skeleton count", static_cast<size_t>(frame.skeletons - payload.data()) - header },
+            { "bone count", static_cast<size_t>(frame.skeletons - payload.data()) + 4 },
+            { "labeled marker count", static_cast<size_t>(frame.labeled_markers - payload.data()) - header },
+        };
+        if (sized) {
+            counts.emplace_back("marker set size", 8);
+        }
+        else {
+            counts.emplace_back("marker count", 4 + 4 + 4);
+        }
+        for (auto& c : counts) {
+            for (int32_t value : { -1, (std::numeric_limits<int32_t>::min)() }) {
+                std::vector<char> negative = payload;
+                set_int(negative, c.second, value);
+                tracking::NatNetPacketDecoder::Frame f;
+                bool decoded = decoder.DecodeFrame(negative.data(), negative.size(), f);
+                check(!decoded && (f.rigid_body_count == 0) && (f.skeleton_count == 0) && (f.labeled_marker_count == 0),
+                    label + ": negative " + c.first + " (" + std::to_string(value) + ") accepted");
+            }
+        }
+
+        // Section sizes not matching the records fail (offsets of the sizes from the decoded sections).
+        if (sized) {
+            std::vector<std::pair<std::string, const char*>> sections = {
+                { "rigid body", frame.rigid_bodies },
+                { "skeleton", frame.skeletons },
+                { "labeled marker", frame.labeled_markers },
+            };
+            for (auto& c : sections) {
+                size_t offset = static_cast<size_t>(c.second - payload.data()) - 4;
+                int32_t bytes = 0;
+                std::memcpy(&bytes, payload.data() + offset, sizeof(int32_t));
+                for (int32_t value : { bytes - 1, bytes + 1 }) {
+                    std::vector<char> mismatch = payload;
+                    set_int(mismatch, offset, value);
+                    tracking::NatNetPacketDecoder::Frame f;
+                    bool decoded = decoder.DecodeFrame(mismatch.data(), mismatch.size(), f);
+                    check(!decoded && (f.rigid_body_count == 0) && (f.skeleton_count == 0) && (f.labeled_marker_count == 0),
+                        label + ": " + c.first + " section size " + std::to_string(value) + " instead of " + std::to_string(bytes) + " accepted");
+                }
+            }
+        }
+    }
+
+    void test_model_def(int major, int minor) {
+        std::string label = "NatNet " + std::to_string(major) + "." + std::to_string(minor) + " model definition";
+        bool sized = HasSectionSizes(major, minor);
+        tracking::NatNetPacketDecoder decoder;
+        decoder.SetVersion(major, minor);
+
+        std::vector<char> payload = BuildModelDef(major, minor, rigid_body_descriptions(), skeleton_descriptions());
+        std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription> rbs;
+        std::vector<tracking::NatNetPacketDecoder::SkeletonDescription> skeletons;
+        check(decoder.DecodeModelDef(payload.data(), payload.size(), rbs, skeletons), label + ": decode");
+        check((rbs.size() == 2) && (rbs[0].name == "Wand") && (rbs[0].id == 1) && (rbs[0].parent_id == -1) && near(rbs[0].offset.y, 0.5f) &&
+            (rbs[1].name == "Head") && (rbs[1].id == 7), label + ": rigid bodies");
+        check((skeletons.size() == 1) && (skeletons[0].name == "Bob") && (skeletons[0].id == 5) && (skeletons[0].bones.size() == 2) &&
+            (skeletons[0].bones[1].name == "Chest") && (skeletons[0].bones[1].parent_id == 1) && near(skeletons[0].bones[1].offset.x, 0.5f),
+            label + ": skeletons");
+
+        size_t accepted = 0;
+        for (size_t size = 0; size < payload.size(); ++size) {
+            std::vector<char> truncated(payload.begin(), payload.begin() + size);
+            if (decoder.DecodeModelDef(truncated.data(), truncated.size(), rbs, skeletons)) {
+                accepted++;
+            }
+        }
+        check(accepted == 0, label + ": " + std::to_string(accepted) + " truncated payloads accepted");
+
+        size_t bob = find_string(payload, "Bob");
+        std::vector<std::pair<std::string, size_t>> counts = {
+            { "description count", 0 },
+            { "marker set marker count", 4 + 4 + ((sized) ? (4) : (0)) + 4 },
+            { "bone count", bob + 4 + 4 },
+            { "rigid body marker count", find_string(payload, "Wand") + 5 + 4 + 4 + 3 * 4 },
+        };
+        if (sized) {
+            counts.emplace_back("description size", 8);
+        }
+        for (auto& c : counts) {
+            std::vector<char> negative = payload;
+            set_int(negative, c.second, -1);
+            check(!decoder.DecodeModelDef(negative.data(), negative.size(), rbs, skeletons), label + ": negative " + c.first + " accepted");
+        }
+    }
+
+    /** State of the replay shared with the frame callback. */
+    struct Replay {
+        tracking::NatNetPacketDecoder decoder;
+        std::atomic<int> frames;
+        std::atomic<int> malformed;
+        std::atomic<int> out_of_order;
+        int32_t latest;                                  // Receive thread only
+    };
+
+    void __cdecl on_frame(const char* payload, size_t size, double receive_time, void* user_data) {
+        Replay* replay = static_cast<Replay*>(user_data);
+        tracking::NatNetPacketDecoder::Frame frame;
+        if (!replay->decoder.DecodeFrame(payload, size, frame) || (receive_time <= 0.0)) {
+            replay->malformed++;
+            return;
+        }
+        if (frame.frame <= replay->latest) {
+            replay->out_of_order++;
+        }
+        replay->latest = frame.frame;
+        if (!check_frame(frame, frame.frame, "replayed frame")) {
+            replay->malformed++;
+        }
+        replay->frames++;
+    }
+
+    void test_replay(int major, int minor) {
+        const int FRAME_COUNT = 50;
+        std::string label = "NatNet " + std::to_string(major) + "." + std::to_string(minor) + " replay";
+
+        NatNetTestServer server(major, minor);
+        check(server.Start(0), label + ": server");
+        server.SetModelDef(BuildModelDef(major, minor, rigid_body_descriptions(), skeleton_descriptions()));
+
+        tracking::NatNetNativeClient client;
+        tracking::NatNetNativeClient::Params params;
+        params.local_address       = "127.0.0.1";
+        params.server_address      = "127.0.0.1";
+        params.command_port        = server.GetPort();
+        params.data_port           = 0;
+        params.multicast           = false;
+        params.multicast_address   = "";
+        params.receive_buffer_size = 0;
+        params.timeout             = 1.0;
+
+        sSender_Server info;
+        if (!client.Connect(params, info)) {
+            check(false, label + ": connect");
+            return;
+        }
+        check((info.Common.NatNetVersion[0] == major) && (info.Common.NatNetVersion[1] == minor), label + ": server version");
+
+        Replay replay;
+        replay.frames = 0;
+        replay.malformed = 0;
+        replay.out_of_order = 0;
+        replay.latest = 0;
+        replay.decoder.SetVersion(info.Common.NatNetVersion[0], info.Common.NatNetVersion[1]);
+
+        std::vector<char> model_def;
+        std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription> rbs;
+        std::vector<tracking::NatNetPacketDecoder::SkeletonDescription> skeletons;
+        check(client.RequestModelDef(model_def) && replay.decoder.DecodeModelDef(model_def.data(), model_def.size(), rbs, skeletons) &&
+            (rbs.size() == 2) && (skeletons.size() == 1), label + ": model definition");
+
+        check(client.Start(&on_frame, &replay), label + ": start");
+        server.SetStreaming(true, [major, minor, FRAME_COUNT](int32_t frame) {
+            return BuildFrame(major, minor, make_frame((frame <= FRAME_COUNT) ? (frame) : (FRAME_COUNT)));
+        }, 0.002);
+
+        double timeout = tracking::GetLocalTime() + 5.0;
+        while ((replay.frames.load() < FRAME_COUNT) && (tracking::GetLocalTime() < timeout)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        server.SetStreaming(false);
+        client.Disconnect();
+        server.Stop();
+
+        // Frames after FRAME_COUNT repeat the last frame number and count as out of order.
+        check(replay.frames.load() >= FRAME_COUNT, label + ": " + std::to_string(replay.frames.load()) + " of " + std::to_string(FRAME_COUNT) + " frames received");
+        check(replay.malformed.load() == 0, label + ": " + std::to_string(replay.malformed.load()) + " malformed frames");
+        check(replay.out_of_order.load() == replay.frames.load() - FRAME_COUNT, label + ": frames out of order");
+    }
+}
+
+
+int main(void) {
+
+    const int versions[][2] = { { 3, 1 }, { 4, 0 }, { 4, 1 } };
+
+    for (auto& v : versions) {
+        test_frames(v[0], v[1]);
+        test_model_def(v[0], v[1]);
+    }
+    for (auto& v : versions) {
+        test_replay(v[0], v[1]);
+    }
+
+    std::cout << "[NatNetPacketDecoderTest] " << check.GetFailures() << " failures: " << ((check.Passed()) ? ("PASSED") : ("FAILED")) << std::endl;
+
+    return (check.Passed()) ? (0) : (1);
+}
@@ -0,0 +1,333 @@
+/**
+ * NatNetTestData.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_TEST_NATNETTESTDATA_H_INCLUDED
+#define TRACKING_TEST_NATNETTESTDATA_H_INCLUDED
+
+#include "stdafx.h"
+#include "NatNetTypes.h"
+
+namespace tracking {
+namespace test {
+
+    /***************************************************************************
+    *
+    * Builds NAT_FRAMEOFDATA and NAT_MODELDEF payloads byte by byte in the
+    * layout Motive sends for a given NatNet version (3.x, 4.0 and 4.1+,
+    * the latter with section sizes). Sections the pool does not use
+    * (marker sets, unlabeled markers, assets, force plates, devices,
+    * device descriptions) are filled too, so decoders have to skip them.
+    *
+    ***************************************************************************/
+
+    /** One rigid body (or bone) of a frame or description. */
+    struct TestRigidBody {
+        int32_t                          id;
+        glm::vec3                        position;
+        glm::quat                        orientation;
+        float                            mean_error;
+        int16_t                          params;
+        std::string                      name;       /** Description only. */
+        int32_t                          parent_id;  /** Description only. */
+    };
+
+    /** One skeleton of a frame or description. */
+    struct TestSkeleton {
+        int32_t                          id;
+        std::string                      name;       /** Description only. */
+        std::vector<TestRigidBody>       bones;      /** Frame: IDs are bone IDs, the skeleton ID is added by the builder. */
+    };
+
+    /** One labeled marker of a frame. */
+    struct TestMarker {
+        int32_t                          id;
+        glm::vec3                        position;
+        float                            size;
+        int16_t                          params;
+        float                            residual;
+    };
+
+    /** Content of one frame. */
+    struct TestFrame {
+        int32_t                          frame;
+        std::vector<TestRigidBody>       rigid_bodies;
+        std::vector<TestSkeleton>        skeletons;
+        std::vector<TestMarker>          labeled_markers;
+        double                           timestamp;
+        uint64_t                         mid_exposure_timestamp;
+        uint64_t                         data_received_timestamp;
+        uint64_t                         transmit_timestamp;
+        int16_t                          params;
+    };
+
+    /** Little endian payload writer. */
+    class PayloadWriter {
+    public:
+        PayloadWriter(void) : m_data() { }
+
+        template <class T> inline void Write(T value) {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            this->m_data.insert(this->m_data.end(), bytes, bytes + sizeof(T));
+        }
+        inline void WriteString(const std::string& str) {
+            this->m_data.insert(this->m_data.end(), str.c_str(), str.c_str() + str.length() + 1);
+        }
+        /** Reserve the size of a section (NatNet 4.1+), returns the position for EndSection(). */
+        inline size_t BeginSection(bool sized) {
+            size_t pos = this->m_data.size();
+            if (sized) {
+                this->Write<int32_t>(0);
+            }
+            return pos;
+        }
+        inline void EndSection(bool sized, size_t pos) {
+            if (sized) {
+                int32_t bytes = static_cast<int32_t>(this->m_data.size() - pos - sizeof(int32_t));
+                std::memcpy(this->m_data.data() + pos, &bytes, sizeof(int32_t));
+            }
+        }
+        inline std::vector<char>& Data(void) {
+            return this->m_data;
+        }
+
+    private:
+        std::vector<char> m_data;
+    };
+
+    /** NatNet 4.1 and later prefix data sections and descriptions with their size. */
+    inline bool HasSectionSizes(int major, int minor) {
+        return ((major > 4) || ((major == 4) && (minor >= 1)));
+    }
+
+    inline void WriteRigidBodyRecord(PayloadWriter& w, int32_t id, const TestRigidBody& rb) {
+        w.Write<int32_t>(id);
+        w.Write<float>(rb.position.x);
+        w.Write<float>(rb.position.y);
+        w.Write<float>(rb.position.z);
+        w.Write<float>(rb.orientation.x);
+        w.Write<float>(rb.orientation.y);
+        w.Write<float>(rb.orientation.z);
+        w.Write<float>(rb.orientation.w);
+        w.Write<float>(rb.mean_error);
+        w.Write<int16_t>(rb.params);
+    }
+
+    /**
+    * Build a NAT_FRAMEOFDATA payload.
+    *
+    * @param major The NatNet major version.
+    * @param minor The NatNet minor version.
+    * @param f     The frame content.
+    *
+    * @return The payload.
+    */
+    inline std::vector<char> BuildFrame(int major, int minor, const TestFrame& f) {
+        bool sized = HasSectionSizes(major, minor);
+        PayloadWriter w;
+        size_t pos = 0;
+
+        w.Write<int32_t>(f.frame);
+
+        // Marker sets (one set with two markers)
+        w.Write<int32_t>(1);
+        pos = w.BeginSection(sized);
+        w.WriteString("all");
+        w.Write<int32_t>(2);
+        for (int i = 0; i < 6; ++i) {
+            w.Write<float>(static_cast<float>(i));
+        }
+        w.EndSection(sized, pos);
+
+        // Unlabeled markers (one marker)
+        w.Write<int32_t>(1);
+        pos = w.BeginSection(sized);
+        for (int i = 0; i < 3; ++i) {
+            w.Write<float>(0.5f);
+        }
+        w.EndSection(sized, pos);
+
+        // Rigid bodies
+        w.Write<int32_t>(static_cast<int32_t>(f.rigid_bodies.size()));
+        pos = w.BeginSection(sized);
+        for (auto& rb : f.rigid_bodies) {
+            WriteRigidBodyRecord(w, rb.id, rb);
+        }
+        w.EndSection(sized, pos);
+
+        // Skeletons
+        w.Write<int32_t>(static_cast<int32_t>(f.skeletons.size()));
+        pos = w.BeginSection(sized);
+        for (auto& s : f.skeletons) {
+            w.Write<int32_t>(s.id);
+            w.Write<int32_t>(static_cast<int32_t>(s.bones.size()));
+            for (auto& b : s.bones) {
+                WriteRigidBodyRecord(w, (s.id << 16) | (b.id & 0xffff), b);
+            }
+        }
+        w.EndSection(sized, pos);
+
+        // Assets (NatNet 4.1+, one opaque asset)
+        if (sized) {
+            w.Write<int32_t>(1);
+            pos = w.BeginSection(sized);
+            w.Write<int32_t>(42);
+            w.Write<int32_t>(0);
+            w.Write<int32_t>(0);
+            w.EndSection(sized, pos);
+        }
+
+        // Labeled markers
+        w.Write<int32_t>(static_cast<int32_t>(f.labeled_markers.size()));
+        pos = w.BeginSection(sized);
+        for (auto& m : f.labeled_markers) {
+            w.Write<int32_t>(m.id);
+            w.Write<float>(m.position.x);
+            w.Write<float>(m.position.y);
+            w.Write<float>(m.position.z);
+            w.Write<float>(m.size);
+            w.Write<int16_t>(m.params);
+            w.Write<float>(m.residual);
+        }
+        w.EndSection(sized, pos);
+
+        // Force plates and devices (one of each with two channels of one sample)
+        for (int section = 0; section < 2; ++section) {
+            w.Write<int32_t>(1);
+            pos = w.BeginSection(sized);
+            w.Write<int32_t>(section + 1);
+            w.Write<int32_t>(2);
+            for (int c = 0; c < 2; ++c) {
+                w.Write<int32_t>(1);
+                w.Write<float>(1.0f);
+            }
+            w.EndSection(sized, pos);
+        }
+
+        // Frame suffix
+        w.Write<uint32_t>(0);
+        w.Write<uint32_t>(0);
+        w.Write<double>(f.timestamp);
+        w.Write<uint64_t>(f.mid_exposure_timestamp);
+        w.Write<uint64_t>(f.data_received_timestamp);
+        w.Write<uint64_t>(f.transmit_timestamp);
+        if (sized) {
+            w.Write<uint32_t>(0);
+            w.Write<uint32_t>(0);
+        }
+        w.Write<int16_t>(f.params);
+
+        return w.Data();
+    }
+
+    inline void WriteRigidBodyDescription(PayloadWriter& w, int major, const TestRigidBody& rb) {
+        w.WriteString(rb.name);
+        w.Write<int32_t>(rb.id);
+        w.Write<int32_t>(rb.parent_id);
+        w.Write<float>(rb.position.x);
+        w.Write<float>(rb.position.y);
+        w.Write<float>(rb.position.z);
+        // Two markers: positions, required labels and (NatNet 4.0+) names
+        w.Write<int32_t>(2);
+        for (int i = 0; i < 6; ++i) {
+            w.Write<float>(0.01f * static_cast<float>(i));
+        }
+        w.Write<int32_t>(1);
+        w.Write<int32_t>(2);
+        if (major >= 4) {
+            w.WriteString(rb.name + "_1");
+            w.WriteString(rb.name + "_2");
+        }
+    }
+
+    /**
+    * Build a NAT_MODELDEF payload: one marker set, the rigid bodies, the
+    * skeletons and (NatNet 4.1+ only, since older layouts can not be
+    * skipped) one device description.
+    *
+    * @param major        The NatNet major version.
+    * @param minor        The NatNet minor version.
+    * @param rigid_bodies The rigid body descriptions (position is the offset).
+    * @param skeletons    The skeleton descriptions.
+    *
+    * @return The payload.
+    */
+    inline std::vector<char> BuildModelDef(int major, int minor, const std::vector<TestRigidBody>& rigid_bodies,
+        const std::vector<TestSkeleton>& skeletons) {
+        bool sized = HasSectionSizes(major, minor);
+        PayloadWriter w;
+        size_t pos = 0;
+
+        w.Write<int32_t>(static_cast<int32_t>(1 + rigid_bodies.size() + skeletons.size() + ((sized) ? (1) : (0))));
+
+        w.Write<int32_t>(Descriptor_MarkerSet);
+        pos = w.BeginSection(sized);
+        w.WriteString("all");
+        w.Write<int32_t>(2);
+        w.WriteString("m1");
+        w.WriteString("m2");
+        w.EndSection(sized, pos);
+
+        for (auto& rb : rigid_bodies) {
+            w.Write<int32_t>(Descriptor_RigidBody);
+            pos = w.BeginSection(sized);
+            WriteRigidBodyDescription(w, major, rb);
+            w.EndSection(sized, pos);
+        }
+
+        for (auto& s : skeletons) {
+            w.Write<int32_t>(Descriptor_Skeleton);
+            pos = w.BeginSection(sized);
+            w.WriteString(s.name);
+            w.Write<int32_t>(s.id);
+            w.Write<int32_t>(static_cast<int32_t>(s.bones.size()));
+            for (auto& b : s.bones) {
+                WriteRigidBodyDescription(w, major, b);
+            }
+            w.EndSection(sized, pos);
+        }
+
+        if (sized) {
+            w.Write<int32_t>(Descriptor_Device);
+            pos = w.BeginSection(sized);
+            w.Write<int32_t>(1);
+            w.WriteString("device");
+            w.WriteString("serial");
+            w.Write<int32_t>(0);
+            w.Write<int32_t>(0);
+            w.Write<int32_t>(1);
+            w.WriteString("channel");
+            w.EndSection(sized, pos);
+        }
+
+        return w.Data();
+    }
+
+    /**
+    * Build a rigid body for frames and descriptions.
+    *
+    * @param id   The streaming ID.
+    * @param name The name.
+    * @param t    Value the pose is derived from.
+    *
+    * @return The rigid body.
+    */
+    inline TestRigidBody MakeRigidBody(int32_t id, const std::string& name, float t) {
+        TestRigidBody rb;
+        rb.id          = id;
+        rb.position    = glm::vec3(t, 2.0f * t, -t);
+        rb.orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        rb.mean_error  = 0.001f * static_cast<float>(id);
+        rb.params      = 1;
+        rb.name        = name;
+        rb.parent_id   = -1;
+        return rb;
+    }
+
+} /** end namespace test */
+} /** end namespace tracking */
+
+#endif /** TRACKING_TEST_NATNETTESTDATA_H_INCLUDED */
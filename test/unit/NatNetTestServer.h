@@ -0,0 +1,318 @@
+/**
+ * NatNetTestServer.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_TEST_NATNETTESTSERVER_H_INCLUDED
+#define TRACKING_TEST_NATNETTESTSERVER_H_INCLUDED
+
+#include "stdafx.h"
+#include "NatNetTypes.h"
+
+#include <functional>
+#include <poll.h>
+
+namespace tracking {
+namespace test {
+
+    /***************************************************************************
+    *
+    * Stand-in for Motive on the loopback interface.
+    *
+    * Answers connect, model definition, command and clock synchronisation
+    * requests on the command port and, while streaming, sends the frames
+    * of the frame source to the data socket of the client (registered by
+    * its keep alive message) or, in multicast mode (see SetMulticast()),
+    * to a multicast group on the loopback interface.
+    *
+    ***************************************************************************/
+    class NatNetTestServer {
+
+    public:
+
+        /** Source of frame payloads (called with increasing frame numbers). */
+        typedef std::function<std::vector<char>(int32_t frame)> FrameSource;
+
+        /**
+        * CTOR
+        *
+        * @param major The NatNet version of the server.
+        * @param minor The NatNet version of the server.
+        */
+        NatNetTestServer(int major, int minor)
+            : m_major(major)
+            , m_minor(minor)
+            , m_socket(-1)
+            , m_port(0)
+            , m_thread()
+            , m_running(false)
+            , m_streaming(false)
+            , m_interval(0.01)
+            , m_mutex()
+            , m_model_def()
+            , m_frame_source()
+            , m_client()
+            , m_has_client(false)
+            , m_frames_sent(0)
+            , m_multicast(false)
+            , m_group()
+            , m_data_port(0) {
+
+            // intentionally empty...
+        }
+
+        /**
+        * DTOR
+        */
+        ~NatNetTestServer(void) {
+            this->Stop();
+        }
+
+        NatNetTestServer(const NatNetTestServer&) = delete;
+        NatNetTestServer& operator=(const NatNetTestServer&) = delete;
+
+        /**
+        * Bind the command port on 127.0.0.1 and start answering requests.
+        *
+        * @param port The command port (0 for an ephemeral port, see GetPort()).
+        *
+        * @return True for success, false otherwise.
+        */
+        bool Start(uint16_t port) {
+            this->m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+            sockaddr_in local;
+            std::memset(&local, 0, sizeof(local));
+            local.sin_family = AF_INET;
+            local.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &local.sin_addr);
+            socklen_t length = sizeof(local);
+            if ((this->m_socket < 0) || (bind(this->m_socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) ||
+                (getsockname(this->m_socket, reinterpret_cast<sockaddr*>(&local), &length) != 0)) {
+                std::cerr << "[ERROR] [NatNetTestServer] Failed to bind port " << port << "." << std::endl;
+                return false;
+            }
+            this->m_port = ntohs(local.sin_port);
+            if (this->m_multicast && !this->open_multicast()) {
+                std::cerr << "[ERROR] [NatNetTestServer] Failed to prepare multicast to " << inet_ntoa(this->m_group.sin_addr) << "." << std::endl;
+                return false;
+            }
+            this->m_running = true;
+            this->m_thread = std::thread(&NatNetTestServer::run, this);
+            return true;
+        }
+
+        /** Stop the server and close the command port. */
+        void Stop(void) {
+            this->m_running = false;
+            if (this->m_thread.joinable()) {
+                this->m_thread.join();
+            }
+            if (this->m_socket >= 0) {
+                close(this->m_socket);
+                this->m_socket = -1;
+            }
+        }
+
+        /**
+        * Stream frames to a multicast group on the loopback interface
+        * instead of the registered client (before Start() only).
+        *
+        * @param group     The multicast group announced to clients.
+        * @param data_port The data port announced to clients (0 for a free port, see GetDataPort()).
+        */
+        void SetMulticast(const std::string& group, uint16_t data_port) {
+            std::memset(&this->m_group, 0, sizeof(this->m_group));
+            this->m_group.sin_family = AF_INET;
+            inet_pton(AF_INET, group.c_str(), &this->m_group.sin_addr);
+            this->m_data_port = data_port;
+            this->m_multicast = true;
+        }
+
+        /** Set the payload returned for model definition requests. */
+        void SetModelDef(const std::vector<char>& payload) {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_model_def = payload;
+        }
+
+        /**
+        * Start or stop streaming frames (the server keeps answering requests).
+        *
+        * @param streaming Send frames while the client is registered.
+        * @param source    The frame source (keeps the previous source if empty).
+        * @param interval  The time between two frames in seconds.
+        */
+        void SetStreaming(bool streaming, FrameSource source = FrameSource(), double interval = 0.01) {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            if (source) {
+                this->m_frame_source = source;
+            }
+            this->m_interval = interval;
+            this->m_streaming = streaming;
+        }
+
+        /** Get the command port. */
+        inline uint16_t GetPort(void) const {
+            return this->m_port;
+        }
+
+        /** Get the data port (multicast only). */
+        inline uint16_t GetDataPort(void) const {
+            return this->m_data_port;
+        }
+
+        /** Check whether a client registered its data socket. */
+        inline bool HasClient(void) const {
+            return this->m_has_client.load();
+        }
+
+        /** Get the number of frames sent. */
+        inline int GetFramesSent(void) const {
+            return this->m_frames_sent.load();
+        }
+
+    private:
+
+        int m_major;
+        int m_minor;
+        int m_socket;
+        uint16_t m_port;
+        std::thread m_thread;
+        std::atomic<bool> m_running;
+        bool m_streaming;                                // Guarded by m_mutex
+        double m_interval;                               // Guarded by m_mutex
+        std::mutex m_mutex;
+        std::vector<char> m_model_def;                   // Guarded by m_mutex
+        FrameSource m_frame_source;                      // Guarded by m_mutex
+        sockaddr_in m_client;                            // Data socket of the client (server thread only)
+        std::atomic<bool> m_has_client;
+        std::atomic<int> m_frames_sent;
+        bool m_multicast;
+        sockaddr_in m_group;                             // Multicast group and data port (multicast only)
+        uint16_t m_data_port;
+
+        bool open_multicast(void) {
+            // Pick a free data port by binding an ephemeral port once.
+            if (this->m_data_port == 0) {
+                int probe = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+                sockaddr_in local;
+                std::memset(&local, 0, sizeof(local));
+                local.sin_family = AF_INET;
+                socklen_t length = sizeof(local);
+                bool bound = ((probe >= 0) && (bind(probe, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) == 0) &&
+                    (getsockname(probe, reinterpret_cast<sockaddr*>(&local), &length) == 0));
+                if (probe >= 0) {
+                    close(probe);
+                }
+                if (!bound) {
+                    return false;
+                }
+                this->m_data_port = ntohs(local.sin_port);
+            }
+            this->m_group.sin_port = htons(this->m_data_port);
+
+            // Send on the loopback interface and deliver to the clients of this host.
+            in_addr loopback;
+            inet_pton(AF_INET, "127.0.0.1", &loopback);
+            unsigned char loop = 1;
+            return ((setsockopt(this->m_socket, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback)) == 0) &&
+                (setsockopt(this->m_socket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0));
+        }
+
+        static uint64_t ticks(void) {
+            return static_cast<uint64_t>(tracking::GetLocalTime() * 1000000.0);
+        }
+
+        void send(uint16_t message, const void* payload, size_t size, const sockaddr_in& to) {
+            std::vector<char> packet(4 + size);
+            uint16_t bytes = static_cast<uint16_t>(size);
+            std::memcpy(packet.data(), &message, sizeof(uint16_t));
+            std::memcpy(packet.data() + 2, &bytes, sizeof(uint16_t));
+            if (size > 0) {
+                std::memcpy(packet.data() + 4, payload, size);
+            }
+            sendto(this->m_socket, packet.data(), packet.size(), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+        }
+
+        void run(void) {
+            std::vector<char> buffer(65536);
+            int32_t frame = 0;
+            double next_frame = tracking::GetLocalTime();
+
+            while (this->m_running) {
+                pollfd pfd = { this->m_socket, POLLIN, 0 };
+                if (poll(&pfd, 1, 1) > 0) {
+                    sockaddr_in from;
+                    socklen_t length = sizeof(from);
+                    ssize_t bytes = recvfrom(this->m_socket, buffer.data(), buffer.size(), 0, reinterpret_cast<sockaddr*>(&from), &length);
+                    if (bytes >= 4) {
+                        uint16_t message = 0;
+                        std::memcpy(&message, buffer.data(), sizeof(uint16_t));
+                        this->on_request(message, buffer.data() + 4, static_cast<size_t>(bytes) - 4, from);
+                    }
+                }
+
+                std::vector<char> payload;
+                {
+                    std::lock_guard<std::mutex> lock(this->m_mutex);
+                    double now = tracking::GetLocalTime();
+                    if (!this->m_streaming || !this->m_frame_source || (!this->m_has_client && !this->m_multicast) || (now < next_frame)) {
+                        continue;
+                    }
+                    next_frame = (std::max)(next_frame + this->m_interval, now - this->m_interval);
+                    payload = this->m_frame_source(++frame);
+                }
+                this->send(NAT_FRAMEOFDATA, payload.data(), payload.size(), (this->m_multicast) ? (this->m_group) : (this->m_client));
+                this->m_frames_sent++;
+            }
+        }
+
+        void on_request(uint16_t message, const char* payload, size_t size, const sockaddr_in& from) {
+            switch (message) {
+            case (NAT_CONNECT): {
+                sSender_Server server;
+                std::memset(&server, 0, sizeof(server));
+                std::strncpy(server.Common.szName, "Motive", MAX_NAMELENGTH - 1);
+                server.Common.Version[0] = 3;
+                server.Common.NatNetVersion[0] = static_cast<uint8_t>(this->m_major);
+                server.Common.NatNetVersion[1] = static_cast<uint8_t>(this->m_minor);
+                server.HighResClockFrequency = 1000000;
+                server.DataPort = (this->m_multicast) ? (this->m_data_port) : (0);
+                server.IsMulticast = this->m_multicast;
+                if (this->m_multicast) {
+                    std::memcpy(server.MulticastGroupAddress, &this->m_group.sin_addr, sizeof(server.MulticastGroupAddress));
+                }
+                this->send(NAT_SERVERINFO, &server, sizeof(server), from);
+            } break;
+            case (NAT_REQUEST_MODELDEF): {
+                std::vector<char> model_def;
+                {
+                    std::lock_guard<std::mutex> lock(this->m_mutex);
+                    model_def = this->m_model_def;
+                }
+                this->send(NAT_MODELDEF, model_def.data(), model_def.size(), from);
+            } break;
+            case (NAT_REQUEST): {
+                int32_t result = 0;
+                this->send(NAT_RESPONSE, &result, sizeof(result), from);
+            } break;
+            case (NAT_KEEPALIVE): {
+                this->m_client = from;
+                this->m_has_client = true;
+            } break;
+            case (NAT_ECHOREQUEST): {
+                uint64_t response[2] = { 0, ticks() };
+                std::memcpy(&response[0], payload, (std::min)(size, sizeof(uint64_t)));
+                this->send(NAT_ECHORESPONSE, response, sizeof(response), from);
+            } break;
+            default:
+                break;
+            }
+        }
+    };
+
+} /** end namespace test */
+} /** end namespace tracking */
+
+#endif /** TRACKING_TEST_NATNETTESTSERVER_H_INCLUDED */
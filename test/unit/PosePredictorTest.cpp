@@ -0,0 +1,114 @@
+/**
+ * PosePredictorTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "PosePredictor.h"
+#include "UnitTest.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Replays synthetic traces (240 Hz, exact poses) with constant velocity and
+* constant acceleration through PosePredictor::EvaluateTrace(), both with a
+* constant rotation. The model matching the trace has to predict the poses
+* without error (up to float precision), while the error of a model not
+* matching the trace (or no prediction) has to grow with the horizon.
+*
+* Usage: ./PosePredictorTest
+*
+******************************************************************************/
+
+namespace {
+
+    /** Sample rate of the traces in Hz. */
+    const double RATE = 240.0;
+
+    /** Duration of the traces in seconds. */
+    const double DURATION = 2.0;
+
+    /** Time in seconds until the filter converged (excluded from the error). */
+    const double WARMUP = 0.25;
+
+    /** Tolerated position error in m of a matching model. */
+    const float POSITION_TOLERANCE = 0.0001f;
+
+    /** Tolerated orientation error in radians (the angle between two float quaternions is only exact to about 1e-3). */
+    const float ANGLE_TOLERANCE = 0.001f;
+
+    tracking::test::Checker check("PosePredictorTest");
+
+    /** Trace with constant velocity, plus constant acceleration if requested, rotating about z at 1 rad/s. */
+    std::vector<tracking::PosePredictor::Sample> make_trace(bool accelerated) {
+        const glm::vec3 origin(1.0f, 1.5f, -0.5f);
+        const glm::vec3 velocity(0.5f, -0.2f, 0.1f);
+        const glm::vec3 acceleration = (accelerated) ? (glm::vec3(2.0f, 0.0f, -1.0f)) : (glm::vec3(0.0f));
+
+        std::vector<tracking::PosePredictor::Sample> trace;
+        for (int i = 0; i < static_cast<int>(DURATION * RATE); ++i) {
+            double t = static_cast<double>(i) / RATE;
+            tracking::PosePredictor::Sample s;
+            s.time        = 100.0 + t;
+            s.position    = origin + velocity * static_cast<float>(t) + acceleration * static_cast<float>(t * t / 2.0);
+            s.orientation = glm::angleAxis(static_cast<float>(t), glm::vec3(0.0f, 0.0f, 1.0f));
+            trace.emplace_back(s);
+        }
+        return trace;
+    }
+
+    std::vector<tracking::PosePredictor::Error> evaluate(const std::vector<tracking::PosePredictor::Sample>& trace,
+        tracking::PosePredictor::Model model, const std::vector<float>& horizons) {
+        tracking::PosePredictor::Params params;
+        params.model             = model;
+        params.horizon           = 0.0f;              /// Set to the largest horizon.
+        params.process_noise     = 500.0f;
+        params.measurement_noise = 0.0000005f;
+        std::vector<tracking::PosePredictor::Error> errors;
+        check(tracking::PosePredictor::EvaluateTrace(trace, params, horizons, WARMUP, errors) && (errors.size() == horizons.size()), "Evaluating trace");
+        for (auto& e : errors) {
+            std::printf("[PosePredictorTest]   horizon %.3f s: position %.6f m, angle %.6f rad (%zu predictions)\n",
+                e.horizon, e.position_rms, e.angle_rms, e.count);
+            check(e.count > static_cast<size_t>((DURATION - WARMUP - e.horizon - 0.01) * RATE), "Number of predictions");
+        }
+        return errors;
+    }
+
+    void expect_exact(const std::vector<tracking::PosePredictor::Error>& errors, const std::string& label) {
+        for (auto& e : errors) {
+            check((e.position_rms < POSITION_TOLERANCE) && (e.angle_rms < ANGLE_TOLERANCE),
+                label + ": error at horizon " + std::to_string(e.horizon) + " s");
+        }
+    }
+
+    void expect_growing(const std::vector<tracking::PosePredictor::Error>& errors, const std::string& label) {
+        for (size_t i = 1; i < errors.size(); ++i) {
+            check(errors[i].position_rms > errors[i - 1].position_rms,
+                label + ": error growing from horizon " + std::to_string(errors[i - 1].horizon) + " s to " + std::to_string(errors[i].horizon) + " s");
+        }
+        check(errors.back().position_rms > 10.0f * POSITION_TOLERANCE, label + ": error at largest horizon");
+    }
+}
+
+
+int main(int argc, char** argv) {
+
+    const std::vector<float> horizons = { 0.01f, 0.02f, 0.05f, 0.1f };
+    auto cv_trace = make_trace(false);
+    auto ca_trace = make_trace(true);
+
+    std::cout << "[PosePredictorTest] Constant velocity trace, constant velocity model:" << std::endl;
+    expect_exact(evaluate(cv_trace, tracking::PosePredictor::Model::ConstantVelocity, horizons), "Constant velocity model on constant velocity trace");
+
+    std::cout << "[PosePredictorTest] Constant acceleration trace, constant acceleration model:" << std::endl;
+    expect_exact(evaluate(ca_trace, tracking::PosePredictor::Model::ConstantAcceleration, horizons), "Constant acceleration model on constant acceleration trace");
+
+    std::cout << "[PosePredictorTest] Constant acceleration trace, constant velocity model:" << std::endl;
+    expect_growing(evaluate(ca_trace, tracking::PosePredictor::Model::ConstantVelocity, horizons), "Constant velocity model on constant acceleration trace");
+
+    std::cout << "[PosePredictorTest] Constant velocity trace, no prediction:" << std::endl;
+    expect_growing(evaluate(cv_trace, tracking::PosePredictor::Model::None, horizons), "No prediction on constant velocity trace");
+
+    std::cout << "[PosePredictorTest] " << ((check.Passed()) ? ("PASSED") : ("FAILED")) << std::endl;
+    return (check.Passed()) ? (0) : (1);
+}
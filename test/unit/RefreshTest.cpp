@@ -0,0 +1,112 @@
+/**
+ * RefreshTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetDevicePool.h"
+#include "NatNetTestData.h"
+#include "NatNetTestServer.h"
+#include "UnitTest.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Refresh of the data descriptions after a failed request: a stand-in
+* server on the loopback interface flags changed models in one frame while
+* it answers model definition requests with an invalid payload. Once the
+* server answers with valid descriptions again, the pool has to pick up
+* the new rigid body without any further request.
+*
+* Usage: ./RefreshTest
+*
+******************************************************************************/
+
+namespace {
+
+    tracking::test::Checker check("RefreshTest");
+}
+
+
+int main(int argc, char** argv) {
+
+    // Server streaming rigid body "Wand" as ID 1, models changed is flagged in one frame on request.
+    std::atomic<bool> models_changed(false);
+    std::atomic<int32_t> flagged_frame(-1);
+    tracking::test::NatNetTestServer server(4, 1);
+    server.SetModelDef(tracking::test::BuildModelDef(4, 1, { tracking::test::MakeRigidBody(1, "Wand", 0.0f) }, {}));
+    server.SetStreaming(true, [&](int32_t frame) {
+        tracking::test::TestFrame f;
+        f.frame = frame;
+        f.rigid_bodies.emplace_back(tracking::test::MakeRigidBody(1, "", 1.0f));
+        f.timestamp               = 0.01 * frame;
+        f.mid_exposure_timestamp  = 0;
+        f.data_received_timestamp = 0;
+        f.transmit_timestamp      = 0;
+        f.params                  = 0;
+        if (models_changed.exchange(false)) {
+            f.params = 0x02;
+            flagged_frame = frame;
+        }
+        return tracking::test::BuildFrame(4, 1, f);
+    });
+    if (!server.Start(0)) {
+        return 1;
+    }
+
+    tracking::NatNetDevicePool::Params p;
+    p.client_ip                    = "127.0.0.1";
+    p.client_ip_len                = 9;
+    p.server_ip                    = "127.0.0.1";
+    p.server_ip_len                = 9;
+    p.cmd_port                     = server.GetPort();
+    p.data_port                    = 0;
+    p.con_type                     = tracking::NatNetDevicePool::ConnectionType::UniCast;
+    p.multicast_ip                 = "";
+    p.multicast_ip_len             = 0;
+    p.receive_buffer_size          = 0;
+    p.verbose_client               = false;
+    p.native_client                = true;
+    p.prediction.model             = tracking::PosePredictor::Model::None;
+    p.prediction.horizon           = 0.0f;
+    p.prediction.process_noise     = 500.0f;
+    p.prediction.measurement_noise = 0.0000005f;
+    p.subscription                 = false;
+    p.connect_timeout              = 0.2f;
+    p.cache_file                   = "";
+    p.cache_file_len               = 0;
+    p.servers                      = nullptr;
+    p.server_count                 = 0;
+    p.standby_servers              = nullptr;
+    p.standby_count                = 0;
+    p.failover_timeout             = 0.0f;
+
+    tracking::NatNetDevicePool pool;
+    if (!pool.Initialise(p) || !pool.Connect()) {
+        std::cerr << "[ERROR] [RefreshTest] Failed to connect to the server." << std::endl;
+        return 1;
+    }
+
+    int wand = pool.ResolveRigidBody("Wand");
+    tracking::NatNetDevicePool::RigidBodyData data;
+    check(tracking::test::WaitFor([&]() { return pool.GetRigidBodyData(wand, data) && (data.frame > 0); }, 2.0), "Receiving frames");
+
+    // The refresh requested by the flagged frame fails, the server adds "Cube" meanwhile.
+    server.SetModelDef(std::vector<char>(1, 0));
+    models_changed = true;
+    check(tracking::test::WaitFor([&]() { return pool.GetRigidBodyData(wand, data) && (flagged_frame.load() >= 0) && (data.frame > flagged_frame.load()); }, 2.0),
+        "Receiving the frame flagging changed models");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300)); /// Refresh thread wakes up every 100 ms.
+    check(pool.ResolveRigidBody("Cube") < 0, "No descriptions from the invalid payload");
+    server.SetModelDef(tracking::test::BuildModelDef(4, 1, { tracking::test::MakeRigidBody(1, "Wand", 0.0f), tracking::test::MakeRigidBody(2, "Cube", 0.0f) }, {}));
+
+    // The failed refresh is retried after the refresh interval.
+    check(tracking::test::WaitFor([&]() { return pool.ResolveRigidBody("Cube") >= 0; }, 3.0), "Retrying the failed refresh");
+    check(pool.ResolveRigidBody("Wand") == wand, "Handle of the known rigid body");
+
+    pool.Disconnect();
+    server.Stop();
+
+    std::cout << "[RefreshTest] " << ((check.Passed()) ? ("PASSED") : ("FAILED")) << std::endl;
+    return (check.Passed()) ? (0) : (1);
+}
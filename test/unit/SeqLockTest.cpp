@@ -0,0 +1,116 @@
+/**
+ * SeqLockTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "SeqLock.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Stress test of the sequence lock: one writer stores a self checking
+* payload (every field holds the same sequence value) at 1 kHz while
+* reader threads load it as fast as possible. Any torn read (fields of
+* different stores) or a value older than a previously read one fails.
+*
+* Usage: ./SeqLockTest [duration in seconds] [reader count]
+*
+******************************************************************************/
+
+namespace {
+
+    /** Payload spanning several words and cache lines. */
+    struct Payload {
+        uint64_t                     values[12];
+        double                       time;
+        int32_t                      frame;
+        bool                         flag;
+    };
+
+    void fill(Payload& p, uint64_t seq) {
+        for (auto& v : p.values) {
+            v = seq;
+        }
+        p.time  = static_cast<double>(seq);
+        p.frame = static_cast<int32_t>(seq);
+        p.flag  = ((seq & 1) != 0);
+    }
+
+    bool check(const Payload& p) {
+        uint64_t seq = p.values[0];
+        for (auto v : p.values) {
+            if (v != seq) {
+                return false;
+            }
+        }
+        return ((p.time == static_cast<double>(seq)) && (p.frame == static_cast<int32_t>(seq)) && (p.flag == ((seq & 1) != 0)));
+    }
+}
+
+
+int main(int argc, char** argv) {
+
+    double duration = (argc > 1) ? (std::atof(argv[1])) : (2.0);
+    int reader_count = (argc > 2) ? (std::atoi(argv[2])) : (4);
+    if ((duration <= 0.0) || (reader_count <= 0)) {
+        std::cerr << "Usage: " << argv[0] << " [duration in seconds] [reader count]" << std::endl;
+        return 1;
+    }
+
+    tracking::SeqLock<Payload> lock;
+    Payload initial;
+    fill(initial, 0);
+    lock.Store(initial);
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> failures(0);
+    std::atomic<uint64_t> loads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t latest = 0;
+            uint64_t count  = 0;
+            Payload p;
+            while (!stop.load(std::memory_order_relaxed)) {
+                lock.Load(p);
+                ++count;
+                if (!check(p) || (p.values[0] < latest)) {
+                    if (failures.fetch_add(1) < 10) {
+                        std::cerr << "[ERROR] [SeqLockTest] Torn or outdated read: " << p.values[0] << " after " << latest << ", frame " << p.frame << std::endl;
+                    }
+                    continue;
+                }
+                latest = p.values[0];
+            }
+            loads.fetch_add(count);
+        });
+    }
+
+    // Writer at 1 kHz.
+    uint64_t seq = 0;
+    auto begin = std::chrono::steady_clock::now();
+    auto next  = begin;
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() < duration) {
+        Payload p;
+        fill(p, ++seq);
+        lock.Store(p);
+        next += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next);
+    }
+
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    Payload last;
+    lock.Load(last);
+    bool ok = ((failures.load() == 0) && check(last) && (last.values[0] == seq) && (lock.GetSequence() == 2 * (seq + 1)));
+
+    std::cout << "[SeqLockTest] " << seq << " stores, " << loads.load() << " loads by " << reader_count << " readers, "
+        << failures.load() << " failures: " << ((ok) ? ("PASSED") : ("FAILED")) << std::endl;
+
+    return (ok) ? (0) : (1);
+}
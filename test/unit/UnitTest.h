@@ -0,0 +1,114 @@
+/**
+ * UnitTest.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_TEST_UNITTEST_H_INCLUDED
+#define TRACKING_TEST_UNITTEST_H_INCLUDED
+
+#include "stdafx.h"
+
+namespace tracking {
+namespace test {
+
+    /***************************************************************************
+    *
+    * Helpers shared by the unit tests: counting and reporting failed checks,
+    * waiting for conditions and finding free ports on the loopback
+    * interface.
+    *
+    ***************************************************************************/
+
+    /** Counts and reports failed checks of one test (checks may run in several threads). */
+    class Checker {
+
+    public:
+
+        /**
+        * CTOR
+        *
+        * @param test The name of the test printed with failed checks.
+        */
+        explicit Checker(const char* test) : m_test(test), m_failures(0) { }
+
+        /**
+        * Check a condition, failures are printed and counted.
+        *
+        * @param condition The checked condition.
+        * @param what      Description of the check.
+        *
+        * @return The condition.
+        */
+        bool operator()(bool condition, const std::string& what) {
+            if (!condition) {
+                std::cerr << "[ERROR] [" << this->m_test << "] Check failed: " << what << std::endl;
+                this->m_failures++;
+            }
+            return condition;
+        }
+
+        /** Get the number of failed checks. */
+        inline int GetFailures(void) const {
+            return this->m_failures.load();
+        }
+
+        /** Check whether no check failed. */
+        inline bool Passed(void) const {
+            return (this->m_failures.load() == 0);
+        }
+
+    private:
+
+        const char* m_test;
+        std::atomic<int> m_failures;
+    };
+
+    /**
+    * Wait until the condition holds or the timeout has passed.
+    *
+    * @param condition The condition (callable returning bool), polled every 10 ms.
+    * @param timeout   The timeout in seconds.
+    *
+    * @return True if the condition holds, false on timeout.
+    */
+    template <class Condition> bool WaitFor(Condition condition, double timeout) {
+        double end = tracking::GetLocalTime() + timeout;
+        while (!condition()) {
+            if (tracking::GetLocalTime() > end) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+    /**
+    * Get a free TCP port on the loopback interface (e.g. for VRPN servers,
+    * which listen on TCP and UDP).
+    *
+    * @return The port, 0 if none was found.
+    */
+    inline unsigned int FreePort(void) {
+        int probe = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in local;
+        std::memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &local.sin_addr);
+        socklen_t length = sizeof(local);
+        unsigned int port = 0;
+        if ((probe >= 0) && (bind(probe, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) == 0) &&
+            (getsockname(probe, reinterpret_cast<sockaddr*>(&local), &length) == 0)) {
+            port = ntohs(local.sin_port);
+        }
+        if (probe >= 0) {
+            close(probe);
+        }
+        return port;
+    }
+
+} /** end namespace test */
+} /** end namespace tracking */
+
+#endif /** TRACKING_TEST_UNITTEST_H_INCLUDED */
@@ -0,0 +1,231 @@
+/**
+ * VrpnReactorBenchmark.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "VrpnButtonDevice.h"
+#include "UnitTest.h"
+
+#include <sys/resource.h>
+
+/**** HOWTO: ******************************************************************
+*
+* Runs SERVER_COUNT VRPN server connections with one button each in
+* process on the loopback interface and one button device per server, so
+* the reactor waits on several connections. Prints the CPU load of the
+* reactor while no data arrives (load of the process minus the load of the
+* servers alone) and the latency from setting a button on the server to
+* the event of the device, alternating between the devices. Fails if the
+* idle load or the latency exceed generous bounds (the reactor must not
+* poll the connections).
+*
+* Usage: ./VrpnReactorBenchmark [button presses]
+*
+******************************************************************************/
+
+namespace {
+
+    /** Number of VRPN servers (and devices, one connection each). */
+    const int SERVER_COUNT = 3;
+
+    /** Duration of the idle measurement in seconds. */
+    const double IDLE_DURATION = 2.0;
+
+    /** Maximum CPU load of the reactor while idle (fraction of one core). */
+    const double MAX_IDLE_LOAD = 0.05;
+
+    /** Maximum latency of a button event in seconds. */
+    const double MAX_LATENCY = 0.02;
+
+    /** CPU load of the process (all threads) over IDLE_DURATION as fraction of one core. */
+    double idle_load(void) {
+        auto cpu_time = []() {
+            rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+                static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 0.000001;
+        };
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        double cpu = cpu_time();
+        double begin = tracking::GetLocalTime();
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(IDLE_DURATION * 1000.0)));
+        return (cpu_time() - cpu) / (tracking::GetLocalTime() - begin);
+    }
+
+    /** VRPN servers with one button each, run by one thread blocking in the main loops of the connections. */
+    class ButtonServers {
+    public:
+        ButtonServers(void) : m_running(false), m_thread(), m_mutex(), m_pending() { }
+        ~ButtonServers(void) { this->Stop(); }
+
+        bool Start(const std::vector<unsigned int>& ports) {
+            this->m_running = true;
+            std::promise<bool> started;
+            std::future<bool> result = started.get_future();
+            this->m_thread = std::thread([this, ports, &started]() {
+                std::vector<vrpn_Connection*> connections;
+                std::vector<std::unique_ptr<vrpn_Button_Server>> buttons;
+                for (auto port : ports) {
+                    vrpn_Connection* connection = vrpn_create_server_connection(static_cast<int>(port));
+                    if ((connection == nullptr) || !connection->doing_okay()) {
+                        break;
+                    }
+                    connections.emplace_back(connection);
+                    buttons.emplace_back(new vrpn_Button_Server("Button0", connection, 1));
+                }
+                started.set_value(connections.size() == ports.size());
+                while (this->m_running && (connections.size() == ports.size())) {
+                    std::vector<std::pair<int, int>> pending;
+                    {
+                        std::lock_guard<std::mutex> lock(this->m_mutex);
+                        pending.swap(this->m_pending);
+                    }
+                    for (auto& p : pending) {
+                        buttons[p.first]->set_button(0, p.second);
+                    }
+                    for (size_t i = 0; i < connections.size(); ++i) {
+                        struct timeval timeout;
+                        timeout.tv_sec  = 0;
+                        timeout.tv_usec = 1000 / static_cast<long>(connections.size());
+                        buttons[i]->mainloop();
+                        connections[i]->mainloop(&timeout);
+                    }
+                }
+                buttons.clear();
+                for (auto connection : connections) {
+                    connection->removeReference();
+                }
+            });
+            return result.get();
+        }
+
+        void Stop(void) {
+            this->m_running = false;
+            if (this->m_thread.joinable()) {
+                this->m_thread.join();
+            }
+        }
+
+        /** Set the button of a server (sent by the server thread). */
+        void SetButton(int server, bool pressed) {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_pending.emplace_back(server, (pressed) ? (1) : (0));
+        }
+
+    private:
+        std::atomic<bool> m_running;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::vector<std::pair<int, int>> m_pending;  // Guarded by m_mutex
+    };
+
+    /** Set the button of a server and wait for the event of its device, returns the latency in seconds (negative on timeout). */
+    double press(ButtonServers& servers, int server, bool pressed, tracking::VrpnButtonDevice& device) {
+        uint64_t count = device.GetEventCount();
+        double start = tracking::GetLocalTime();
+        servers.SetButton(server, pressed);
+        while (device.GetEventCount() == count) {
+            if (tracking::GetLocalTime() - start > 1.0) {
+                return -1.0;
+            }
+            std::this_thread::yield();
+        }
+        tracking::VrpnButtonDevice::Event event;
+        if (!device.GetLatestEvent(event) || (event.pressed != pressed)) {
+            return -1.0;
+        }
+        return event.receive_time - start;
+    }
+}
+
+
+int main(int argc, char** argv) {
+
+    int presses = (argc > 1) ? (std::atoi(argv[1])) : (100);
+    if (presses <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [button presses]" << std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned int> ports;
+    for (int i = 0; i < SERVER_COUNT; ++i) {
+        ports.emplace_back(tracking::test::FreePort());
+    }
+    ButtonServers servers;
+    if ((std::find(ports.begin(), ports.end(), 0u) != ports.end()) || !servers.Start(ports)) {
+        std::cerr << "[ERROR] [VrpnReactorBenchmark] Failed to start the VRPN servers." << std::endl;
+        return 1;
+    }
+    double server_load = idle_load();
+
+    tracking::VrpnReactor reactor;
+    std::vector<std::unique_ptr<tracking::VrpnButtonDevice>> devices;
+    std::vector<std::string> server_name(SERVER_COUNT, "127.0.0.1");
+    for (int i = 0; i < SERVER_COUNT; ++i) {
+        tracking::VrpnDevice<vrpn_Button_Remote>::Params params;
+        params.device_name     = "Button0";
+        params.device_name_len = 7;
+        params.server_name     = server_name[i].c_str();
+        params.server_name_len = server_name[i].length();
+        params.port            = ports[i];
+        params.protocol        = tracking::VrpnDevice<vrpn_Button_Remote>::Protocols::VRPN_TCP;
+        devices.emplace_back(new tracking::VrpnButtonDevice(reactor));
+        if (!devices.back()->Initialise(params) || !devices.back()->Connect()) {
+            std::cerr << "[ERROR] [VrpnReactorBenchmark] Failed to connect device " << i << "." << std::endl;
+            return 1;
+        }
+    }
+
+    // Links are up once every device received an event.
+    for (int i = 0; i < SERVER_COUNT; ++i) {
+        double end = tracking::GetLocalTime() + 5.0;
+        bool up = false;
+        while (!up && (tracking::GetLocalTime() < end)) {
+            up = (press(servers, i, true, *devices[i]) >= 0.0) && (press(servers, i, false, *devices[i]) >= 0.0);
+        }
+        if (!up) {
+            std::cerr << "[ERROR] [VrpnReactorBenchmark] No events of device " << i << "." << std::endl;
+            return 1;
+        }
+    }
+
+    bool ok = true;
+    double load = (std::max)(0.0, idle_load() - server_load);
+    std::printf("[VrpnReactorBenchmark] %d connections, idle CPU load of the reactor %.2f %% of one core (servers %.2f %%)\n",
+        SERVER_COUNT, load * 100.0, server_load * 100.0);
+    if (load > MAX_IDLE_LOAD) {
+        std::cerr << "[ERROR] [VrpnReactorBenchmark] Idle CPU load exceeds " << (MAX_IDLE_LOAD * 100.0) << " %." << std::endl;
+        ok = false;
+    }
+
+    double sum = 0.0;
+    double max = 0.0;
+    int lost = 0;
+    for (int i = 0; i < presses; ++i) {
+        int server = i % SERVER_COUNT;
+        double latency = press(servers, server, ((i / SERVER_COUNT) % 2 == 0), *devices[server]);
+        if (latency < 0.0) {
+            lost++;
+            continue;
+        }
+        sum += latency;
+        max = (std::max)(max, latency);
+    }
+    int received = presses - lost;
+    std::printf("[VrpnReactorBenchmark] %d button events: latency mean %.3f ms, max %.3f ms, %d lost\n",
+        presses, (received > 0) ? (sum / received * 1000.0) : (0.0), max * 1000.0, lost);
+    if ((lost > 0) || (max > MAX_LATENCY)) {
+        std::cerr << "[ERROR] [VrpnReactorBenchmark] Button events lost or latency exceeds " << (MAX_LATENCY * 1000.0) << " ms." << std::endl;
+        ok = false;
+    }
+
+    for (auto& device : devices) {
+        device->Disconnect();
+    }
+    servers.Stop();
+
+    std::cout << "[VrpnReactorBenchmark] " << ((ok) ? ("PASSED") : ("FAILED")) << std::endl;
+    return (ok) ? (0) : (1);
+}
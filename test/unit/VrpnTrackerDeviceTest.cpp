@@ -0,0 +1,164 @@
+/**
+ * VrpnTrackerDeviceTest.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "VrpnTrackerDevice.h"
+#include "vrpn_Tracker.h"
+#include "UnitTest.h"
+
+/**** HOWTO: ******************************************************************
+*
+* Runs a VRPN server connection with a vrpn_Tracker_NULL (two sensors) in
+* process on the loopback interface. Two tracker devices feed sensor 1
+* and the missing sensor 5 into external rigid bodies of the pool: poses
+* have to reach GetRigidBodyData() for the configured sensor only, and the
+* latest pose has to be flagged stale after the server went away.
+*
+* Usage: ./VrpnTrackerDeviceTest
+*
+******************************************************************************/
+
+namespace {
+
+    /** Update rate of the tracker server in Hz. */
+    const double RATE = 100.0;
+
+    tracking::test::Checker check("VrpnTrackerDeviceTest");
+
+    /** VRPN server with a tracker run by its own thread until stopped. */
+    class TrackerServer {
+    public:
+        TrackerServer(void) : m_running(false), m_thread() { }
+        ~TrackerServer(void) { this->Stop(); }
+
+        bool Start(unsigned int port) {
+            this->m_running = true;
+            std::promise<bool> started;
+            std::future<bool> result = started.get_future();
+            this->m_thread = std::thread([this, port, &started]() {
+                vrpn_Connection* connection = vrpn_create_server_connection(static_cast<int>(port));
+                if ((connection == nullptr) || !connection->doing_okay()) {
+                    started.set_value(false);
+                    return;
+                }
+                {
+                    vrpn_Tracker_NULL tracker("Tracker0", connection, 2, RATE);
+                    started.set_value(true);
+                    while (this->m_running) {
+                        struct timeval timeout;
+                        timeout.tv_sec  = 0;
+                        timeout.tv_usec = 1000;
+                        tracker.mainloop();
+                        connection->mainloop(&timeout);
+                    }
+                }
+                connection->removeReference(); /// Deletes the connection, which drops the link of the clients.
+            });
+            return result.get();
+        }
+
+        void Stop(void) {
+            this->m_running = false;
+            if (this->m_thread.joinable()) {
+                this->m_thread.join();
+            }
+        }
+
+    private:
+        std::atomic<bool> m_running;
+        std::thread m_thread;
+    };
+}
+
+
+int main(int argc, char** argv) {
+
+    unsigned int port = tracking::test::FreePort();
+    TrackerServer server;
+    if ((port == 0) || !server.Start(port)) {
+        std::cerr << "[ERROR] [VrpnTrackerDeviceTest] Failed to start the VRPN server." << std::endl;
+        return 1;
+    }
+
+    // The pool only holds the external rigid bodies (not connected to NatNet).
+    tracking::NatNetDevicePool::Params p;
+    p.client_ip                    = "127.0.0.1";
+    p.client_ip_len                = 9;
+    p.server_ip                    = "127.0.0.1";
+    p.server_ip_len                = 9;
+    p.cmd_port                     = 1510;
+    p.data_port                    = 1511;
+    p.con_type                     = tracking::NatNetDevicePool::ConnectionType::UniCast;
+    p.multicast_ip                 = "";
+    p.multicast_ip_len             = 0;
+    p.receive_buffer_size          = 0;
+    p.verbose_client               = false;
+    p.native_client                = true;
+    p.prediction.model             = tracking::PosePredictor::Model::None;
+    p.prediction.horizon           = 0.0f;
+    p.prediction.process_noise     = 500.0f;
+    p.prediction.measurement_noise = 0.0000005f;
+    p.subscription                 = false;
+    p.connect_timeout              = 0.2f;
+    p.cache_file                   = "";
+    p.cache_file_len               = 0;
+    p.servers                      = nullptr;
+    p.server_count                 = 0;
+    p.standby_servers              = nullptr;
+    p.standby_count                = 0;
+    p.failover_timeout             = 0.2f;
+
+    tracking::NatNetDevicePool pool;
+    if (!pool.Initialise(p)) {
+        std::cerr << "[ERROR] [VrpnTrackerDeviceTest] Failed to initialise the pool." << std::endl;
+        return 1;
+    }
+
+    // Both devices share the connection to the server, "Ghost" is fed by a sensor the tracker does not have.
+    tracking::VrpnReactor reactor;
+    tracking::VrpnTrackerDevice wand(reactor, pool);
+    tracking::VrpnTrackerDevice ghost(reactor, pool);
+    tracking::VrpnTrackerDevice::Params tp;
+    tp.device.device_name     = "Tracker0";
+    tp.device.device_name_len = 8;
+    tp.device.server_name     = "127.0.0.1";
+    tp.device.server_name_len = 9;
+    tp.device.port            = port;
+    tp.device.protocol        = tracking::VrpnDevice<vrpn_Tracker_Remote>::Protocols::VRPN_TCP;
+    tp.rigid_body_name        = "Wand";
+    tp.rigid_body_name_len    = 4;
+    tp.sensor                 = 1;
+    check(wand.Initialise(tp) && wand.Connect(), "Connecting sensor 1");
+    tp.rigid_body_name        = "Ghost";
+    tp.rigid_body_name_len    = 5;
+    tp.sensor                 = 5;
+    check(ghost.Initialise(tp) && ghost.Connect(), "Connecting sensor 5");
+
+    // Poses of the configured sensor only (vrpn_Tracker_NULL reports the identity pose for each sensor).
+    tracking::NatNetDevicePool::RigidBodyData data;
+    check(tracking::test::WaitFor([&]() { return pool.GetRigidBodyData(wand.GetRigidBody(), data) && (data.frame >= 10) && !data.stale; }, 5.0), "Receiving poses of sensor 1");
+    check((data.position.x == 0.0f) && (data.position.y == 0.0f) && (data.position.z == 0.0f) && (data.orientation.w == 1.0f) &&
+        (data.receive_time > 0.0), "Pose of sensor 1");
+    int frame = data.frame;
+    double start = tracking::GetLocalTime();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    check(pool.GetRigidBodyData(wand.GetRigidBody(), data), "Reading pose of sensor 1");
+    double expected = (tracking::GetLocalTime() - start) * RATE;
+    check((data.frame - frame) < static_cast<int>(1.5 * expected), "Number of poses of sensor 1 (" + std::to_string(data.frame - frame) +
+        " poses in " + std::to_string(expected) + " updates)");
+    check(pool.GetRigidBodyData(ghost.GetRigidBody(), data) && (data.frame < 0), "No poses of sensor 5");
+
+    // The latest pose is kept and flagged stale after the server went away.
+    server.Stop();
+    check(tracking::test::WaitFor([&]() { return pool.GetRigidBodyData(wand.GetRigidBody(), data) && data.stale; }, 5.0), "Flagging pose stale after the server went away");
+    check(data.frame >= 10, "Keeping the latest pose");
+
+    wand.Disconnect();
+    ghost.Disconnect();
+
+    std::cout << "[VrpnTrackerDeviceTest] " << ((check.Passed()) ? ("PASSED") : ("FAILED")) << std::endl;
+    return (check.Passed()) ? (0) : (1);
+}
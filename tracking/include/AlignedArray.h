@@ -0,0 +1,140 @@
+/**
+ * AlignedArray.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_ALIGNEDARRAY_H_INCLUDED
+#define TRACKING_ALIGNEDARRAY_H_INCLUDED
+
+#include "stdafx.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Fixed size array of default constructed elements in one contiguous
+    * block of memory, which respects the alignment of the element type.
+    *
+    * Element types do not have to be copyable or movable (e.g. types
+    * containing atomic variables). Over-aligned element types (e.g. padded
+    * to a cache line) are aligned correctly independent of the language
+    * standard used by the compiler.
+    *
+    ***************************************************************************/
+    template <class T> class AlignedArray {
+
+    public:
+
+        /**
+        * CTOR
+        */
+        AlignedArray(void);
+
+        /**
+        * DTOR
+        */
+        ~AlignedArray(void);
+
+        AlignedArray(const AlignedArray&) = delete;
+        AlignedArray& operator=(const AlignedArray&) = delete;
+
+        /**
+        * Allocate memory and default construct all elements.
+        * Previously allocated elements are destroyed.
+        *
+        * @param size The number of elements.
+        */
+        void Allocate(size_t size);
+
+        /**
+        * Destroy all elements and free memory.
+        */
+        void Release(void);
+
+        /**********************************************************************/
+        // GET
+
+        inline size_t Size(void) const {
+            return this->m_size;
+        }
+
+        inline T& operator[](size_t index) {
+            return this->m_data[index];
+        }
+
+        inline const T& operator[](size_t index) const {
+            return this->m_data[index];
+        }
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        std::unique_ptr<unsigned char[]> m_memory;
+        T* m_data;
+        size_t m_size;
+
+    };
+
+} /** end namespace tracking */
+
+
+/// Template classes must be declared AND defined in the header file.
+
+
+template <class T>
+tracking::AlignedArray<T>::AlignedArray(void)
+    : m_memory(nullptr)
+    , m_data(nullptr)
+    , m_size(0) {
+
+    // intentionally empty...
+}
+
+
+template <class T>
+tracking::AlignedArray<T>::~AlignedArray(void) {
+
+    this->Release();
+}
+
+
+template <class T>
+void tracking::AlignedArray<T>::Allocate(size_t size) {
+
+    this->Release();
+    if (size == 0) {
+        return;
+    }
+
+    // Over-allocate by the alignment and move the data pointer to the first aligned address.
+    size_t space = sizeof(T) * size + alignof(T);
+    this->m_memory.reset(new unsigned char[space]);
+    void *ptr = this->m_memory.get();
+    std::align(alignof(T), sizeof(T) * size, ptr, space);
+    this->m_data = static_cast<T*>(ptr);
+
+    for (size_t i = 0; i < size; ++i) {
+        new (&this->m_data[i]) T();
+    }
+    this->m_size = size;
+}
+
+
+template <class T>
+void tracking::AlignedArray<T>::Release(void) {
+
+    for (size_t i = 0; i < this->m_size; ++i) {
+        this->m_data[i].~T();
+    }
+    this->m_data = nullptr;
+    this->m_size = 0;
+    this->m_memory.reset(nullptr);
+}
+
+
+#endif /** TRACKING_ALIGNEDARRAY_H_INCLUDED */
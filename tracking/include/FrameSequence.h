@@ -0,0 +1,113 @@
+/**
+ * FrameSequence.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_FRAMESEQUENCE_H_INCLUDED
+#define TRACKING_FRAMESEQUENCE_H_INCLUDED
+
+#include "stdafx.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Monitors the sequence of received frame numbers of one stream.
+    *
+    * Counts gaps (lost frames), duplicates and frames received out of order
+    * and keeps a rolling loss rate over the last LOSS_WINDOW to
+    * 2 * LOSS_WINDOW expected frames. Frames are accepted by a single
+    * writer (the receiving thread), all counters are atomic, so any number
+    * of threads can query at the same time without locking.
+    *
+    ***************************************************************************/
+    class FrameSequence {
+
+    public:
+
+        /** Counters of the stream. */
+        struct Statistics {
+            uint64_t                         frames;         /** The number of accepted frames. */
+            uint64_t                         gaps;           /** The number of gaps in the frame numbers. */
+            uint64_t                         lost;           /** The number of frames missing in all gaps. */
+            uint64_t                         duplicates;     /** The number of dropped duplicate frames. */
+            uint64_t                         out_of_order;   /** The number of dropped frames older than the latest frame. */
+            uint64_t                         restarts;       /** The number of restarts of the frame numbers (e.g. host application restarted). */
+            double                           loss_rate;      /** The rolling ratio of lost to expected frames in [0, 1]. */
+            int                              last_frame;     /** The latest accepted frame number (-1 if none). */
+            double                           last_receive_time; /** The local receive time of the latest accepted frame (0 if none). */
+            double                           first_receive_time; /** The local receive time of the first accepted frame (0 if none). */
+        };
+
+        /** Number of expected frames per window of the rolling loss rate. */
+        static const uint64_t LOSS_WINDOW = 1000;
+
+        /**
+        * Frame number differences beyond this are treated as restart of the
+        * frame numbers instead of lost or out of order frames.
+        */
+        static const int MAX_FRAME_JUMP = 10000;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        FrameSequence(void);
+
+        FrameSequence(const FrameSequence&) = delete;
+        FrameSequence& operator=(const FrameSequence&) = delete;
+
+        /**
+        * Check the frame number of a received frame (single writer only).
+        *
+        * @param frame        The frame number.
+        * @param receive_time The local receive time.
+        *
+        * @return True if the frame is newer than the latest frame, false for duplicate or out of order frames (which should be dropped).
+        */
+        bool Accept(int frame, double receive_time);
+
+        /**
+        * Reset all counters.
+        * The writer forgets the latest frame number with the next frame.
+        */
+        void Reset(void);
+
+        /**
+        * Get the counters.
+        *
+        * @param o_stats Returns the counters.
+        */
+        void GetStatistics(Statistics& o_stats) const;
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        std::atomic<uint64_t>                m_frames;
+        std::atomic<uint64_t>                m_gaps;
+        std::atomic<uint64_t>                m_lost;
+        std::atomic<uint64_t>                m_duplicates;
+        std::atomic<uint64_t>                m_out_of_order;
+        std::atomic<uint64_t>                m_restarts;
+        std::atomic<double>                  m_loss_rate;
+        std::atomic<int>                     m_last_frame;
+        std::atomic<double>                  m_last_receive_time;
+        std::atomic<double>                  m_first_receive_time;
+        std::atomic<bool>                    m_reset;             // Writer has to forget the latest frame number
+        bool                                 m_started;           // A frame was accepted (only used by writer)
+        uint64_t                             m_window_expected;   // Expected frames of the current window (only used by writer)
+        uint64_t                             m_window_lost;       // Lost frames of the current window (only used by writer)
+        uint64_t                             m_previous_expected; // Expected frames of the previous window (only used by writer)
+        uint64_t                             m_previous_lost;     // Lost frames of the previous window (only used by writer)
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_FRAMESEQUENCE_H_INCLUDED */
@@ -0,0 +1,119 @@
+/**
+ * FrameSignal.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_FRAMESIGNAL_H_INCLUDED
+#define TRACKING_FRAMESIGNAL_H_INCLUDED
+
+#include "stdafx.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Signals new data (e.g. published frames or button events) to waiting
+    * consumers.
+    *
+    * Every notification increments a sequence number. Consumers either
+    * block in Wait() until the sequence number passes their latest one, or
+    * wait on a descriptor together with other I/O (eventfd on Linux, read
+    * end of a pipe on other POSIX systems, manual reset event on Windows),
+    * which stays readable (signaled) until
+    * the consumer resets it. The producer only locks if a consumer is
+    * blocked in Wait(), and only writes the descriptor if it was reset
+    * since the previous notification.
+    *
+    ***************************************************************************/
+    class FrameSignal {
+
+    public:
+
+        /** Pollable descriptor (eventfd, pipe or event handle). */
+#ifdef _WIN32
+        typedef HANDLE Descriptor;
+#else
+        typedef int Descriptor;
+#endif
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        FrameSignal(void);
+
+        /**
+        * DTOR
+        */
+        ~FrameSignal(void);
+
+        FrameSignal(const FrameSignal&) = delete;
+        FrameSignal& operator=(const FrameSignal&) = delete;
+
+        /**
+        * Signal new data (any thread).
+        */
+        void Notify(void);
+
+        /**
+        * Get the sequence number, which increases with every notification.
+        *
+        * @return The sequence number (0 if there was no notification yet).
+        */
+        inline uint64_t GetSequence(void) const {
+            return this->m_sequence.load();
+        }
+
+        /**
+        * Block until the sequence number differs from the given one or the timeout elapses.
+        *
+        * @param sequence The latest sequence number known to the consumer.
+        * @param timeout  The timeout in seconds (negative to wait without timeout).
+        *
+        * @return The current sequence number (equals sequence on timeout).
+        */
+        uint64_t Wait(uint64_t sequence, double timeout);
+
+        /**
+        * Get the descriptor, which becomes readable (signaled) on notification.
+        * Do not read or close it, but reset it with ResetDescriptor().
+        *
+        * @return The descriptor, invalid (-1 or nullptr) if it could not be created.
+        */
+        inline Descriptor GetDescriptor(void) const {
+            return this->m_descriptor;
+        }
+
+        /**
+        * Reset the descriptor after it became readable. Check the sequence
+        * number afterwards, since notifications between the wake up and the
+        * reset do not signal the descriptor again.
+        *
+        * @return The current sequence number.
+        */
+        uint64_t ResetDescriptor(void);
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        std::atomic<uint64_t> m_sequence;
+        std::atomic<int> m_waiters;                      // Number of consumers blocked in Wait()
+        std::mutex m_mutex;                              // Only locked with waiters
+        std::condition_variable m_cv;
+        std::atomic<bool> m_signaled;                    // Descriptor was signaled and not reset yet
+        Descriptor m_descriptor;
+#if !defined(_WIN32) && !defined(__linux__)
+        int m_pipe_write;                                // Write end of the pipe (m_descriptor is the read end)
+#endif
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_FRAMESIGNAL_H_INCLUDED */
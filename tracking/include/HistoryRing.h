@@ -0,0 +1,170 @@
+/**
+ * HistoryRing.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_HISTORYRING_H_INCLUDED
+#define TRACKING_HISTORYRING_H_INCLUDED
+
+#include "stdafx.h"
+#include "AlignedArray.h"
+#include "SeqLock.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Fixed capacity ring of the most recent values written by a single
+    * thread and read by any number of threads (lock free).
+    *
+    * Every value gets an increasing position (0, 1, 2, ...). Readers access
+    * values by position, so each reader can keep its own cursor. Entries
+    * are held in sequence locks and tagged with their position, thus a read
+    * never returns a torn value and an overwritten value is reported as lost.
+    * T must be bitwise copyable.
+    *
+    ***************************************************************************/
+    template <class T> class HistoryRing {
+
+    public:
+
+        /**
+        * CTOR
+        */
+        HistoryRing(void);
+
+        HistoryRing(const HistoryRing&) = delete;
+        HistoryRing& operator=(const HistoryRing&) = delete;
+
+        /**
+        * Allocate the ring and drop all values.
+        * Must not be called while readers or the writer are active.
+        *
+        * @param capacity The number of values kept (rounded up to a power of two).
+        */
+        void Allocate(size_t capacity);
+
+        /**
+        * Append a value, overwriting the oldest one if the ring is full
+        * (single writer only).
+        *
+        * @param value The value.
+        */
+        void Push(const T& value);
+
+        /**
+        * Read the value at the given position.
+        *
+        * @param position The position of the value.
+        * @param o_value  Returns the value.
+        *
+        * @return True for success, false if the value was not written yet or was already overwritten.
+        */
+        bool Get(uint64_t position, T& o_value) const;
+
+        /**
+        * Get the position the next value will be written to, which is the
+        * number of values written so far.
+        *
+        * @return The end position.
+        */
+        inline uint64_t GetEnd(void) const {
+            return this->m_end.load(std::memory_order_acquire);
+        }
+
+        /**
+        * Get the position of the oldest value which is still available.
+        *
+        * @return The begin position (equals GetEnd() if the ring is empty).
+        */
+        inline uint64_t GetBegin(void) const {
+            uint64_t end = this->GetEnd();
+            return (end > this->m_entries.Size()) ? (end - this->m_entries.Size()) : (0);
+        }
+
+        inline size_t GetCapacity(void) const {
+            return this->m_entries.Size();
+        }
+
+    private:
+
+        /**********************************************************************
+        * types and structs
+        **********************************************************************/
+
+        /** One entry of the ring, tagged with the position of its value. */
+        struct Entry {
+            T                                        value;
+            uint64_t                                 position;
+        };
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        tracking::AlignedArray<tracking::SeqLock<Entry>> m_entries;
+        std::atomic<uint64_t>                            m_end;
+
+    };
+
+} /** end namespace tracking */
+
+
+/// Template classes must be declared AND defined in the header file.
+
+
+template <class T>
+tracking::HistoryRing<T>::HistoryRing(void)
+    : m_entries()
+    , m_end(0) {
+
+    // intentionally empty...
+}
+
+
+template <class T>
+void tracking::HistoryRing<T>::Allocate(size_t capacity) {
+
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    this->m_entries.Allocate(size);
+    this->m_end.store(0, std::memory_order_release);
+}
+
+
+template <class T>
+void tracking::HistoryRing<T>::Push(const T& value) {
+
+    if (this->m_entries.Size() == 0) {
+        return;
+    }
+    Entry entry;
+    entry.value = value;
+    entry.position = this->m_end.load(std::memory_order_relaxed);
+    this->m_entries[static_cast<size_t>(entry.position & (this->m_entries.Size() - 1))].Store(entry);
+    this->m_end.store(entry.position + 1, std::memory_order_release);
+}
+
+
+template <class T>
+bool tracking::HistoryRing<T>::Get(uint64_t position, T& o_value) const {
+
+    if ((position >= this->GetEnd()) || (position < this->GetBegin())) {
+        return false;
+    }
+    Entry entry;
+    this->m_entries[static_cast<size_t>(position & (this->m_entries.Size() - 1))].Load(entry);
+    // Entry might have been overwritten by a newer value in the meantime.
+    if (entry.position != position) {
+        return false;
+    }
+    o_value = entry.value;
+    return true;
+}
+
+
+#endif /** TRACKING_HISTORYRING_H_INCLUDED */
@@ -0,0 +1,120 @@
+/**
+ * LatencyHistogram.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_LATENCYHISTOGRAM_H_INCLUDED
+#define TRACKING_LATENCYHISTOGRAM_H_INCLUDED
+
+#include "stdafx.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Running histogram of latencies.
+    *
+    * Latencies are counted in fixed buckets of BUCKET_WIDTH microseconds,
+    * latencies beyond the last bucket are counted in an overflow bucket.
+    * All counters are atomic, so any number of threads can record and
+    * query at the same time without locking.
+    *
+    ***************************************************************************/
+    class LatencyHistogram {
+
+    public:
+
+        /** Summary of all recorded latencies (in seconds). */
+        struct Statistics {
+            uint64_t                         count;          /** The number of recorded latencies. */
+            double                           mean;           /** The mean latency. */
+            double                           min;            /** The minimal latency. */
+            double                           max;            /** The maximal latency. */
+            double                           p50;            /** The median latency (upper bound of bucket). */
+            double                           p95;            /** The 95th percentile (upper bound of bucket). */
+            double                           p99;            /** The 99th percentile (upper bound of bucket). */
+        };
+
+        /** Width of one bucket in microseconds. */
+        static const uint64_t BUCKET_WIDTH = 250;
+
+        /** Number of buckets (without overflow bucket), covering 0 to 64 ms. */
+        static const size_t BUCKET_COUNT = 256;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        LatencyHistogram(void);
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        /**
+        * Record one latency.
+        * Negative latencies (e.g. while the clocks are not synchronised yet)
+        * are counted as zero.
+        *
+        * @param seconds The latency in seconds.
+        */
+        void Record(double seconds);
+
+        /**
+        * Remove all recorded latencies.
+        */
+        void Reset(void);
+
+        /**
+        * Get summary of all recorded latencies.
+        *
+        * @param o_stats Returns the summary.
+        */
+        void GetStatistics(Statistics& o_stats) const;
+
+        /**
+        * Get the number of latencies in one bucket.
+        *
+        * @param index The index of the bucket, BUCKET_COUNT for the overflow bucket.
+        *
+        * @return The number of latencies in the bucket.
+        */
+        inline uint64_t GetBucket(size_t index) const {
+            return (index <= BUCKET_COUNT) ? (this->m_buckets[index].load(std::memory_order_relaxed)) : (0);
+        }
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT + 1> m_buckets;
+        std::atomic<uint64_t>                               m_count;
+        std::atomic<uint64_t>                               m_sum;        // Sum of latencies in microseconds
+        std::atomic<uint64_t>                               m_min;        // Minimal latency in microseconds
+        std::atomic<uint64_t>                               m_max;        // Maximal latency in microseconds
+
+        /**********************************************************************
+        * functions
+        **********************************************************************/
+
+        /**
+        * Get the upper bound of the bucket containing the given percentile.
+        *
+        * @param counts  The bucket counts.
+        * @param count   The total count.
+        * @param percent The percentile in [0, 1].
+        * @param max     The maximal latency in seconds (used for the overflow bucket).
+        *
+        * @return The latency in seconds.
+        */
+        static double percentile(const std::array<uint64_t, BUCKET_COUNT + 1>& counts, uint64_t count, double percent, double max);
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_LATENCYHISTOGRAM_H_INCLUDED */
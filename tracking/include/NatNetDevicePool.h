@@ -9,9 +9,22 @@
 #define TRACKING_NATNETDEVICEPOOL_H_INCLUDED
 
 #include "stdafx.h"
+#include "AlignedArray.h"
+#include "SeqLock.h"
+#include "SnapshotPublisher.h"
+#include "HistoryRing.h"
+#include "LatencyHistogram.h"
+#include "FrameSequence.h"
+#include "FrameSignal.h"
+#include "SessionCache.h"
+#include "PosePredictor.h"
+#include "NatNetPacketDecoder.h"
+#include "NatNetNativeClient.h"
 #include "NatNetTypes.h"
+#ifdef TRACKING_NATNET_SDK
 #include "NatNetClient.h"
 #include "NatNetCAPI.h"
+#endif
 
 namespace tracking{
 
@@ -20,6 +33,50 @@ namespace tracking{
     * Manages the connection to a NatNet host application and holds the 
     * tracking data of available rigid bodies.
     *
+    * The connection is either established by the NatNet SDK (Windows only)
+    * or by the built-in client (see NatNetNativeClient), which decodes the
+    * received packets in place.
+    *
+    * Rigid bodies added or removed in the host application while connected
+    * are picked up without reconnecting: unknown streaming IDs or the 
+    * "tracked models changed" frame flag trigger a refresh of the data 
+    * descriptions in a background thread.
+    *
+    * With subscription enabled only rigid bodies referenced by consumers
+    * are processed. The subscriptions are also forwarded to the server
+    * (NatNet 4.0 or later in unicast), so only these rigid bodies are
+    * streamed at all.
+    *
+    * With a cache file the data descriptions of the last session are 
+    * loaded on initialisation (see SessionCache), so handles can be 
+    * resolved before connecting. On connect the cached descriptions are
+    * used right away and validated against the server in the background.
+    *
+    * Further servers (e.g. a second Motive rig covering another area) are
+    * merged into one tracking space: each server is handled by its own 
+    * pool (source) transforming its poses into the common coordinates, and
+    * every frame of any source triggers a merge into this pool. The merge 
+    * takes each rigid body (matched by name) from the source with the 
+    * lowest mean marker error and interpolates its pose to the exposure 
+    * time of the triggering frame (all times are local times). Merging is
+    * skipped instead of waiting while another source is merging.
+    *
+    * Standby servers are tried in order of priority if the server does
+    * not respond on connect or stops sending frames while connected 
+    * (failover). Without standby servers the same server is reconnected.
+    * Failed attempts are repeated with exponential backoff until frames
+    * arrive again. Rigid body handles, names, the latest poses and their
+    * history are kept on failover and on reconnect, the latest poses are
+    * flagged stale meanwhile, so consumers only notice the gap in the data.
+    * Skeletons are only added to the skeleton table, published entries
+    * never change: skeletons of a later connection are matched by name and
+    * bones, skeletons with changed bones are ignored until restart.
+    *
+    * Rigid bodies can also be fed by other devices (e.g. VRPN trackers, see
+    * AddExternalRigidBody()), NatNet data of these rigid bodies is ignored.
+    * Without server IP no NatNet server is connected at all and only such
+    * external rigid bodies are available.
+    *
     ***************************************************************************/
     class NatNetDevicePool {
 
@@ -31,24 +88,110 @@ namespace tracking{
             UniCast   = 1
         };
 
+        /** Parameters of a further NatNet server merged into the pool (see Params::servers). */
+        struct ServerParams {
+            const char*                      server_ip;      /** The IP address of the NatNet server.       */
+            size_t                           server_ip_len;
+            unsigned int                     cmd_port;       /** The NatNet command port.                   */
+            unsigned int                     data_port;      /** The NatNet data port.                      */
+            glm::quat                        orientation;    /** The rotation from server to pool coordinates. */
+            glm::vec3                        position;       /** The origin of the server in pool coordinates. */
+        };
+
         /** Data structure for setting parameters as batch. */
         struct Params {
             const char*                      client_ip;      /** The IP address of the NatNet client.       */
             size_t                           client_ip_len;  
-            const char *                     server_ip;      /** The IP address of the NatNet server.       */
+            const char *                     server_ip;      /** The IP address of the NatNet server (empty string for no NatNet server, see AddExternalRigidBody()). */
             size_t                           server_ip_len;  
             unsigned int                     cmd_port;       /** The NatNet command port.                   */
             unsigned int                     data_port;      /** The NatNet data port.                      */
-            NatNetDevicePool::ConnectionType con_type;       /** The NatNet connection type.                */
+            NatNetDevicePool::ConnectionType con_type;       /** The NatNet connection type (must match the setting in Motive). */
+            const char*                      multicast_ip;   /** The multicast group for MultiCast (empty string for the group announced by the server). */
+            size_t                           multicast_ip_len;
+            unsigned int                     receive_buffer_size; /** The size of the socket receive buffer in bytes (0 for default, built-in client only). */
             bool                             verbose_client; /** Turn on/off NatNet client massage output.  */
+            bool                             native_client;  /** Use built-in NatNet client instead of NatNet SDK (always used if built without SDK). */
+            tracking::PosePredictor::Params  prediction;     /** Parameters of the pose prediction (set model to None to disable). */
+            bool                             subscription;   /** Only process rigid bodies with subscribers (see SubscribeRigidBody()), markers and skeletons are dropped. */
+            float                            connect_timeout;/** The timeout of each request to the server while connecting in seconds (0 for default). */
+            const char*                      cache_file;     /** The file caching the data descriptions between sessions (empty string to disable). */
+            size_t                           cache_file_len;
+            const ServerParams*              servers;        /** Further servers merged with the server above (in its coordinates), markers and skeletons are dropped. */
+            size_t                           server_count;   /** The number of further servers (0 for one server). */
+            const ServerParams*              standby_servers;/** Servers replacing the server above in order of priority (nullptr for none), see failover_timeout. */
+            size_t                           standby_count;  /** The number of standby servers. */
+            float                            failover_timeout; /** The time without frames in seconds before reconnecting, to the next server if any (0 disables the watchdog), switching takes at most this plus the connect timeouts of the tried servers. */
         };
 
-        /** Data of one rigid body. */
+        /** Counters of the failover to standby servers. */
+        struct FailoverStatistics {
+            uint64_t                         failovers;      /** The number of reconnects after silence (switches to another server if any). */
+            size_t                           server;         /** The current server (0 for the server of Params, i + 1 for standby server i). */
+            double                           last_latency;   /** The time without frames of the latest failover in seconds (last frame of the old until first frame of the new server). */
+            double                           max_latency;    /** The maximum time without frames of all failovers in seconds. */
+        };
+
+        /** Stages of the latency between camera exposure and use of the data. */
+        enum LatencyStage {
+            ExposureToTransmit = 0,                          /** Camera mid exposure until host transmitted the frame. */
+            TransmitToReceive  = 1,                          /** Host transmitted the frame until it was received locally. */
+            ReceiveToRead      = 2,                          /** Frame was received locally until a consumer first read it (once per frame and rigid body). */
+            LATENCY_STAGE_COUNT
+        };
+
+        /** Data of one rigid body (always captured together from one frame). */
         struct RigidBodyData {
             glm::quat                        orientation;    /** The current orientation of the motion device. */
             glm::vec3                        position;       /** The current position of the motion device. */
+            int                              frame;          /** The NatNet frame number of the data (-1 if no data was received yet). */
+            double                           timestamp;      /** The NatNet software timestamp of the frame (seconds since start of host software). */
+            double                           exposure_time;  /** The camera mid exposure time of the frame in local time (see GetLocalTime()). */
+            double                           receive_time;   /** The time the frame was received in local time (see GetLocalTime()). */
+            float                            mean_error;     /** The mean marker error of the rigid body (0 if unknown). */
+            bool                             stale;          /** True if the link to the server is lost (or not connected) and this is the latest pose received before. */
+        };
+
+        /** 
+        * Markers captured in one frame as structure of arrays (capacity is 
+        * preallocated, the first count entries of each array are valid).
+        * The marker ID contains the model ID in the upper and the marker 
+        * ID in the lower 16 bits. Params are the NatNet marker flags 
+        * (0x01 occluded, 0x02 point cloud solved, 0x04 model solved, 
+        * 0x08 has model, 0x10 unlabeled, 0x20 active).
+        */
+        struct MarkerData {
+            size_t                                          count;      /** The number of markers. */
+            std::array<float, MAX_LABELED_MARKERS>          x;
+            std::array<float, MAX_LABELED_MARKERS>          y;
+            std::array<float, MAX_LABELED_MARKERS>          z;
+            std::array<float, MAX_LABELED_MARKERS>          size;       /** The marker size. */
+            std::array<float, MAX_LABELED_MARKERS>          residual;   /** The mean ray error of the marker. */
+            std::array<int32_t, MAX_LABELED_MARKERS>        id;
+            std::array<int16_t, MAX_LABELED_MARKERS>        params;
+        };
+
+        /** Bones of one skeleton captured in one frame. */
+        struct SkeletonData {
+            int                              frame;          /** The NatNet frame number (-1 if the skeleton is not tracked in this frame). */
+            std::vector<glm::mat4>           bones;          /** World transforms of all bones in order of GetSkeletonBones(). */
+        };
+
+        /** Immutable data of all rigid bodies captured in one frame. */
+        struct FrameData {
+            int                              frame;          /** The NatNet frame number. */
+            double                           timestamp;      /** The NatNet software timestamp of the frame (seconds since start of host software). */
+            double                           exposure_time;  /** The camera mid exposure time of the frame in local time (see GetLocalTime()). */
+            double                           transmit_time;  /** The time the host transmitted the frame in local time (see GetLocalTime()). */
+            double                           receive_time;   /** The time the frame was received in local time (see GetLocalTime()). */
+            std::vector<RigidBodyData>       rigid_bodies;   /** Data of all rigid bodies in order of the handles. Bodies not tracked in this frame have frame number -1. */
+            MarkerData                       markers;        /** All labeled and unlabeled markers of the frame. */
+            std::vector<SkeletonData>        skeletons;      /** Data of all skeletons in order of GetSkeletonNames(). */
         };
 
+        /** Reference to a published frame, the frame stays unchanged as long as the reference exists. */
+        typedef tracking::SnapshotPublisher<FrameData>::Ptr FramePtr;
+
         ///////////////////////////////////////////////////////////////////////
 
         /**
@@ -86,36 +229,315 @@ namespace tracking{
         // GET
 
         /**
-        * Get orientation of rigid body. 
-        * If no name is given, the data of the first rigid body is returned.
+        * Resolve the handle of a rigid body.
+        * Handles stay valid across reconnects and refreshes, since rigid 
+        * bodies are never removed from the table and are matched by name.
+        * Safe to call while rigid bodies are added.
+        *
+        * @param rigid_body The rigid body name.
+        *
+        * @return The handle of the rigid body, -1 if the name is unknown.
+        */
+        inline int ResolveRigidBody(const std::string& rigid_body) const {
+            return this->find_rigid_body(rigid_body);
+        }
+
+        /**
+        * Subscribe to the data of a rigid body (see Params::subscription).
+        * Subscriptions are counted, each call has to be matched by a call
+        * of UnsubscribeRigidBody(). Subscriptions are kept on reconnect.
+        *
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()).
+        *
+        * @return True for success, false otherwise.
+        */
+        bool SubscribeRigidBody(int rigid_body);
+
+        /**
+        * Release a subscription of SubscribeRigidBody().
         *
-        * @param rigid_body The rigid body name to get the orientation of
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()).
+        *
+        * @return True for success, false otherwise.
+        */
+        bool UnsubscribeRigidBody(int rigid_body);
+
+        /**
+        * Get consistent snapshot of rigid body data.
+        * Orientation, position, frame number and timestamp are always
+        * returned from the same frame.
+        *
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()) to get the data of.
+        * @param o_data     Returns the current data of the given rigid body.
         * 
-        * @return The current orientation of the given rigid body.
+        * @return True for success, false otherwise.
         */
-        glm::quat GetOrientation(const std::string& rigid_body); 
+        bool GetRigidBodyData(int rigid_body, RigidBodyData& o_data); 
 
         /**
-        * Get position of rigid body.
-        * If no name is given, the data of the first rigid body is returned.
+        * Get consistent snapshot of rigid body data.
+        * Prefer the handle based overload for repeated calls.
         *
-        * @param rigid_body The rigid body name to get the position of.
+        * @param rigid_body The rigid body name to get the data of.
+        * @param o_data     Returns the current data of the given rigid body.
         * 
-        * @return The current position of the given rigid body.
+        * @return True for success, false otherwise.
+        */
+        inline bool GetRigidBodyData(const std::string& rigid_body, RigidBodyData& o_data) {
+            return this->GetRigidBodyData(this->ResolveRigidBody(rigid_body), o_data);
+        }
+
+        /**
+        * Get rigid body data with the pose predicted to the given time 
+        * (e.g. the display time of the rendered frame), which compensates 
+        * the latency of the tracking data (see Params::prediction).
+        * Without prediction the latest pose is returned.
+        *
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()).
+        * @param time       The local time (see GetLocalTime()) to predict the pose to, negative for the latest pose.
+        * @param o_data     Returns the data of the given rigid body.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool GetPredictedRigidBodyData(int rigid_body, double time, RigidBodyData& o_data);
+
+        /**
+        * Get the sequence number of the data of a rigid body, which increases
+        * whenever the data returned by GetRigidBodyData() changes (new pose
+        * or change of the stale flag). Read it before the data, so a change 
+        * in between is never missed.
+        *
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()).
+        *
+        * @return The sequence number, 0 for unknown handles.
+        */
+        uint64_t GetRigidBodySequence(int rigid_body) const;
+
+        /**
+        * Add a rigid body whose data is stored by another device (see 
+        * StoreExternalRigidBodyData()) instead of NatNet. NatNet data of a
+        * rigid body with the same name is ignored. External rigid bodies 
+        * are not part of the frames (see GetLatestFrame()). 
+        * Call after Initialise() and before Connect().
+        *
+        * @param rigid_body The rigid body name.
+        *
+        * @return The handle of the rigid body, -1 on failure.
+        */
+        int AddExternalRigidBody(const std::string& rigid_body);
+
+        /**
+        * Store the data of an external rigid body (see AddExternalRigidBody()).
+        * Data flagged stale only flags the latest pose stale, which is kept.
+        * Each external rigid body must be written by one thread only.
+        *
+        * @param rigid_body The rigid body handle.
+        * @param data       The data of the rigid body (times in local time, see GetLocalTime()).
+        *
+        * @return True for success, false if the handle is unknown or not external.
+        */
+        bool StoreExternalRigidBodyData(int rigid_body, const RigidBodyData& data);
+
+        /**
+        * Set the signal notified with every published frame and stored 
+        * external rigid body data. Call before Connect().
+        *
+        * @param signal The signal (not owned, nullptr for none).
+        */
+        inline void SetFrameSignal(tracking::FrameSignal* signal) {
+            this->m_frame_signal = signal;
+        }
+
+        /**
+        * Get the pose of a rigid body at the given time.
+        * The pose is interpolated between the two recorded poses enclosing 
+        * the given time (linear for position, spherical for orientation).
+        * Times outside of the recorded history are clamped to the oldest 
+        * or latest pose (see also HISTORY_SIZE).
+        *
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()).
+        * @param time       The local time (see GetLocalTime()) to get the pose at, compared to the exposure time of the poses.
+        * @param o_data     Returns the pose of the given rigid body.
+        *
+        * @return True for success, false if no pose was recorded yet.
+        */
+        bool GetPoseAt(int rigid_body, double time, RigidBodyData& o_data) const;
+
+        /**
+        * Get the latest complete frame.
+        * All rigid bodies of the returned frame stem from the same NatNet 
+        * frame. Any number of threads can hold frames at the same time:
+        * frames come from a pool of FRAME_POOL_SIZE frames, which grows by
+        * one frame whenever readers hold all frames (allocating in the
+        * receiving thread). Release frames promptly.
+        *
+        * @return Reference to the latest frame, empty if no frame was received yet.
+        */
+        inline FramePtr GetLatestFrame(void) {
+            FramePtr frame = this->m_frames.Acquire();
+            if (frame && (this->m_read_frame.exchange(frame->frame) != frame->frame)) {
+                this->m_latencies[ReceiveToRead].Record(tracking::GetLocalTime() - frame->receive_time);
+            }
+            return frame;
+        }
+
+        /**
+        * Resolve the handle of a skeleton.
+        * Handles stay valid across reconnects (see ResolveRigidBody()).
+        *
+        * @param skeleton The skeleton name.
+        *
+        * @return The handle of the skeleton, -1 if the name is unknown.
+        */
+        int ResolveSkeleton(const std::string& skeleton) const;
+
+        /**
+        * Get the bone hierarchy of a skeleton.
+        * Published skeletons never change, so bones stay valid for the handle.
+        *
+        * @param skeleton  The skeleton handle (see ResolveSkeleton()).
+        * @param o_names   Returns the bone names.
+        * @param o_parents Returns the index of the parent of each bone (-1 for the root).
+        *
+        * @return True for success, false otherwise.
+        */
+        bool GetSkeletonBones(int skeleton, std::vector<std::string>& o_names, std::vector<int>& o_parents) const;
+
+        /**
+        * Get the world transforms of all bones of a skeleton from the latest
+        * frame in one call. The parent chains are composed once per frame
+        * when the frame is received, so this only copies the matrices.
+        * Bones are expected in local coordinates (default of Motive) and are
+        * placed at their offset relative to the parent while not tracked.
+        *
+        * @param skeleton   The skeleton handle (see ResolveSkeleton()).
+        * @param capacity   The number of entries of o_matrices.
+        * @param o_matrices Returns the world transforms in order of GetSkeletonBones().
+        * @param o_frame    Returns the NatNet frame number (-1 if the skeleton is not tracked).
+        *
+        * @return The number of copied matrices (at most capacity).
+        */
+        size_t GetSkeletonBoneMatrices(int skeleton, size_t capacity, glm::mat4* o_matrices, int& o_frame);
+
+        /**
+        * Get all available skeleton names (in order of the handles).
+        *
+        * @return All available skeleton names.
+        */
+        inline std::vector<std::string> GetSkeletonNames(void) const {
+            return std::vector<std::string>(this->m_skeleton_names.begin(), this->m_skeleton_names.begin() + this->GetSkeletonCount());
+        }
+
+        /**
+        * Get the number of skeletons (handles are 0 to count - 1).
+        *
+        * @return The number of skeletons.
+        */
+        inline size_t GetSkeletonCount(void) const {
+            return this->m_skeleton_count.load(std::memory_order_acquire);
+        }
+
+        /**
+        * Copy the markers of the latest frame into the given arrays.
+        * All arrays stem from the same frame. Arrays given as nullptr are
+        * skipped. Nothing is allocated.
+        *
+        * @param capacity   The number of entries of each given array.
+        * @param o_x        Returns the x coordinates.
+        * @param o_y        Returns the y coordinates.
+        * @param o_z        Returns the z coordinates.
+        * @param o_size     Returns the marker sizes.
+        * @param o_residual Returns the marker residuals.
+        * @param o_id       Returns the marker IDs.
+        * @param o_params   Returns the marker flags (see MarkerData).
+        * @param o_frame    Returns the NatNet frame number (-1 if no frame was received yet).
+        *
+        * @return The number of copied markers (at most capacity).
+        */
+        size_t CopyMarkers(size_t capacity, float* o_x, float* o_y, float* o_z, float* o_size, float* o_residual,
+            int32_t* o_id, int16_t* o_params, int& o_frame);
+
+        /**
+        * Get running statistics of one latency stage.
+        * Host timestamps are converted to local time by the clock 
+        * synchronisation of the NatNet client.
+        *
+        * @param stage   The latency stage.
+        * @param o_stats Returns the statistics of the stage.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool GetLatencyStatistics(LatencyStage stage, tracking::LatencyHistogram::Statistics& o_stats) const;
+
+        /**
+        * Get the histogram of one latency stage.
+        *
+        * @param stage The latency stage.
+        *
+        * @return The histogram of the stage.
+        */
+        inline const tracking::LatencyHistogram& GetLatencyHistogram(LatencyStage stage) const {
+            return this->m_latencies[(stage < LATENCY_STAGE_COUNT) ? (stage) : (ExposureToTransmit)];
+        }
+
+        /**
+        * Reset statistics of all latency stages.
+        */
+        void ResetLatencyStatistics(void);
+
+        /**
+        * Get the frame sequence counters of the current connection.
+        * Duplicate and out of order frames are dropped, the rolling loss
+        * rate is based on gaps in the NatNet frame numbers.
+        *
+        * @param o_stats Returns the counters (reset on connect).
         */
-        glm::vec3 GetPosition(const std::string& rigid_body); 
+        inline void GetStreamStatistics(tracking::FrameSequence::Statistics& o_stats) const {
+            this->m_sequence.GetStatistics(o_stats);
+        }
+
+        /**
+        * Reset the frame sequence counters.
+        */
+        inline void ResetStreamStatistics(void) {
+            this->m_sequence.Reset();
+        }
+
+        /**
+        * Get the failover counters (see Params::standby_servers).
+        * With further servers the counters of the first server are returned.
+        *
+        * @param o_stats Returns the counters.
+        */
+        void GetFailoverStatistics(FailoverStatistics& o_stats) const;
+
+        /**
+        * Get the number of known rigid bodies (handles are 0 to count - 1).
+        * The number only grows, so a change indicates new rigid bodies.
+        *
+        * @return The number of known rigid bodies.
+        */
+        inline size_t GetRigidBodyCount(void) const {
+            return this->m_rigid_body_count.load(std::memory_order_acquire);
+        }
 
         /**
-        * Get all available rigid body names.
+        * Get the name of a rigid body.
+        * Names are never removed, so pointers to the names stay valid.
         *
-        * @return All available rigid body names.
+        * @param rigid_body The rigid body handle (see GetRigidBodyCount()).
+        *
+        * @return The name of the rigid body, nullptr if the handle is unknown.
         */
-        inline std::vector<std::string>& GetRigidBodyNames(void) {
-            return this->m_rigid_body_names;
+        inline const char* GetRigidBodyName(size_t rigid_body) const {
+            return (rigid_body < this->GetRigidBodyCount()) ? (this->m_rigid_body_names[rigid_body].c_str()) : (nullptr);
         }
 
     private:
 
+        /** Unit tests and benchmarks (see test/unit) drive the callbacks directly. */
+        friend class NatNetDevicePoolTest;
+
         /***********************************************************************
         * types and structs
         **********************************************************************/
@@ -123,39 +545,161 @@ namespace tracking{
         /** 
         *  Data structure for rigid bodies. 
         *
-        *  Atomic variables have no copy constructor, therefore class
-        *  can only be used in std:.vector via (shared) pointer.
+        *  All rigid bodies are stored in one contiguous table (see
+        *  m_rigid_bodies) which is indexed by the streaming ID via m_id_table.
+        *  The table index is used as handle of the rigid body.
+        *  Each rigid body starts on its own cache line.
         *
-        *  Mutable data is stored in lock free (triple-)buffer for concurrent 
-        *  access by natnet callback and megamol callback.
+        *  Mutable data is stored in a sequence lock and a history ring for
+        *  concurrent access by natnet callback (single writer) and any 
+        *  number of readers.
         */
-        class RigidBody {
+        class alignas(TRACKING_CACHE_LINE_SIZE) RigidBody {
         public:
-            RigidBody(int id, const std::string& name) 
-                : id(id)
-                , name(name)
-                , read(0)
-                , write(1)
-                , lockFreeData() { 
+            RigidBody(void) 
+                : id(-1)
+                , subscribers(0)
+                , external(false)
+                , read_frame(-1)
+                , data()
+                , history()
+                , predictor() { 
             }
 
-            const int                 id;                // ID of motoin device (never changes)
-            const std::string         name;              // Name of motion device (never changes)
-            std::atomic<unsigned int> read;              // index of readable RigidBodyData
-            std::atomic<unsigned int> write;             // index of writable RigidBodyData
-            RigidBodyData             lockFreeData[3];   // triple buffer of data for one rigid body
+            int                                  id;         // ID of motion device (only changed with m_table_mutex locked, -1 if not streamed)
+            std::atomic<int>                     subscribers;// Number of subscriptions (see SubscribeRigidBody())
+            bool                                 external;   // Data is stored by another device (see AddExternalRigidBody(), only changed while disconnected)
+            std::atomic<int>                     read_frame; // Frame of the latest ReceiveToRead record (-1 for none)
+            tracking::SeqLock<RigidBodyData>     data;       // Latest data of rigid body
+            tracking::HistoryRing<RigidBodyData> history;    // Recent tracked data of rigid body (allocated when rigid body is added)
+            tracking::PosePredictor              predictor;  // Pose prediction fed with tracked data of rigid body
+        };
+
+        /** Server of the priority list (see Params::standby_servers). */
+        struct Server {
+            std::string                          ip;
+            unsigned int                         cmd_port;
+            unsigned int                         data_port;
+            glm::quat                            orientation; // Rotation from server to pool coordinates
+            glm::vec3                            position;    // Origin of the server in pool coordinates
+            bool                                 transform;   // Poses have to be transformed
+        };
+
+        /** 
+        * Description of a skeleton (immutable once published, except the ID set while not receiving). 
+        * Bones are stored in order of the description, order lists the
+        * bone indices so that each parent precedes its children.
+        */
+        struct Skeleton {
+            int                                  id;         // Skeleton ID (-1 if not streamed)
+            std::vector<std::string>             bone_names;
+            std::vector<int>                     parents;    // Index of parent bone (-1 for root)
+            std::vector<int>                     order;      // Bone indices, parents first
+            std::vector<int>                     bone_index; // Bone index by bone ID (-1 if unknown)
+            std::vector<glm::mat4>               offsets;    // Offset of each bone relative to its parent
+        };
+
+        /** 
+        * Entry of the open addressing table mapping streaming IDs to rigid body indices. 
+        * Entries are written before their index is published, and removed 
+        * entries are only marked (ID_REMOVED) until the next reconnect, so
+        * the natnet callback can look up IDs while rigid bodies are added or removed.
+        */
+        struct IdTableEntry {
+            IdTableEntry(void) : id(0), index(ID_EMPTY) { }
+
+            std::atomic<int> id;                         // Streaming ID of rigid body
+            std::atomic<int> index;                      // Index in rigid body table (or ID_EMPTY, ID_REMOVED)
         };
 
+        /** Index of an ID table entry which was never used. */
+        static const int ID_EMPTY = -1;
+
+        /** Index of an ID table entry whose rigid body was removed. */
+        static const int ID_REMOVED = -2;
+
+        /** 
+        * Size of the streaming ID table (power of two, at least twice MAX_RIGIDBODIES). 
+        * Streaming IDs are hashed by their lower bits, so the default IDs 
+        * assigned by Motive (1, 2, 3, ...) end up directly indexed.
+        */
+        static const size_t ID_TABLE_SIZE = 2048;
+
+        /** Number of recent poses kept per rigid body (covers more than 250 ms at 240 Hz). */
+        static const size_t HISTORY_SIZE = 64;
+
+        /** Initial number of frames in the pool of published frames (the pool grows while readers hold all frames, see GetLatestFrame()). */
+        static const size_t FRAME_POOL_SIZE = 16;
+
+        /** Number of attempts of NatNet SDK requests with connect timeout. */
+        static const int SDK_REQUEST_ATTEMPTS = 4;
+
+        /** Minimum time in seconds between two refreshes of the data descriptions. */
+        static constexpr double REFRESH_INTERVAL = 1.0;
+
+        /** Maximum age in seconds of a pose of a source to be merged (older poses count as not tracked). */
+        static constexpr double MERGE_MAX_AGE = 0.1;
+
+        /** Maximum delay in seconds between two reconnect attempts (the delay doubles from the failover timeout). */
+        static constexpr double RECONNECT_DELAY_MAX = 16.0;
+
         /**********************************************************************
         * variables
         **********************************************************************/
 
         bool m_initialised;
-        bool m_connected;
+        std::atomic<bool> m_connected;
+#ifdef TRACKING_NATNET_SDK
         std::unique_ptr<NatNetClient> m_natnet_client;
-        std::vector<std::shared_ptr<RigidBody>> m_rigid_bodies;
+#endif
+        std::unique_ptr<tracking::NatNetNativeClient> m_native_client;
+        tracking::NatNetPacketDecoder m_decoder;
+        tracking::AlignedArray<RigidBody> m_rigid_bodies;
+        std::atomic<size_t> m_rigid_body_count;
+        std::array<IdTableEntry, ID_TABLE_SIZE> m_id_table;
+        size_t m_id_table_used;                          // Number of non empty ID table entries
+        std::mutex m_table_mutex;                        // Serialises changes of the rigid body table
+        std::thread m_refresh_thread;
+        std::mutex m_refresh_mutex;
+        std::condition_variable m_refresh_cv;
+        std::atomic<bool> m_refresh_requested;
+        std::atomic<bool> m_subscription_requested;
+        std::atomic<bool> m_server_subscription;         // Server supports subscriptions (rewritten on failover by the refresh thread, read by subscribers)
+        bool m_refresh_stop;                             // Guarded by m_refresh_mutex
+        tracking::SnapshotPublisher<FrameData> m_frames;
+        std::array<tracking::LatencyHistogram, LATENCY_STAGE_COUNT> m_latencies;
+        std::atomic<int> m_read_frame;                   // Frame of the latest ReceiveToRead record of GetLatestFrame() (-1 for none)
+        tracking::FrameSequence m_sequence;
         int m_callback_counter;
-        std::vector<std::string> m_rigid_body_names;
+        tracking::AlignedArray<std::string> m_rigid_body_names;
+        std::vector<Skeleton> m_skeletons;               // MAX_SKELETONS entries, the first m_skeleton_count are published
+        std::atomic<size_t> m_skeleton_count;
+        std::vector<std::string> m_skeleton_names;       // MAX_SKELETONS entries, the first m_skeleton_count are published
+        std::array<unsigned char, 4> m_server_version;   // NatNet version of the server (changes on connect and failover, connecting thread only)
+        tracking::SessionCache::Contents m_cache;        // Descriptions of the cache file (used by Connect() and the refresh thread)
+        bool m_cache_valid;                              // m_cache was read or written
+        std::vector<std::unique_ptr<NatNetDevicePool>> m_sources; // Pools of all servers if further servers are merged (empty for one server)
+        NatNetDevicePool* m_merge_target;                // Pool merging this source (nullptr if not a source)
+        glm::quat m_source_orientation;                  // Rotation from current server to pool coordinates
+        glm::vec3 m_source_position;                     // Origin of the current server in pool coordinates
+        bool m_source_transform;                         // Poses have to be transformed
+        std::atomic_flag m_merging;                      // A source is merging (serialises all writes of merged data)
+        std::vector<int> m_source_handles;               // Source handle of each rigid body (MAX_RIGIDBODIES x source count, -1 if unknown, see update_sources())
+        std::vector<size_t> m_source_mapped;             // Number of rigid bodies of each source already in m_source_handles
+        double m_merge_time;                             // Exposure time of the latest merged frame
+        int m_merge_frame;                               // Frame number of the latest merged frame
+        std::vector<Server> m_servers;                   // Server of Params and standby servers in order of priority
+        std::atomic<size_t> m_server_index;              // Index of the current server in m_servers
+        double m_connect_time;                           // Time of the latest connection attempt (refresh thread only after connect)
+        double m_failover_begin;                         // Time of the last frame before the pending failover (0 if none, refresh thread only)
+        std::atomic<uint64_t> m_failovers;
+        std::atomic<double> m_failover_latency;
+        std::atomic<double> m_failover_latency_max;
+        std::atomic<bool> m_link_lost;                   // No frames for longer than the failover timeout (latest poses are stale)
+        std::atomic<uint64_t> m_stale_changes;           // Number of changes of the stale flag (see GetRigidBodySequence())
+        tracking::FrameSignal* m_frame_signal;           // Notified with every published frame (nullptr for none)
+        int m_reconnect_attempts;                        // Failed reconnects since the latest frame (refresh thread only)
+        double m_reconnect_time;                         // Earliest time of the next reconnect (refresh thread only)
 
         /** parameters ********************************************************/
 
@@ -184,11 +728,51 @@ namespace tracking{
         */
         NatNetDevicePool::ConnectionType m_con_type;
 
+        /**
+        * Specifies the multicast group (empty for the group announced by the server).
+        */
+        std::string m_multicast_ip;
+
+        /**
+        * Specifies the size of the socket receive buffer in bytes (0 for default).
+        */
+        unsigned int m_receive_buffer_size;
+
         /**
         * If 'true' message NatNet log callback is set.
         */
         bool m_verbose_client;
 
+        /**
+        * If 'true' the built-in NatNet client is used.
+        */
+        bool m_use_native_client;
+
+        /**
+        * Specifies the pose prediction.
+        */
+        tracking::PosePredictor::Params m_prediction;
+
+        /**
+        * If 'true' only rigid bodies with subscribers are processed.
+        */
+        bool m_subscription;
+
+        /**
+        * Specifies the timeout of each request to the server while connecting in seconds (0 for default).
+        */
+        float m_connect_timeout;
+
+        /**
+        * Specifies the file caching the data descriptions (empty to disable).
+        */
+        std::string m_cache_file;
+
+        /**
+        * Specifies the time without frames in seconds before reconnecting, to the next server if any (0 to disable).
+        */
+        float m_failover_timeout;
+
         /**********************************************************************
         * functions
         **********************************************************************/
@@ -196,6 +780,342 @@ namespace tracking{
         /** Print used parameter values. */
         void print_params(void);
 
+        /**
+        * Add rigid body to table and streaming ID lookup.
+        * A rigid body with a known name keeps its table index.
+        *
+        * @param id    The streaming ID of the rigid body.
+        * @param name  The name of the rigid body.
+        * @param reset Reconfigure the predictor of a known rigid body (its latest pose is kept).
+        *
+        * @return True on success, false otherwise.
+        */
+        bool add_rigid_body(int id, const std::string& name, bool reset);
+
+        /**
+        * Load the cache file and add its rigid bodies and skeletons to the tables.
+        *
+        * @return True on success, false if the cache is disabled, missing or belongs to another server.
+        */
+        bool load_cache(void);
+
+        /**
+        * Write the cache file if the descriptions differ from the cached ones.
+        *
+        * @param rigid_bodies The rigid body descriptions.
+        * @param skeletons    The skeleton descriptions.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool save_cache(const std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& rigid_bodies,
+            const std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& skeletons);
+
+        /**
+        * Append a rigid body with unknown streaming ID to the table.
+        *
+        * @param name The name of the rigid body.
+        *
+        * @return The index in the rigid body table, -1 if the table is full.
+        */
+        int append_rigid_body(const std::string& name);
+
+        /**
+        * Connect to one server of the priority list and start receiving.
+        * The client is closed again on failure.
+        *
+        * @param index The index in m_servers.
+        * @param reset Reconfigure the predictors of known rigid bodies (false keeps them on failover).
+        *
+        * @return True on success, false otherwise.
+        */
+        bool open_server(size_t index, bool reset);
+
+        /** Stop receiving and close the client. */
+        void close_server(void);
+
+        /**
+        * Check the time since the latest frame and record the latency of a pending failover (refresh thread only).
+        *
+        * @return True if the server was silent for longer than the failover timeout and the backoff delay has passed, false otherwise.
+        */
+        bool check_failover(void);
+
+        /** Switch to the next responding server of the priority list, or reconnect the only server (refresh thread only). */
+        void failover(void);
+
+        /**
+        * Check whether the latest poses are stale.
+        *
+        * @return True if not connected or the link to the server (to all merged servers) is lost, false otherwise.
+        */
+        bool is_stale(void) const;
+
+        /**
+        * Connect all sources (pools of merged servers).
+        *
+        * @return True on success, false otherwise.
+        */
+        bool connect_sources(void);
+
+        /**
+        * Add the rigid bodies of all sources to the table (m_table_mutex is held and merged data is locked, see m_merging).
+        */
+        void map_sources(void);
+
+        /**
+        * Lock the table and the merged data and add new rigid bodies of all sources
+        * (called by the sources after their table changed, so merging never changes the table).
+        */
+        void update_sources(void);
+
+        /**
+        * Merge the latest data of all sources into the table and publish a frame
+        * (called from natnet callback of any source, returns at once if another source is merging).
+        *
+        * @param time The exposure time in local time to merge the poses at.
+        */
+        void merge_sources(double time);
+
+        /**
+        * Remove rigid body from streaming ID lookup.
+        * Name and table index are kept.
+        *
+        * @param index The index in the rigid body table.
+        */
+        void remove_rigid_body(size_t index);
+
+        /**
+        * Retrieve the data descriptions from the server.
+        *
+        * @param o_rigid_bodies Returns the rigid body descriptions.
+        * @param o_skeletons    Returns the skeleton descriptions.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool fetch_descriptions(std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& o_rigid_bodies,
+            std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& o_skeletons);
+
+        /** 
+        * Loop of the refresh thread, refreshes the rigid bodies (see request_refresh()) 
+        * and the subscriptions of the server on request.
+        */
+        void refresh(void);
+
+        /**
+        * Replace the subscriptions of the server by the rigid bodies with subscribers.
+        * On failure all data is subscribed again and subscriptions are disabled
+        * until the next connection (consumers filter locally), further calls
+        * only restore all data.
+        *
+        * @return True if the server streams the subscribed or all data, false if restoring all data failed (retried by the refresh thread).
+        */
+        bool update_subscriptions(void);
+
+        /**
+        * Request a refresh of the data descriptions (called from natnet callback only).
+        */
+        inline void request_refresh(void) {
+            if (!this->m_refresh_requested.exchange(true, std::memory_order_relaxed)) {
+                this->m_refresh_cv.notify_one();
+            }
+        }
+
+        /**
+        * Add skeleton to table.
+        * A skeleton with a known name keeps its table index and bones (see map_skeleton()).
+        *
+        * @param description The skeleton description.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool add_skeleton(const tracking::NatNetPacketDecoder::SkeletonDescription& description);
+
+        /**
+        * Map the skeleton ID of a description to a known skeleton with the
+        * same name and bones without changing the skeleton table (consumers
+        * read the table without lock).
+        *
+        * @param description The skeleton description.
+        *
+        * @return True on success, false if the skeleton is unknown or its bones differ.
+        */
+        bool map_skeleton(const tracking::NatNetPacketDecoder::SkeletonDescription& description);
+
+        /**
+        * Look up the table index of a skeleton by its ID (few skeletons, linear search).
+        *
+        * @param id The skeleton ID.
+        *
+        * @return The index in the skeleton table, -1 if ID is unknown.
+        */
+        inline int find_skeleton(int id) const {
+            size_t count = this->m_skeleton_count.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i) {
+                if (this->m_skeletons[i].id == id) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        /** 
+        * Remove all rigid bodies and skeletons from streaming ID lookup.
+        * Names and table indices are kept.
+        */
+        void unmap_rigid_bodies(void);
+
+        /**
+        * Look up the table index of a rigid body by its streaming ID.
+        *
+        * @param id The streaming ID of the rigid body.
+        *
+        * @return The index in the rigid body table, -1 if ID is unknown.
+        */
+        inline int find_rigid_body(int id) const {
+            size_t h = static_cast<size_t>(id) & (ID_TABLE_SIZE - 1);
+            for (size_t i = 0; i < ID_TABLE_SIZE; ++i) {
+                int index = this->m_id_table[h].index.load(std::memory_order_acquire);
+                if (index == ID_EMPTY) {
+                    break;
+                }
+                if ((index >= 0) && (this->m_id_table[h].id.load(std::memory_order_relaxed) == id)) {
+                    return index;
+                }
+                h = (h + 1) & (ID_TABLE_SIZE - 1);
+            }
+            return -1;
+        }
+
+        /**
+        * Look up the table index of a rigid body by its name.
+        *
+        * @param name The name of the rigid body.
+        *
+        * @return The index in the rigid body table, -1 if name is unknown.
+        */
+        int find_rigid_body(const std::string& name) const;
+
+        /**
+        * Connect with the built-in NatNet client.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool connect_native(void);
+
+        /**
+        * Start writing a frame (called from natnet callback only).
+        * Records the latencies of the frame.
+        *
+        * @param frame         The NatNet frame number.
+        * @param timestamp     The NatNet software timestamp.
+        * @param exposure_time The mid exposure time in local time (0 if unknown).
+        * @param transmit_time The transmit time in local time (0 if unknown).
+        * @param receive_time  The receive time in local time.
+        * @param o_data        Returns the rigid body data with frame number and times set.
+        *
+        * @return The frame to write, nullptr if all frames are held by readers.
+        */
+        FrameData* begin_frame(int frame, double timestamp, double exposure_time, double transmit_time, double receive_time, RigidBodyData& o_data);
+
+        /**
+        * Write data of one tracked rigid body (called from natnet callback only).
+        * Unknown streaming IDs request a refresh of the data descriptions.
+        *
+        * @param frame The frame returned by begin_frame() (may be nullptr).
+        * @param id    The streaming ID of the rigid body.
+        * @param data  The data of the rigid body.
+        */
+        void write_rigid_body(FrameData* frame, int id, const RigidBodyData& data);
+
+        /**
+        * Store data of one rigid body (called from natnet callback only).
+        *
+        * @param frame The frame returned by begin_frame() (may be nullptr).
+        * @param index The index in the rigid body table.
+        * @param data  The data of the rigid body.
+        */
+        void store_rigid_body(FrameData* frame, int index, const RigidBodyData& data);
+
+        /**
+        * Append one marker to the frame (called from natnet callback only).
+        *
+        * @param frame    The frame returned by begin_frame() (may be nullptr).
+        * @param id       The marker ID.
+        * @param position The marker position.
+        * @param size     The marker size.
+        * @param params   The marker flags.
+        * @param residual The marker residual.
+        */
+        inline void write_marker(FrameData* frame, int32_t id, const glm::vec3& position, float size, int16_t params, float residual) {
+            if ((frame == nullptr) || (frame->markers.count >= MAX_LABELED_MARKERS)) {
+                return;
+            }
+            MarkerData& m = frame->markers;
+            m.x[m.count]        = position.x;
+            m.y[m.count]        = position.y;
+            m.z[m.count]        = position.z;
+            m.size[m.count]     = size;
+            m.residual[m.count] = residual;
+            m.id[m.count]       = id;
+            m.params[m.count]   = params;
+            m.count++;
+        }
+
+        /**
+        * Start writing the bones of a skeleton (called from natnet callback only).
+        * All bones are reset to their offset relative to the parent.
+        *
+        * @param frame The frame returned by begin_frame() (may be nullptr).
+        * @param id    The skeleton ID.
+        *
+        * @return The skeleton index, -1 if the skeleton is unknown or frame is nullptr.
+        */
+        int begin_skeleton(FrameData* frame, int id);
+
+        /**
+        * Write the local transform of one bone (called from natnet callback only).
+        *
+        * @param frame       The frame returned by begin_frame().
+        * @param skeleton    The skeleton index returned by begin_skeleton().
+        * @param id          The bone ID (lower 16 bits are used).
+        * @param position    The position relative to the parent.
+        * @param orientation The orientation relative to the parent.
+        */
+        void write_bone(FrameData* frame, int skeleton, int id, const glm::vec3& position, const glm::quat& orientation);
+
+        /**
+        * Compose world transforms of all bones of a skeleton (called from natnet callback only).
+        *
+        * @param frame    The frame returned by begin_frame().
+        * @param skeleton The skeleton index returned by begin_skeleton().
+        */
+        void end_skeleton(FrameData* frame, int skeleton);
+
+        /**
+        * Publish frame (called from natnet callback only).
+        *
+        * @param frame The frame returned by begin_frame() (may be nullptr).
+        */
+        void end_frame(FrameData* frame);
+
+        /**
+        * Built-in NatNet client callback for frames.
+        *
+        * @param payload      The frame payload.
+        * @param size         The size of the payload.
+        * @param receive_time The local receive time.
+        * @param pUserData    Pointer to class which registered callback (that).
+        */
+        static void __cdecl on_packet(const char* payload, size_t size, double receive_time, void* pUserData);
+
+#ifdef TRACKING_NATNET_SDK
+        /**
+        * Connect with the NatNet SDK.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool connect_sdk(void);
+
         /**
         * NatNet client callback for data.
         *
@@ -211,6 +1131,7 @@ namespace tracking{
         * @param message The message.
         */
         static void __cdecl on_message(Verbosity level, const char *message);
+#endif
         
     };
 
@@ -0,0 +1,258 @@
+/**
+ * NatNetNativeClient.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_NATNETNATIVECLIENT_H_INCLUDED
+#define TRACKING_NATNETNATIVECLIENT_H_INCLUDED
+
+#include "stdafx.h"
+#include "NatNetPacketDecoder.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Built-in NatNet client which talks to Motive directly via UDP sockets
+    * (no NatNet SDK required, also available on Linux).
+    *
+    * Handles the command channel (connect, model definitions, keep alive and
+    * clock synchronisation) and receives frames on the data socket in a
+    * separate thread. On Linux, frames are received in batches (recvmmsg).
+    * Received frame packets are handed to the frame callback directly from
+    * the receive buffer without copying.
+    *
+    ***************************************************************************/
+    class NatNetNativeClient {
+
+    public:
+
+        /**
+        * Callback for received frames.
+        *
+        * @param payload      The payload of the NAT_FRAMEOFDATA packet (only valid during the callback).
+        * @param size         The size of the payload.
+        * @param receive_time The local time (see GetLocalTime()) the packet was received.
+        * @param user_data    The user data given to Start().
+        */
+        typedef void (__cdecl *FrameCallback)(const char* payload, size_t size, double receive_time, void* user_data);
+
+        /** Data structure for setting parameters as batch. */
+        struct Params {
+            std::string                      local_address;      /** The local IP address (also selects the interface for multicast). */
+            std::string                      server_address;     /** The IP address of the NatNet server. */
+            uint16_t                         command_port;       /** The NatNet command port of the server. */
+            uint16_t                         data_port;          /** The NatNet data port of the server. */
+            bool                             multicast;          /** Receive data via multicast instead of unicast (must match server). */
+            std::string                      multicast_address;  /** The multicast group (empty for the group announced by the server). */
+            size_t                           receive_buffer_size;/** The size of the socket receive buffer in bytes (0 for default). */
+            double                           timeout;            /** The timeout of each request to the server in seconds including retries (0 for default). */
+        };
+
+#ifdef _WIN32
+        typedef SOCKET SocketType;
+#else
+        typedef int SocketType;
+#endif
+
+        /** Number of packets received at once (recvmmsg). */
+        static const size_t RECEIVE_BATCH_SIZE = 16;
+
+        /** Size of one receive buffer (maximal UDP payload). */
+        static const size_t RECEIVE_BUFFER_SIZE = 65536;
+
+        /** Default multicast group of Motive. */
+        static const char* const DEFAULT_MULTICAST_ADDRESS;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        NatNetNativeClient(void);
+
+        /**
+        * DTOR
+        */
+        ~NatNetNativeClient(void);
+
+        NatNetNativeClient(const NatNetNativeClient&) = delete;
+        NatNetNativeClient& operator=(const NatNetNativeClient&) = delete;
+
+        /**
+        * Open sockets and request server info.
+        * In multicast mode the data socket joins the multicast group, so
+        * any number of clients can receive one stream.
+        *
+        * @param params   The connection parameters.
+        * @param o_server Returns the server info.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool Connect(const NatNetNativeClient::Params& params, sSender_Server& o_server);
+
+        /**
+        * Request model definitions.
+        * After Start() the response is picked up by the receive thread, so
+        * model definitions can also be requested while frames are received.
+        *
+        * @param o_payload Returns the payload of the NAT_MODELDEF response.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool RequestModelDef(std::vector<char>& o_payload);
+
+        /**
+        * Send a command string to the server (e.g. "SubscribeToData,RigidBody,All").
+        * Can be called before and after Start() (see RequestModelDef()).
+        *
+        * @param command    The command.
+        * @param o_response Returns the payload of the NAT_RESPONSE message.
+        *
+        * @return True if the server responded, false if the command is unknown or on timeout.
+        */
+        bool SendCommand(const std::string& command, std::vector<char>& o_response);
+
+        /**
+        * Start receiving frames.
+        *
+        * @param callback  The frame callback (called from receive thread).
+        * @param user_data The user data passed to the callback.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool Start(FrameCallback callback, void* user_data);
+
+        /**
+        * Stop receiving frames and close sockets.
+        */
+        void Disconnect(void);
+
+        /**
+        * Convert host high resolution clock ticks to local time.
+        *
+        * @param ticks The host timestamp.
+        *
+        * @return The local time (see GetLocalTime()), 0 if clocks are not synchronised yet.
+        */
+        double HostToLocalTime(uint64_t ticks) const;
+
+        /**
+        * Check whether host and local clock are synchronised.
+        *
+        * @return True if HostToLocalTime() can be used.
+        */
+        inline bool IsClockSynchronised(void) const {
+            return this->m_clock_synchronised.load(std::memory_order_acquire);
+        }
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        SocketType                       m_command_socket;
+        SocketType                       m_data_socket;
+        sockaddr_in                      m_server_address;       // Command address of server
+        bool                             m_multicast;            // Data is received via multicast (no keep alive required)
+        double                           m_response_timeout;     // Timeout of one request attempt in seconds
+        std::thread                      m_thread;
+        std::atomic<bool>                m_running;
+        FrameCallback                    m_callback;
+        void*                            m_user_data;
+        uint64_t                         m_clock_frequency;      // Host clock ticks per second
+        std::atomic<double>              m_clock_offset;         // Local time minus host time in seconds
+        std::atomic<bool>                m_clock_synchronised;
+        double                           m_clock_rtt;            // Round trip time of the current clock offset (only used by receive thread)
+        std::vector<char>                m_buffers;              // Receive buffers (RECEIVE_BATCH_SIZE * RECEIVE_BUFFER_SIZE)
+        std::mutex                       m_response_mutex;
+        std::condition_variable          m_response_cv;
+        std::vector<char>                m_response;             // Payload of the response received by the receive thread
+        uint16_t                         m_response_message;     // Expected response, replaced by the received message (guarded by m_response_mutex)
+        bool                             m_response_ready;       // Guarded by m_response_mutex
+
+        /**********************************************************************
+        * functions
+        **********************************************************************/
+
+        /** Receive loop of the receive thread. */
+        void receive(void);
+
+        /**
+        * Send a message to the command port of the server.
+        *
+        * @param socket  The socket to send from.
+        * @param message The message ID.
+        * @param payload The payload.
+        * @param size    The size of the payload.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool send_message(SocketType socket, uint16_t message, const void* payload, size_t size);
+
+        /**
+        * Send a request to the command port of the server and wait for the response.
+        *
+        * @param message   The request message ID.
+        * @param payload   The request payload.
+        * @param size      The size of the request payload.
+        * @param response  The expected response message ID.
+        * @param o_payload Returns the payload of the response.
+        *
+        * @return True for success, false if the request is unrecognized or on timeout.
+        */
+        bool request(uint16_t message, const void* payload, size_t size, uint16_t response, std::vector<char>& o_payload);
+
+        /**
+        * Wait for a message on the command socket (before Start() only).
+        *
+        * @param message   The expected message ID.
+        * @param timeout   The timeout in seconds.
+        * @param o_payload Returns the payload.
+        *
+        * @return True for success, false on timeout.
+        */
+        bool wait_for_message(uint16_t message, double timeout, std::vector<char>& o_payload);
+
+        /**
+        * Handle a message received on the command socket.
+        *
+        * @param packet       The packet.
+        * @param size         The size of the packet.
+        * @param receive_time The local receive time.
+        */
+        void on_command(const char* packet, size_t size, double receive_time);
+
+        /**
+        * Wait until one of the sockets is readable.
+        *
+        * @param timeout          The timeout in seconds.
+        * @param command_only     Only wait for the command socket (the data socket is not read).
+        * @param o_data_ready     Returns whether the data socket is readable.
+        * @param o_command_ready  Returns whether the command socket is readable.
+        *
+        * @return True for success, false on error.
+        */
+        bool wait_readable(double timeout, bool command_only, bool& o_data_ready, bool& o_command_ready);
+
+        /**
+        * Open the data socket (unicast or multicast).
+        *
+        * @param params The connection parameters.
+        * @param server The server info.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool open_data_socket(const NatNetNativeClient::Params& params, const sSender_Server& server);
+
+        /** Close a socket. */
+        static void close_socket(SocketType& socket);
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_NATNETNATIVECLIENT_H_INCLUDED */
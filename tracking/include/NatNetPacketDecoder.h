@@ -0,0 +1,266 @@
+/**
+ * NatNetPacketDecoder.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_NATNETPACKETDECODER_H_INCLUDED
+#define TRACKING_NATNETPACKETDECODER_H_INCLUDED
+
+#include "stdafx.h"
+#include "NatNetTypes.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Decodes NatNet packets (NatNet 3.0 and later) as sent by Motive.
+    *
+    * Frames are decoded in place: DecodeFrame() only locates the data
+    * sections in the received packet, records (e.g. rigid bodies) are read
+    * directly from the packet by the caller. Nothing is copied or allocated.
+    * Packets are expected in little endian byte order.
+    *
+    ***************************************************************************/
+    class NatNetPacketDecoder {
+
+    public:
+
+        /** Size of one rigid body record in a frame (ID, position, orientation, mean error, params). */
+        static const size_t RIGID_BODY_SIZE = 38;
+
+        /** Size of one labeled marker record in a frame (ID, position, size, params, residual). */
+        static const size_t LABELED_MARKER_SIZE = 26;
+
+        /** One rigid body record of a frame. */
+        struct RigidBody {
+            int32_t                          id;             /** The streaming ID. */
+            glm::vec3                        position;
+            glm::quat                        orientation;
+            float                            mean_error;     /** The mean marker error. */
+            int16_t                          params;         /** Tracking flags (bit 0: tracking valid). */
+        };
+
+        /** One labeled marker record of a frame. */
+        struct LabeledMarker {
+            int32_t                          id;             /** The model ID (upper 16 bits) and marker ID (lower 16 bits). */
+            glm::vec3                        position;
+            float                            size;
+            int16_t                          params;         /** Marker flags (e.g. 0x01 occluded, 0x10 unlabeled). */
+            float                            residual;       /** The mean ray error. */
+        };
+
+        /** Sections of one frame, pointing into the decoded packet. */
+        struct Frame {
+            int32_t                          frame;                      /** The frame number. */
+            const char*                      rigid_bodies;               /** The rigid body records (see ReadRigidBody()). */
+            int32_t                          rigid_body_count;
+            const char*                      skeletons;                  /** The skeleton records (see ReadSkeleton()). */
+            int32_t                          skeleton_count;
+            const char*                      labeled_markers;            /** The labeled marker records. */
+            int32_t                          labeled_marker_count;
+            double                           timestamp;                  /** The software timestamp (seconds since start of host software). */
+            uint64_t                         mid_exposure_timestamp;     /** Host high resolution clock ticks. */
+            uint64_t                         data_received_timestamp;    /** Host high resolution clock ticks. */
+            uint64_t                         transmit_timestamp;         /** Host high resolution clock ticks. */
+            int16_t                          params;                     /** Frame flags (bit 0: recording, bit 1: tracked models changed). */
+        };
+
+        /** Description of one rigid body. */
+        struct RigidBodyDescription {
+            std::string                      name;
+            int32_t                          id;             /** The streaming ID. */
+            int32_t                          parent_id;      /** The ID of the parent (-1 if none). */
+            glm::vec3                        offset;         /** The offset relative to the parent. */
+        };
+
+        /** Description of one skeleton. */
+        struct SkeletonDescription {
+            std::string                      name;
+            int32_t                          id;             /** The skeleton ID. */
+            std::vector<RigidBodyDescription> bones;         /** The bones (ID and parent ID are bone IDs of this skeleton). */
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        NatNetPacketDecoder(void);
+
+        /**
+        * Set NatNet version of the server, which defines the packet layout.
+        *
+        * @param major The major version.
+        * @param minor The minor version.
+        *
+        * @return True for success, false if the version is not supported.
+        */
+        bool SetVersion(int major, int minor);
+
+        /**
+        * Split packet into message ID and payload.
+        *
+        * @param packet         The received packet.
+        * @param size           The size of the received packet.
+        * @param o_message      Returns the message ID (e.g. NAT_FRAMEOFDATA).
+        * @param o_payload      Returns the payload.
+        * @param o_payload_size Returns the size of the payload.
+        *
+        * @return True for success, false if the packet is truncated.
+        */
+        static bool DecodeHeader(const char* packet, size_t size, uint16_t& o_message, const char*& o_payload, size_t& o_payload_size);
+
+        /**
+        * Decode server info (payload of NAT_SERVERINFO).
+        *
+        * @param payload  The payload.
+        * @param size     The size of the payload.
+        * @param o_server Returns the server info.
+        *
+        * @return True for success, false otherwise.
+        */
+        static bool DecodeServerInfo(const char* payload, size_t size, sSender_Server& o_server);
+
+        /**
+        * Locate sections of a frame (payload of NAT_FRAMEOFDATA).
+        *
+        * @param payload The payload, must stay valid as long as the frame is used.
+        * @param size    The size of the payload.
+        * @param o_frame Returns the frame.
+        *
+        * @return True for success, false if the payload is malformed.
+        */
+        bool DecodeFrame(const char* payload, size_t size, Frame& o_frame) const;
+
+        /**
+        * Read one rigid body record.
+        *
+        * @param record The record (e.g. Frame::rigid_bodies + i * RIGID_BODY_SIZE).
+        * @param o_rb   Returns the rigid body.
+        */
+        static void ReadRigidBody(const char* record, RigidBody& o_rb);
+
+        /**
+        * Read the header of one skeleton record.
+        * The bone records (rigid body records with the skeleton ID in the
+        * upper and the bone ID in the lower 16 bits of the ID) follow the
+        * header, the next skeleton record follows the bone records.
+        *
+        * @param record       The record (e.g. Frame::skeletons).
+        * @param o_id         Returns the skeleton ID.
+        * @param o_bone_count Returns the number of bone records.
+        *
+        * @return The first bone record.
+        */
+        static const char* ReadSkeleton(const char* record, int32_t& o_id, int32_t& o_bone_count);
+
+        /**
+        * Read one labeled marker record.
+        *
+        * @param record   The record (e.g. Frame::labeled_markers + i * LABELED_MARKER_SIZE).
+        * @param o_marker Returns the marker.
+        */
+        static void ReadLabeledMarker(const char* record, LabeledMarker& o_marker);
+
+        /**
+        * Decode rigid body and skeleton descriptions (payload of NAT_MODELDEF).
+        * Descriptions of other types are skipped.
+        *
+        * @param payload        The payload.
+        * @param size           The size of the payload.
+        * @param o_rigid_bodies Returns the rigid body descriptions.
+        * @param o_skeletons    Returns the skeleton descriptions.
+        *
+        * @return True for success, false if the payload is malformed.
+        */
+        bool DecodeModelDef(const char* payload, size_t size, std::vector<RigidBodyDescription>& o_rigid_bodies,
+            std::vector<SkeletonDescription>& o_skeletons) const;
+
+    private:
+
+        /**********************************************************************
+        * types and structs
+        **********************************************************************/
+
+        /** Bounds checked sequential reading of a payload. */
+        class Reader {
+        public:
+            Reader(const char* data, size_t size) : m_pos(data), m_end(data + size), m_ok(true) { }
+
+            template <class T> inline T Read(void) {
+                T value = T();
+                if (this->Skip(sizeof(T))) {
+                    std::memcpy(&value, this->m_pos - sizeof(T), sizeof(T));
+                }
+                return value;
+            }
+            inline int32_t ReadCount(void) {
+                int32_t count = this->Read<int32_t>();
+                if (count < 0) {
+                    this->m_ok = false;  // Negative counts and sizes are malformed
+                    return 0;
+                }
+                return count;
+            }
+            inline bool Skip(size_t bytes) {
+                if (!this->m_ok || (static_cast<size_t>(this->m_end - this->m_pos) < bytes)) {
+                    this->m_ok = false;
+                    return false;
+                }
+                this->m_pos += bytes;
+                return true;
+            }
+            inline const char* ReadString(void) {
+                const char* str = this->m_pos;
+                const void* term = (this->m_ok) ? (std::memchr(this->m_pos, '\0', static_cast<size_t>(this->m_end - this->m_pos))) : (nullptr);
+                if (term == nullptr) {
+                    this->m_ok = false;
+                    return "";
+                }
+                this->m_pos = static_cast<const char*>(term) + 1;
+                return str;
+            }
+            inline void Fail(void) { this->m_ok = false; }
+            inline const char* Position(void) const { return this->m_pos; }
+            inline bool Ok(void) const { return this->m_ok; }
+
+        private:
+            const char* m_pos;
+            const char* m_end;
+            bool        m_ok;
+        };
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        int  m_major;
+        int  m_minor;
+        bool m_section_sizes;    // NatNet 4.1+ prefixes each data section with its size in bytes
+
+        /**********************************************************************
+        * functions
+        **********************************************************************/
+
+        /**
+        * Skip one section of analog data (force plates or devices).
+        *
+        * @param reader The reader positioned at the section.
+        */
+        void skip_analog_section(Reader& reader) const;
+
+        /**
+        * Read one rigid body description.
+        *
+        * @param reader The reader positioned at the description.
+        * @param o_rb   Returns the description.
+        */
+        void read_rigid_body_description(Reader& reader, RigidBodyDescription& o_rb) const;
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_NATNETPACKETDECODER_H_INCLUDED */
@@ -0,0 +1,173 @@
+/**
+ * PosePredictor.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_POSEPREDICTOR_H_INCLUDED
+#define TRACKING_POSEPREDICTOR_H_INCLUDED
+
+#include "stdafx.h"
+#include "SeqLock.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Predicts the pose of one rigid body to a time in the near future (e.g.
+    * the time the rendered frame is displayed) to compensate latency.
+    *
+    * The position is filtered by a Kalman filter with constant velocity or
+    * constant acceleration model (all axes share one covariance, since they
+    * share time steps and noise). The orientation is extrapolated with the
+    * smoothed angular velocity. Update() costs O(1) per frame and is called
+    * by a single writer, Predict() can be called by any number of threads
+    * at any time (also while the writer calls Configure()).
+    *
+    ***************************************************************************/
+    class PosePredictor {
+
+    public:
+
+        /** Supported motion models. */
+        enum Model {
+            None                 = 0,    /** Prediction disabled, latest pose is returned. */
+            ConstantVelocity     = 1,
+            ConstantAcceleration = 2
+        };
+
+        /** Data structure for setting parameters as batch. */
+        struct Params {
+            PosePredictor::Model             model;              /** The motion model. */
+            float                            horizon;            /** Maximal prediction time in seconds (predictions further ahead are clamped). */
+            float                            process_noise;      /** Spectral density of the unmodeled motion (acceleration resp. jerk) in m^2/s^3 resp. m^2/s^5. */
+            float                            measurement_noise;  /** Variance of the measured position in m^2. */
+        };
+
+        /** One recorded pose of a trace (see EvaluateTrace()). */
+        struct Sample {
+            double                           time;               /** The time of the pose in seconds. */
+            glm::vec3                        position;
+            glm::quat                        orientation;
+        };
+
+        /** Prediction error for one horizon (see EvaluateTrace()). */
+        struct Error {
+            float                            horizon;            /** The prediction horizon in seconds. */
+            float                            position_rms;       /** Root mean square position error in m. */
+            float                            angle_rms;          /** Root mean square orientation error in radians. */
+            size_t                           count;              /** Number of evaluated predictions. */
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        PosePredictor(void);
+
+        PosePredictor(const PosePredictor&) = delete;
+        PosePredictor& operator=(const PosePredictor&) = delete;
+
+        /**
+        * Set parameters and reset filter (single writer only, the
+        * parameters used by Predict() are published with the state).
+        *
+        * @param params The parameters.
+        */
+        void Configure(const PosePredictor::Params& params);
+
+        /**
+        * Reset filter, e.g. after tracking was lost (single writer only).
+        */
+        void Reset(void);
+
+        /**
+        * Feed measured pose (single writer only).
+        *
+        * @param position    The measured position.
+        * @param orientation The measured orientation.
+        * @param time        The time of the measurement in seconds (e.g. local exposure time).
+        */
+        void Update(const glm::vec3& position, const glm::quat& orientation, double time);
+
+        /**
+        * Predict pose to the given time.
+        *
+        * @param time          The time to predict the pose to (same time base as Update()).
+        * @param o_position    Returns the predicted position.
+        * @param o_orientation Returns the predicted orientation.
+        *
+        * @return True for success, false if no pose was fed yet.
+        */
+        bool Predict(double time, glm::vec3& o_position, glm::quat& o_orientation) const;
+
+        /**
+        * Get parameters (single writer only).
+        *
+        * @return The parameters.
+        */
+        inline const PosePredictor::Params& GetParams(void) const {
+            return this->m_params;
+        }
+
+        /**
+        * Replay a recorded trace and measure the prediction error for the
+        * given horizons against the recorded poses (interpolated).
+        *
+        * @param trace    The recorded poses ordered by time.
+        * @param params   The predictor parameters.
+        * @param horizons The prediction horizons in seconds.
+        * @param warmup   The time in seconds from the start of the trace without evaluation (the filter starts at rest).
+        * @param o_errors Returns the error per horizon.
+        *
+        * @return True for success, false otherwise.
+        */
+        static bool EvaluateTrace(const std::vector<PosePredictor::Sample>& trace, const PosePredictor::Params& params,
+            const std::vector<float>& horizons, double warmup, std::vector<PosePredictor::Error>& o_errors);
+
+    private:
+
+        /**********************************************************************
+        * types and structs
+        **********************************************************************/
+
+        /** Filtered state published to readers (with the parameters of the prediction, so readers never access m_params). */
+        struct State {
+            PosePredictor::Model             model;
+            float                            horizon;
+            glm::vec3                        position;
+            glm::vec3                        velocity;
+            glm::vec3                        acceleration;
+            glm::quat                        orientation;
+            glm::vec3                        angular_velocity;   // Axis scaled by angular speed (rad/s)
+            double                           time;               // Time of the state (negative if no pose was fed yet)
+        };
+
+        /** Time gap in seconds after which the filter is reset. */
+        static const double MAX_GAP;
+
+        /** Weight of the latest angular velocity in the smoothed angular velocity. */
+        static const float ANGULAR_SMOOTHING;
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        PosePredictor::Params            m_params;               // Only used by writer (see State)
+        tracking::SeqLock<State>         m_published;
+
+        /** filter state (only used by writer) *******************************/
+
+        std::array<glm::dvec3, 3>        m_x;                    // Position, velocity and acceleration
+        std::array<double, 9>            m_p;                    // Covariance (row major, shared by all axes)
+        glm::quat                        m_orientation;
+        glm::vec3                        m_angular_velocity;
+        double                           m_time;                 // Time of last update (negative if no pose was fed yet)
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_POSEPREDICTOR_H_INCLUDED */
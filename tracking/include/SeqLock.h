@@ -0,0 +1,137 @@
+/**
+ * SeqLock.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_SEQLOCK_H_INCLUDED
+#define TRACKING_SEQLOCK_H_INCLUDED
+
+#include "stdafx.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Sequence lock for one value written by a single thread and read by any
+    * number of threads.
+    *
+    * The writer never waits. Readers never block the writer, they only
+    * retry while a write is in progress, so every read returns a value
+    * which was completely written by one Store() call (no torn reads).
+    * The value is held in atomic words, thus T must be bitwise copyable.
+    *
+    ***************************************************************************/
+    template <class T> class SeqLock {
+
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type (the value is copied bitwise).");
+
+    public:
+
+        /**
+        * CTOR
+        */
+        SeqLock(void);
+
+        /**
+        * Store new value (single writer only).
+        *
+        * @param value The new value.
+        */
+        void Store(const T& value);
+
+        /**
+        * Load the latest completely written value.
+        *
+        * @param o_value Returns the value.
+        */
+        void Load(T& o_value) const;
+
+        /**
+        * Get the current sequence number.
+        * The sequence number is even if no write is in progress and is
+        * increased by two with every Store() call.
+        *
+        * @return The current sequence number.
+        */
+        inline unsigned int GetSequence(void) const {
+            return this->m_sequence.load(std::memory_order_acquire);
+        }
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        static const size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        std::atomic<unsigned int>                     m_sequence;
+        std::array<std::atomic<uint64_t>, WORD_COUNT> m_words;
+
+    };
+
+} /** end namespace tracking */
+
+
+/// Template classes must be declared AND defined in the header file.
+
+
+template <class T>
+tracking::SeqLock<T>::SeqLock(void)
+    : m_sequence(0) {
+
+    for (auto& w : this->m_words) {
+        w.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+template <class T>
+void tracking::SeqLock<T>::Store(const T& value) {
+
+    uint64_t words[WORD_COUNT] = { 0 };
+    std::memcpy(words, &value, sizeof(T));
+
+    // Odd sequence number marks write in progress.
+    unsigned int seq = this->m_sequence.load(std::memory_order_relaxed);
+    this->m_sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+        this->m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    this->m_sequence.store(seq + 2, std::memory_order_release);
+}
+
+
+template <class T>
+void tracking::SeqLock<T>::Load(T& o_value) const {
+
+    uint64_t words[WORD_COUNT];
+    unsigned int seq_begin = 0;
+    unsigned int seq_end   = 0;
+
+    do {
+        seq_begin = this->m_sequence.load(std::memory_order_acquire);
+        while ((seq_begin & 1) != 0) {
+            // Write in progress, which takes only a few nanoseconds.
+            std::this_thread::yield();
+            seq_begin = this->m_sequence.load(std::memory_order_acquire);
+        }
+
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            words[i] = this->m_words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        seq_end = this->m_sequence.load(std::memory_order_relaxed);
+    } while (seq_begin != seq_end);
+
+    std::memcpy(&o_value, words, sizeof(T));
+}
+
+
+#endif /** TRACKING_SEQLOCK_H_INCLUDED */
@@ -0,0 +1,121 @@
+/**
+ * SessionCache.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_SESSIONCACHE_H_INCLUDED
+#define TRACKING_SESSIONCACHE_H_INCLUDED
+
+#include "stdafx.h"
+#include "NatNetPacketDecoder.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Compact binary file holding the data descriptions of the last session
+    * with a NatNet server.
+    *
+    * The file starts with a magic number and a format version, followed by
+    * the server address, the NatNet version of the server, the rigid body
+    * and the skeleton descriptions. Values are stored in native byte order,
+    * a file written on a machine with other byte order is rejected by the
+    * magic number. Files are written to a temporary file first and then
+    * replaced, so a crash while writing never leaves a truncated cache.
+    *
+    ***************************************************************************/
+    class SessionCache {
+
+    public:
+
+        /** Contents of the cache file. */
+        struct Contents {
+            std::string                      server_ip;      /** The IP address of the NatNet server. */
+            uint16_t                         cmd_port;       /** The NatNet command port. */
+            std::array<unsigned char, 4>     natnet_version; /** The NatNet version of the server. */
+            std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription> rigid_bodies; /** The rigid body descriptions. */
+            std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>  skeletons;    /** The skeleton descriptions. */
+        };
+
+        /** Magic number at the start of the file ("TRKC"). */
+        static const uint32_t MAGIC = 0x434B5254;
+
+        /** Version of the file format. */
+        static const uint32_t FORMAT_VERSION = 1;
+
+        /** Maximum length of stored names. */
+        static const uint16_t MAX_NAME_LENGTH = 1024;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * Read the cache file.
+        *
+        * @param filename   The name of the cache file.
+        * @param o_contents Returns the contents (undefined on failure).
+        *
+        * @return True for success, false if the file is missing, malformed or has another format version.
+        */
+        static bool Read(const std::string& filename, Contents& o_contents);
+
+        /**
+        * Write the cache file.
+        *
+        * @param filename The name of the cache file.
+        * @param contents The contents.
+        *
+        * @return True for success, false otherwise.
+        */
+        static bool Write(const std::string& filename, const Contents& contents);
+
+        /**
+        * Compare rigid body descriptions (including order).
+        *
+        * @param a The first descriptions.
+        * @param b The second descriptions.
+        *
+        * @return True if the descriptions are equal, false otherwise.
+        */
+        static bool Equal(const std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& a,
+            const std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& b);
+
+        /**
+        * Compare skeleton descriptions (including order).
+        *
+        * @param a The first descriptions.
+        * @param b The second descriptions.
+        *
+        * @return True if the descriptions are equal, false otherwise.
+        */
+        static bool Equal(const std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& a,
+            const std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& b);
+
+    private:
+
+        /**********************************************************************
+        * functions
+        **********************************************************************/
+
+        template<typename T> static inline void write_value(std::ostream& stream, const T& value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T> static inline bool read_value(std::istream& stream, T& o_value) {
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(&o_value), sizeof(T)));
+        }
+
+        static void write_string(std::ostream& stream, const std::string& value);
+
+        static bool read_string(std::istream& stream, std::string& o_value);
+
+        static void write_description(std::ostream& stream, const tracking::NatNetPacketDecoder::RigidBodyDescription& description);
+
+        static bool read_description(std::istream& stream, tracking::NatNetPacketDecoder::RigidBodyDescription& o_description);
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_SESSIONCACHE_H_INCLUDED */
@@ -0,0 +1,238 @@
+/**
+ * SnapshotPublisher.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_SNAPSHOTPUBLISHER_H_INCLUDED
+#define TRACKING_SNAPSHOTPUBLISHER_H_INCLUDED
+
+#include "stdafx.h"
+#include "AlignedArray.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Publishes immutable snapshots of type T from a single writer thread to
+    * any number of reader threads (read-copy-update).
+    *
+    * Snapshots are taken from a pool of preallocated slots. The writer
+    * fills a free slot and makes it the current snapshot with one atomic
+    * pointer exchange. Readers pin the current snapshot with a reference
+    * counter (which acts as hazard pointer) and the writer only recycles
+    * slots which are neither current nor pinned. If readers pin all slots,
+    * the writer adds a slot to the pool, which is recycled like the others
+    * once released, so publishing never depends on the number of readers.
+    * Acquiring a snapshot costs one atomic increment and two atomic loads,
+    * independent of the number of readers, and never waits for the writer.
+    *
+    ***************************************************************************/
+    template <class T> class SnapshotPublisher {
+
+    private:
+
+        /** One slot of the snapshot pool. */
+        struct alignas(TRACKING_CACHE_LINE_SIZE) Slot {
+            Slot(void) : readers(0), value() { }
+
+            std::atomic<unsigned int> readers;   // Number of readers pinning the snapshot
+            T                         value;     // The snapshot
+        };
+
+    public:
+
+        /**
+        * Reference to a published snapshot.
+        * The snapshot stays valid and unchanged as long as the reference exists.
+        */
+        class Ptr {
+        public:
+            Ptr(void) : m_slot(nullptr) { }
+            explicit Ptr(Slot* slot) : m_slot(slot) { }
+            Ptr(Ptr&& other) : m_slot(other.m_slot) { other.m_slot = nullptr; }
+            Ptr& operator=(Ptr&& other) {
+                if (this != &other) { this->reset(); this->m_slot = other.m_slot; other.m_slot = nullptr; }
+                return *this;
+            }
+            Ptr(const Ptr&) = delete;
+            Ptr& operator=(const Ptr&) = delete;
+            ~Ptr(void) { this->reset(); }
+
+            inline void reset(void) {
+                if (this->m_slot != nullptr) {
+                    this->m_slot->readers.fetch_sub(1, std::memory_order_seq_cst);
+                    this->m_slot = nullptr;
+                }
+            }
+            inline const T* get(void) const { return (this->m_slot != nullptr) ? (&this->m_slot->value) : (nullptr); }
+            inline const T* operator->(void) const { return &this->m_slot->value; }
+            inline const T& operator*(void) const { return this->m_slot->value; }
+            inline explicit operator bool(void) const { return (this->m_slot != nullptr); }
+
+        private:
+            Slot* m_slot;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        SnapshotPublisher(void);
+
+        /**
+        * Allocate snapshot pool.
+        * Must not be called while readers or the writer are active.
+        *
+        * @param slot_count The initial number of snapshots in the pool (at least 3).
+        */
+        void Allocate(size_t slot_count);
+
+        /**
+        * Get a free snapshot for writing (single writer only).
+        * Adds a snapshot to the pool if all snapshots are pinned by readers.
+        *
+        * @return Pointer to snapshot.
+        */
+        T* BeginWrite(void);
+
+        /**
+        * Publish the snapshot returned by the last BeginWrite() call as 
+        * current snapshot (single writer only).
+        */
+        void Publish(void);
+
+        /**
+        * Withdraw the current snapshot.
+        * Snapshots pinned by readers stay valid until they are released.
+        */
+        void Clear(void);
+
+        /**
+        * Get the current snapshot.
+        *
+        * @return Reference to current snapshot, empty if nothing is published.
+        */
+        Ptr Acquire(void);
+
+        /**
+        * Get the number of snapshots in the pool (single writer only).
+        *
+        * @return The number of snapshots including the ones added by BeginWrite().
+        */
+        inline size_t Size(void) const {
+            return this->m_slots.Size() + this->m_added.size();
+        }
+
+    private:
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        tracking::AlignedArray<Slot> m_slots;
+        std::vector<std::unique_ptr<tracking::AlignedArray<Slot>>> m_added; // Slots added while all slots were pinned (only used by writer)
+        std::atomic<Slot*>           m_current;
+        Slot*                        m_writing;    // Slot returned by last BeginWrite() (only used by writer)
+        size_t                       m_next;       // Next slot to check for writing (only used by writer)
+
+    };
+
+} /** end namespace tracking */
+
+
+/// Template classes must be declared AND defined in the header file.
+
+
+template <class T>
+tracking::SnapshotPublisher<T>::SnapshotPublisher(void)
+    : m_slots()
+    , m_added()
+    , m_current(nullptr)
+    , m_writing(nullptr)
+    , m_next(0) {
+
+    // intentionally empty...
+}
+
+
+template <class T>
+void tracking::SnapshotPublisher<T>::Allocate(size_t slot_count) {
+
+    this->m_current.store(nullptr);
+    this->m_slots.Allocate((slot_count < 3) ? (3) : (slot_count));
+    this->m_added.clear();
+    this->m_writing = nullptr;
+    this->m_next = 0;
+}
+
+
+template <class T>
+T* tracking::SnapshotPublisher<T>::BeginWrite(void) {
+
+    Slot* current = this->m_current.load(std::memory_order_seq_cst);
+    for (size_t i = 0; i < this->m_slots.Size(); ++i) {
+        Slot* slot = &this->m_slots[(this->m_next + i) % this->m_slots.Size()];
+        // A reader pinning a slot after this check will notice that the slot
+        // is not current anymore and release it again without reading.
+        if ((slot != current) && (slot->readers.load(std::memory_order_seq_cst) == 0)) {
+            this->m_next = (this->m_next + i + 1) % this->m_slots.Size();
+            this->m_writing = slot;
+            return &slot->value;
+        }
+    }
+    for (auto& added : this->m_added) {
+        Slot* slot = &(*added)[0];
+        if ((slot != current) && (slot->readers.load(std::memory_order_seq_cst) == 0)) {
+            this->m_writing = slot;
+            return &slot->value;
+        }
+    }
+
+    // All slots are pinned, slots keep their address as long as the pool exists.
+    this->m_added.emplace_back(new tracking::AlignedArray<Slot>());
+    this->m_added.back()->Allocate(1);
+    this->m_writing = &(*this->m_added.back())[0];
+    return &this->m_writing->value;
+}
+
+
+template <class T>
+void tracking::SnapshotPublisher<T>::Publish(void) {
+
+    if (this->m_writing == nullptr) {
+        return;
+    }
+    this->m_current.store(this->m_writing, std::memory_order_seq_cst);
+    this->m_writing = nullptr;
+}
+
+
+template <class T>
+void tracking::SnapshotPublisher<T>::Clear(void) {
+
+    this->m_current.store(nullptr, std::memory_order_seq_cst);
+}
+
+
+template <class T>
+typename tracking::SnapshotPublisher<T>::Ptr tracking::SnapshotPublisher<T>::Acquire(void) {
+
+    for (;;) {
+        Slot* slot = this->m_current.load(std::memory_order_seq_cst);
+        if (slot == nullptr) {
+            return Ptr();
+        }
+        slot->readers.fetch_add(1, std::memory_order_seq_cst);
+        // Only keep the pin if the slot was not recycled in the meantime.
+        if (this->m_current.load(std::memory_order_seq_cst) == slot) {
+            return Ptr(slot);
+        }
+        slot->readers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+
+#endif /** TRACKING_SNAPSHOTPUBLISHER_H_INCLUDED */
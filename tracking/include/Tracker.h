@@ -8,7 +8,9 @@
 #ifndef TRACKING_TRACKER_H_INCLUDED
 #define TRACKING_TRACKER_H_INCLUDED
 
-#ifdef TRACKING_EXPORTS  
+#ifndef _WIN32
+#define TRACKING_API
+#elif defined(TRACKING_EXPORTS)  
 #define TRACKING_API __declspec(dllexport)   
 #else  
 #define TRACKING_API __declspec(dllimport)   
@@ -16,14 +18,15 @@
 
 #include "stdafx.h"
 #include "VrpnButtonDevice.h"
+#include "VrpnTrackerDevice.h"
 #include "NatNetDevicePool.h"
 
 namespace tracking {
 
     /***************************************************************************
     *
-    * Collects 6 DOF tracking data of rigid bodies (via NetNet) and
-    * the states of VRPN button devices.
+    * Collects 6 DOF tracking data of rigid bodies (via NetNet or VRPN
+    * tracker devices) and the states of VRPN button devices.
     *
     ***************************************************************************/
     class TRACKING_API Tracker {
@@ -36,13 +39,31 @@ namespace tracking {
             size_t                                            active_node_len;
             tracking::VrpnDevice<vrpn_Button_Remote>::Params* vrpn_params;
             size_t                                            vrpn_params_count;
-            tracking::NatNetDevicePool::Params                natnet_params;
+            const tracking::VrpnTrackerDevice::Params*        vrpn_tracker_params;       /** Rigid bodies fed by VRPN tracker devices instead of NatNet (nullptr for none). */
+            size_t                                            vrpn_tracker_params_count;
+            tracking::NatNetDevicePool::Params                natnet_params;             /** Set server_ip to empty string for VRPN tracker devices only. */
         };
 
-        /** Current tracking raw data. */
+        /** State of the connection to one endpoint (see ConnectAsync()). */
+        enum class ConnectionState {
+            Disconnected = 0,
+            Connecting   = 1,
+            Connected    = 2,
+            Failed       = 3
+        };
+
+        /** 
+        * Current tracking raw data. 
+        * The mocap frame number and the timestamps of the pose are part of 
+        * rigid_body. Equal sequence numbers of the same rigid body and button
+        * device mean equal data, so consumers can skip all further processing.
+        * A pose predicted to another display time differs nevertheless.
+        */
         struct TrackingData {
-            tracking::NatNetDevicePool::RigidBodyData rigid_body;
-            tracking::Button                          button;
+            tracking::NatNetDevicePool::RigidBodyData rigid_body;    /** The pose of the rigid body. */
+            tracking::Button                          button;        /** The button states. */
+            double                                    button_time;   /** The time of the latest change of the button states in local time (see GetLocalTime(), 0 if none). */
+            uint64_t                                  sequence;      /** Increases whenever pose, stale flag or button states change. */
         };
 
         ///////////////////////////////////////////////////////////////////////
@@ -66,11 +87,40 @@ namespace tracking {
 
         /**
         * Callback for connection tracking.
+        * Connects all endpoints in parallel and waits for all of them
+        * (see ConnectAsync()). Disconnects again if any endpoint fails.
         *
         * @return True for success, false otherwise.
         */
         bool Connect(void);
 
+        /**
+        * Start connecting all VRPN devices and NatNet in parallel and return
+        * immediately. Each device is usable as soon as it is connected (see
+        * GetMotionDevicesState() and GetButtonDeviceState()), data of devices
+        * which are not connected yet is returned as untracked. Endpoints 
+        * which fail stay disconnected, the others are kept.
+        *
+        * @return Future for the result of all endpoints (true if all are connected), invalid if not initialised or not the active node.
+        */
+        std::shared_future<bool> ConnectAsync(void);
+
+        /**
+        * Get the state of the NatNet connection.
+        *
+        * @return The connection state.
+        */
+        ConnectionState GetMotionDevicesState(void) const;
+
+        /**
+        * Get the state of the connection of a VRPN button device.
+        *
+        * @param button_device The handle of the button device (see ResolveButtonDevice()).
+        *
+        * @return The connection state.
+        */
+        ConnectionState GetButtonDeviceState(int button_device) const;
+
         /**
         * Callback for disconnection tracking.
         *
@@ -87,7 +137,7 @@ namespace tracking {
         * @return All available rigid body names.
         */
         inline size_t GetRigidBodyCount(void) {
-            return this->m_motion_devices.GetRigidBodyNames().size();
+            return this->m_motion_devices.GetRigidBodyCount();
         }
 
         /**
@@ -96,19 +146,234 @@ namespace tracking {
         * @return All available rigid body names.
         */
         const char* GetRigidBodyName(size_t index) {
-            if (index < this->m_motion_devices.GetRigidBodyNames().size()) {
-                return this->m_motion_devices.GetRigidBodyNames()[index].c_str();
-            }
-            else {
-                return nullptr;
-            }
+            return this->m_motion_devices.GetRigidBodyName(index);
+        }
+
+        /**
+        * Get the latest complete frame of all rigid bodies.
+        * Use this for consumers of multiple rigid bodies (e.g. glasses and 
+        * stick), since all rigid bodies of one frame stem from the same 
+        * NatNet frame.
+        *
+        * @return Reference to the latest frame, empty if no frame was received yet.
+        */
+        inline tracking::NatNetDevicePool::FramePtr GetLatestFrame(void) {
+            return this->m_motion_devices.GetLatestFrame();
+        }
+
+        /**
+        * Resolve the handle of a skeleton (see NatNetDevicePool::ResolveSkeleton()).
+        *
+        * @param skeleton The skeleton name.
+        *
+        * @return The handle of the skeleton, -1 if the name is unknown.
+        */
+        inline int ResolveSkeleton(const std::string& skeleton) const {
+            return this->m_motion_devices.ResolveSkeleton(skeleton);
+        }
+
+        /**
+        * Get the world transforms of all bones of a skeleton from the latest 
+        * frame in one call (see NatNetDevicePool::GetSkeletonBoneMatrices()).
+        *
+        * @return The number of copied matrices (at most capacity).
+        */
+        inline size_t GetSkeletonBoneMatrices(int skeleton, size_t capacity, glm::mat4* o_matrices, int& o_frame) {
+            return this->m_motion_devices.GetSkeletonBoneMatrices(skeleton, capacity, o_matrices, o_frame);
+        }
+
+        /**
+        * Copy the markers of the latest frame (labeled and unlabeled) into 
+        * the given arrays without allocation (see NatNetDevicePool::CopyMarkers()).
+        *
+        * @return The number of copied markers (at most capacity).
+        */
+        inline size_t CopyMarkers(size_t capacity, float* o_x, float* o_y, float* o_z, float* o_size, float* o_residual,
+            int32_t* o_id, int16_t* o_params, int& o_frame) {
+            return this->m_motion_devices.CopyMarkers(capacity, o_x, o_y, o_z, o_size, o_residual, o_id, o_params, o_frame);
+        }
+
+        /**
+        * Get the pose of a rigid body at the given time (e.g. the time the 
+        * rendered frame is supposed to show), interpolated from the recent
+        * pose history.
+        *
+        * @param rigid_body The rigid body handle (see ResolveRigidBody()).
+        * @param time       The local time (see tracking::GetLocalTime()).
+        * @param o_data     Returns the pose of the rigid body.
+        *
+        * @return True for success, false if no pose was recorded yet.
+        */
+        inline bool GetPoseAt(int rigid_body, double time, tracking::NatNetDevicePool::RigidBodyData& o_data) const {
+            return this->m_motion_devices.GetPoseAt(rigid_body, time, o_data);
+        }
+
+        /**
+        * Get running latency statistics of one stage between camera 
+        * exposure and the consumer reading the data.
+        *
+        * @param stage   The latency stage.
+        * @param o_stats Returns the statistics of the stage (in seconds).
+        *
+        * @return True for success, false otherwise.
+        */
+        inline bool GetLatencyStatistics(tracking::NatNetDevicePool::LatencyStage stage, tracking::LatencyHistogram::Statistics& o_stats) const {
+            return this->m_motion_devices.GetLatencyStatistics(stage, o_stats);
+        }
+
+        /**
+        * Reset latency statistics of all stages.
+        */
+        inline void ResetLatencyStatistics(void) {
+            this->m_motion_devices.ResetLatencyStatistics();
+        }
+
+        /**
+        * Get the frame sequence counters (gaps, duplicates, reordering and loss rate) of the current connection.
+        *
+        * @param o_stats Returns the counters.
+        */
+        inline void GetStreamStatistics(tracking::FrameSequence::Statistics& o_stats) const {
+            this->m_motion_devices.GetStreamStatistics(o_stats);
+        }
+
+        /**
+        * Reset the frame sequence counters.
+        */
+        inline void ResetStreamStatistics(void) {
+            this->m_motion_devices.ResetStreamStatistics();
+        }
+
+        /**
+        * Get the failover counters (number of switches to standby servers, current server and latencies).
+        *
+        * @param o_stats Returns the counters.
+        */
+        inline void GetFailoverStatistics(tracking::NatNetDevicePool::FailoverStatistics& o_stats) const {
+            this->m_motion_devices.GetFailoverStatistics(o_stats);
+        }
+
+        /**
+        * Get the frame sequence number, which increases with every published
+        * mocap frame, stored pose of a VRPN tracker device and button event.
+        *
+        * @return The frame sequence number.
+        */
+        inline uint64_t GetFrameSequence(void) const {
+            return this->m_frame_signal.GetSequence();
+        }
+
+        /**
+        * Sleep until new data arrives (see GetFrameSequence()) instead of polling.
+        *
+        * @param last_sequence The frame sequence number the caller has already processed.
+        * @param timeout       The timeout in seconds (negative to wait without timeout).
+        *
+        * @return The current frame sequence number (equals last_sequence on timeout).
+        */
+        inline uint64_t WaitForFrame(uint64_t last_sequence, double timeout) {
+            return this->m_frame_signal.Wait(last_sequence, timeout);
+        }
+
+        /**
+        * Get a descriptor for waiting on new data together with other I/O
+        * (eventfd for poll/epoll on Linux, pipe on other POSIX systems, event
+        * handle for WaitForMultipleObjects on Windows). It stays readable (signaled) until ResetFrameDescriptor().
+        *
+        * @return The descriptor (must not be read or closed).
+        */
+        inline tracking::FrameSignal::Descriptor GetFrameDescriptor(void) const {
+            return this->m_frame_signal.GetDescriptor();
+        }
+
+        /**
+        * Reset the descriptor of GetFrameDescriptor() after it became readable.
+        * Compare the returned frame sequence number with the processed one
+        * before waiting again, data arriving meanwhile is not signaled again.
+        *
+        * @return The current frame sequence number.
+        */
+        inline uint64_t ResetFrameDescriptor(void) {
+            return this->m_frame_signal.ResetDescriptor();
         }
 
         /**********************************************************************/
         // Only to be called by TrackingUtilizer (only use inside dll).
 
+        /**
+        * Resolve the handle of a rigid body once, e.g. on initialisation.
+        * Handles stay valid across reconnects.
+        *
+        * @param rigid_body The name of the rigid body.
+        *
+        * @return The handle of the rigid body, -1 if the name is unknown.
+        */
+        inline int ResolveRigidBody(const std::string& rigid_body) const {
+            return this->m_motion_devices.ResolveRigidBody(rigid_body);
+        }
+
+        /**
+        * Subscribe to a rigid body used by a TrackingUtilizer (see NatNetDevicePool::Params::subscription).
+        *
+        * @param rigid_body The handle of the rigid body.
+        *
+        * @return True for success, false otherwise.
+        */
+        inline bool SubscribeRigidBody(int rigid_body) {
+            return this->m_motion_devices.SubscribeRigidBody(rigid_body);
+        }
+
+        /**
+        * Release a subscription of SubscribeRigidBody().
+        *
+        * @param rigid_body The handle of the rigid body.
+        *
+        * @return True for success, false otherwise.
+        */
+        inline bool UnsubscribeRigidBody(int rigid_body) {
+            return this->m_motion_devices.UnsubscribeRigidBody(rigid_body);
+        }
+
+        /**
+        * Resolve the handle of a button device once, e.g. on initialisation.
+        *
+        * @param button_device The name of the button device.
+        *
+        * @return The handle of the button device, -1 if the name is unknown.
+        */
+        int ResolveButtonDevice(const std::string& button_device) const;
+
+        /**
+        *  Get tracking data with the pose predicted to the given display time.
+        *  Without prediction configured the current pose is returned.
+        *  No strings are compared or allocated.
+        *
+        * @param i_rigid_body     The handle of the rigid body getting data for (see ResolveRigidBody()).
+        * @param i_button_device  The handle of the button device getting data for (see ResolveButtonDevice()).
+        * @param i_display_time   The local time (see tracking::GetLocalTime()) the data is displayed at, negative for the current pose.
+        * @param o_data           Returns the tracking data.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool GetData(int i_rigid_body, int i_button_device, double i_display_time, tracking::Tracker::TrackingData& o_data);
+
+        /**
+        *  Get current tracking data.
+        *  No strings are compared or allocated.
+        *
+        * @param i_rigid_body     The handle of the rigid body getting data for (see ResolveRigidBody()).
+        * @param i_button_device  The handle of the button device getting data for (see ResolveButtonDevice()).
+        * @param o_data           Returns the current tracking raw data.
+        *
+        * @return True for success, false otherwise.
+        */
+        inline bool GetData(int i_rigid_body, int i_button_device, tracking::Tracker::TrackingData& o_data) {
+            return this->GetData(i_rigid_body, i_button_device, -1.0, o_data);
+        }
+
         /**
         *  Get current tracking data.
+        *  Prefer the handle based overload for repeated calls.
         *
         * @param i_rigid_body     The name of the rigid body getting data for
         * @param i_button_device  The name of the button device getting data for.
@@ -116,7 +381,22 @@ namespace tracking {
         *
         * @return True for success, false otherwise.
         */
-        bool GetData(const std::string& i_rigid_body, const std::string& i_button_device, tracking::Tracker::TrackingData& o_data);
+        inline bool GetData(const std::string& i_rigid_body, const std::string& i_button_device, tracking::Tracker::TrackingData& o_data) {
+            return this->GetData(this->ResolveRigidBody(i_rigid_body), this->ResolveButtonDevice(i_button_device), o_data);
+        }
+
+        /**
+        *  Get the button transitions of a button device since the last call of the consumer.
+        *  Unlike the button states of GetData() no press or release is lost between two polls.
+        *
+        * @param i_button_device  The handle of the button device (see ResolveButtonDevice()).
+        * @param io_cursor        The position of the next event of the consumer (start with 0), returns the position after the copied events.
+        * @param i_capacity       The capacity of o_events.
+        * @param o_events         Returns the events in order of arrival (see VrpnButtonDevice::DrainEvents()).
+        *
+        * @return The number of copied events.
+        */
+        size_t DrainButtonEvents(int i_button_device, uint64_t& io_cursor, size_t i_capacity, tracking::VrpnButtonDevice::Event* o_events) const;
 
     private:
 
@@ -125,6 +405,7 @@ namespace tracking {
         **********************************************************************/
 
         typedef std::vector<std::unique_ptr<tracking::VrpnButtonDevice>> VrpnButtonPoolType;
+        typedef std::vector<std::unique_ptr<tracking::VrpnTrackerDevice>> VrpnTrackerPoolType;
 
         /**********************************************************************
         * variables
@@ -132,8 +413,14 @@ namespace tracking {
 
         bool m_initialised;
         bool m_connected;
+        tracking::FrameSignal m_frame_signal;                       // Notified by all devices (outlives them)
+        tracking::VrpnReactor m_vrpn_reactor;                       // Runs the main loops of all button devices (outlives them)
         VrpnButtonPoolType m_button_devices;
         tracking::NatNetDevicePool m_motion_devices;
+        VrpnTrackerPoolType m_tracker_devices;                      // Feed rigid bodies of m_motion_devices (declared after it)
+        std::vector<std::shared_future<bool>> m_button_connects;   // Pending or finished connect of each button device
+        std::shared_future<bool> m_motion_connect;                  // Pending or finished connect of the motion devices
+        std::shared_future<bool> m_connect;                         // Result of all endpoints
 
         /** parameters ********************************************************/
 
@@ -146,6 +433,22 @@ namespace tracking {
 
         void print_params(void);
 
+        /**
+        * Check whether this node is enabled to receive tracker updates.
+        *
+        * @return True if the active node is not set or matches the name of this computer.
+        */
+        bool is_active_node(void) const;
+
+        /**
+        * Get the state of a pending or finished connect.
+        *
+        * @param connect The future of the connect.
+        *
+        * @return The connection state.
+        */
+        static ConnectionState get_state(const std::shared_future<bool>& connect);
+
     };
 
 } /** end namespace tracking */
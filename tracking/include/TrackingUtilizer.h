@@ -8,7 +8,9 @@
 #ifndef TRACKING_TRACKINGUTILIZER_H_INCLUDED
 #define TRACKING_TRACKINGUTILIZER_H_INCLUDED
 
-#ifdef TRACKING_EXPORTS  
+#ifndef _WIN32
+#define TRACKING_API
+#elif defined(TRACKING_EXPORTS)  
 #define TRACKING_API __declspec(dllexport)   
 #else  
 #define TRACKING_API __declspec(dllimport)   
@@ -38,7 +40,8 @@ namespace tracking {
     *     This is required by the NatNet client implemented in NatNetDevicePool.
     * 
     * - If your program only receives zero valued tracking data:
-    *     Switch from `Multicast` to `Unicast` in settings of 'Motive' software
+    *     Check that the connection type (see NatNetDevicePool::Params) 
+    *     matches the `Multicast`/`Unicast` setting of 'Motive' software
     *     on NatNet server `mini`. 
     *
     ***************************************************************************/
@@ -123,7 +126,25 @@ namespace tracking {
         *
         * @return True for success, false otherwise.
         */
-        bool GetRawData(unsigned int& o_button,
+        inline bool GetRawData(unsigned int& o_button,
+            float& o_position_x, float& o_position_y, float& o_position_z,
+            float& o_orientation_x, float& o_orientation_y, float& o_orientation_z, float& o_orientation_w) {
+            return this->GetRawData(-1.0, o_button, o_position_x, o_position_y, o_position_z, 
+                o_orientation_x, o_orientation_y, o_orientation_z, o_orientation_w);
+        }
+
+        /**
+        *  Get the raw tracking data with the pose predicted to the given display time
+        *  (see Tracker::Params::natnet_params.prediction).
+        *
+        * @param i_display_time           The local time (see tracking::GetLocalTime()) the data is displayed at (e.g. next vsync).
+        * @param o_button                 Output the current button of the given button device.
+        * @param o_position_(x,y,z)       Output the predicted position of the given rigid body.
+        * @param o_orientation_(x,y,z,w)  Output the predicted orientation of the given rigid body.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool GetRawData(double i_display_time, unsigned int& o_button,
             float& o_position_x, float& o_position_y, float& o_position_z,
             float& o_orientation_x, float& o_orientation_y, float& o_orientation_z, float& o_orientation_w);
 
@@ -136,6 +157,17 @@ namespace tracking {
         */
         bool GetSelectionState(bool& o_selecttion);
 
+        /**
+        *  Get the transitions of the button device since the last call,
+        *  including the events before the first call (at most VrpnButtonDevice::EVENT_CAPACITY).
+        *
+        * @param i_capacity  The capacity of o_events.
+        * @param o_events    Returns the events in order of arrival.
+        *
+        * @return The number of copied events.
+        */
+        size_t DrainButtonEvents(size_t i_capacity, tracking::VrpnButtonDevice::Event* o_events);
+
         /**
         *  Get the current intersection with the screen.
         *
@@ -143,7 +175,20 @@ namespace tracking {
         *
         * @return True for success, false otherwise.
         */
-        bool GetIntersection(float& o_intersection_x, float& o_intersection_y);
+        inline bool GetIntersection(float& o_intersection_x, float& o_intersection_y) {
+            return this->GetIntersection(-1.0, o_intersection_x, o_intersection_y);
+        }
+
+        /**
+        *  Get the intersection with the screen predicted to the given display time
+        *  (see Tracker::Params::natnet_params.prediction).
+        *
+        * @param i_display_time        The local time (see tracking::GetLocalTime()) the data is displayed at (e.g. next vsync).
+        * @param o_intersection_(x,y)  Output the relative 2D screen intersection coordinates (in range [0,1]).
+        *
+        * @return True for success, false otherwise.
+        */
+        bool GetIntersection(double i_display_time, float& o_intersection_x, float& o_intersection_y);
 
         /**
         *  Get the current field of view.
@@ -214,6 +259,9 @@ namespace tracking {
 
         bool                                m_initialised;
         std::shared_ptr<tracking::Tracker>  m_tracker;
+        int                                 m_rigid_body_handle;      // Resolved handle of m_rigid_body_name (-1 if not resolved yet)
+        size_t                              m_rigid_body_count;       // Number of rigid bodies known to the tracker when the handle was last resolved
+        int                                 m_button_device_handle;   // Resolved handle of m_button_device_name (-1 if not resolved yet)
         glm::vec3                           m_current_cam_position;
         glm::vec3                           m_current_cam_up;
         glm::vec3                           m_current_cam_view;
@@ -225,9 +273,14 @@ namespace tracking {
         tracking::Button                    m_current_button;
         bool                                m_current_selecting;
         tracking::Button                    m_last_button;
-        std::vector<glm::vec3>              m_buffer_positions;
-        unsigned int                        m_buffer_idx;
-        bool                                m_const_position;
+        uint64_t                            m_drain_cursor;           // Cursor of DrainButtonEvents() in the button events
+        uint64_t                            m_replay_cursor;          // Cursor of the replay of the button events
+        tracking::Button                    m_replay_button;          // Button states replayed from the button events
+        double                              m_replay_time;            // Local receive time of the latest replayed button event (0 if none)
+        bool                                m_select_clicked;         // Select button was pressed since the last GetSelectionState()
+        bool                                m_stale_pose;
+        uint64_t                            m_sequence;               // Sequence number of the latest tracking data (see Tracker::TrackingData)
+        uint64_t                            m_screen_sequence;        // Sequence number of the data of the latest screen interaction (0 if none or predicted)
         glm::vec3                           m_start_cam_view;
         glm::vec3                           m_start_cam_position;
         glm::vec3                           m_start_cam_up;
@@ -281,9 +334,18 @@ namespace tracking {
         /**
         * Request updated tracking data.
         *
+        * @param display_time The local time the data is displayed at, negative for the current pose.
+        *
         * @return True for success, false otherwise.
         */
-        bool update_tracking_data(void);
+        bool update_tracking_data(double display_time = -1.0);
+
+        /**
+        * Set the rigid body handle and move the subscription at the tracker to it.
+        *
+        * @param handle The rigid body handle (-1 to only release the subscription).
+        */
+        void set_rigid_body_handle(int handle);
 
         /**
         * Process button changes.
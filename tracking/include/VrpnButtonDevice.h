@@ -10,6 +10,9 @@
 
 #include "stdafx.h"
 #include "VrpnDevice.h"
+#include "VrpnReactor.h"
+#include "HistoryRing.h"
+#include "FrameSignal.h"
 
 namespace tracking {
 
@@ -17,15 +20,42 @@ namespace tracking {
     *
     * VRPN button device.
     *
+    * The main loop is run by the reactor shared with the other devices
+    * while connected. A watchdog in the main loop releases all buttons 
+    * when the link to the VRPN server is lost and recreates the remote 
+    * device with exponential backoff until the link is up again.
+    *
+    * Besides the current button states every transition is recorded as 
+    * event in a ring written by the reactor thread only. Any number of 
+    * consumers drain the events lock free, each with its own cursor, so a
+    * press and release between two polls is never lost (unless more than
+    * EVENT_CAPACITY events arrive between two polls).
+    *
     ***************************************************************************/
-    class VrpnButtonDevice : public tracking::VrpnDevice<vrpn_Button_Remote> {
+    class VrpnButtonDevice : public tracking::VrpnDevice<vrpn_Button_Remote>, public tracking::VrpnReactor::Device {
 
     public:
 
+        /** Transition of a button. */
+        struct Event {
+            int                              button;         /** The button number. */
+            bool                             pressed;        /** True if the button was pressed, false if released. */
+            double                           timestamp;      /** The VRPN message time in seconds (clock of the VRPN server, 0 for releases by the watchdog). */
+            double                           receive_time;   /** The time the event was received in local time (see GetLocalTime()). */
+        };
+
+        /** Number of events kept for consumers. */
+        static const size_t EVENT_CAPACITY = 256;
+
+        ///////////////////////////////////////////////////////////////////////
+
         /**
         * CTOR
+        *
+        * @param reactor The reactor running the main loop (has to outlive the device).
+        * @param signal  The signal notified with every event (nullptr for none, has to outlive the device).
         */
-        VrpnButtonDevice(void);
+        VrpnButtonDevice(tracking::VrpnReactor& reactor, tracking::FrameSignal* signal = nullptr);
 
         /**
         * DTOR
@@ -63,16 +93,77 @@ namespace tracking {
         */
         tracking::Button GetButton(void) const;
 
+        /**
+        * Copy the events since the cursor of the consumer in order of arrival.
+        * If the consumer lagged behind by more than EVENT_CAPACITY events,
+        * the oldest events are skipped.
+        *
+        * @param io_cursor The position of the next event of the consumer (start with 0), returns the position after the copied events.
+        * @param capacity  The capacity of o_events.
+        * @param o_events  Returns the events.
+        *
+        * @return The number of copied events.
+        */
+        size_t DrainEvents(uint64_t& io_cursor, size_t capacity, Event* o_events) const;
+
+        /**
+        * Get the number of events so far, which increases with every change of the button states.
+        *
+        * @return The number of events.
+        */
+        inline uint64_t GetEventCount(void) const {
+            return this->m_events.GetEnd();
+        }
+
+        /**
+        * Get the latest event.
+        *
+        * @param o_event Returns the latest event.
+        *
+        * @return True for success, false if there was no event yet.
+        */
+        bool GetLatestEvent(Event& o_event) const;
+
+        /**
+        * Check whether the device is connected (e.g. after Tracker::ConnectAsync()).
+        *
+        * @return True if the device is connected.
+        */
+        inline bool IsConnected(void) const {
+            return this->m_connected.load();
+        }
+
+        /**
+        * Get the connection to wait for (called by the reactor thread).
+        *
+        * @return The connection, nullptr if there is none.
+        */
+        vrpn_Connection* GetReactorConnection(void);
+
+        /** Run the main loop including the watchdog (called by the reactor thread). */
+        void React(void);
+
     private:
 
+        /** Delay in seconds after losing the link before the first reconnect attempt (doubled for each further attempt). */
+        static constexpr double RECONNECT_DELAY = 1.0;
+
+        /** Maximum delay in seconds between two reconnect attempts. */
+        static constexpr double RECONNECT_DELAY_MAX = 16.0;
+
         /***********************************************************************
         * variables
         **********************************************************************/
 
         bool m_initialised;
-        bool m_connected;
-        std::atomic<bool> m_run_thread_loop;
+        std::atomic<bool> m_connected;
         std::atomic<tracking::Button> m_button;
+        tracking::HistoryRing<Event> m_events;          // Button transitions (written by reactor thread only)
+        tracking::VrpnReactor& m_reactor;
+        tracking::FrameSignal* m_signal;                 // Notified with every event (nullptr for none)
+        double m_lost_time;                              // Time the link was found down (0 if up, reactor thread only)
+        double m_retry_time;                             // Time of the next reconnect attempt (reactor thread only)
+        double m_retry_delay;                            // Delay before the next reconnect attempt (reactor thread only)
 
         /***********************************************************************
         * functions
@@ -85,6 +176,9 @@ namespace tracking {
         * @param vrpnData Data struct holding current button data.
         */
         static void VRPN_CALLBACK on_button_changed(void *userData, const vrpn_BUTTONCB vrpnData);
+
+        /** Release all pressed buttons (reactor thread only). */
+        void release_buttons(void);
     };
 
 } /** end namespace tracking */
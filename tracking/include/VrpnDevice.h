@@ -32,7 +32,7 @@ namespace tracking {
 
         /** Data structure for setting PARAMETERs as batch. */
         struct Params  {
-            const char*                                 device_name;     /** The VRPN button device name. */
+            const char*                                 device_name;     /** The VRPN device name.        */
             size_t                                      device_name_len; 
             const char*                                 server_name;     /** The VRPN server name.        */
             size_t                                      server_name_len; 
@@ -76,7 +76,7 @@ namespace tracking {
         /**********************************************************************/
         // GET
 
-        inline std::string GetDeviceName(void) const {
+        inline const std::string& GetDeviceName(void) const {
             return this->m_device_name;
         }
 
@@ -99,6 +99,41 @@ namespace tracking {
         */
         bool MainLoop(void);
 
+        /**
+        * Check whether the link to the VRPN server is up. The link is 
+        * established asynchronously by the main loop, so it is down for a
+        * moment after connecting, too.
+        *
+        * @return True if the link is up, false otherwise.
+        */
+        bool IsLinkUp(void) const;
+
+        /**
+        * Check whether the remote device exists (the link might be down nevertheless, see IsLinkUp()).
+        *
+        * @return True if the remote device exists, false otherwise.
+        */
+        inline bool HasRemoteDevice(void) const {
+            return (this->m_remote_device != nullptr);
+        }
+
+        /**
+        * Get the connection of the remote device.
+        *
+        * @return The connection, nullptr if there is no remote device.
+        */
+        inline vrpn_Connection* GetConnection(void) const {
+            return (this->m_remote_device) ? (this->m_remote_device->connectionPtr()) : (nullptr);
+        }
+
+        /**
+        * Recreate the remote device after the link was lost.
+        * Callbacks have to be registered again.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool Reconnect(void);
+
     private:
 
         /***********************************************************************
@@ -112,7 +147,7 @@ namespace tracking {
         /** PARAMETERs ********************************************************/
 
         /** 
-        * Button device name. 
+        * Device name. 
         * The name of the device (defined in vrpn cfg file).
         */
         std::string m_device_name;
@@ -141,6 +176,13 @@ namespace tracking {
         /** Print used PARAMETER values. */
         void print_params(void);
 
+        /**
+        * Create the remote device.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool open_remote_device(void);
+
     };
 
 } /** end namespace tracking */
@@ -253,10 +295,42 @@ bool tracking::VrpnDevice<R>::Connect(void) {
         return false;
     }
 
-    std::string url;
+    // Terminate previous connection (not virtual: overrides may take the reactor lock held by the caller).
+    VrpnDevice<R>::Disconnect();
 
-    // Terminate previous connection.    
-    this->Disconnect();
+    return this->open_remote_device();
+}
+
+
+template <class R>
+bool tracking::VrpnDevice<R>::Reconnect(void) {
+
+    if (!this->m_initialised) {
+        std::cerr << std::endl << "[ERROR] [VrpnDevice] Not initialised. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Dropping the remote device releases the broken connection and unregisters its callbacks.
+    this->m_remote_device.reset(nullptr);
+    this->m_connected = false;
+
+    return this->open_remote_device();
+}
+
+
+template <class R>
+bool tracking::VrpnDevice<R>::IsLinkUp(void) const {
+
+    vrpn_Connection* connection = this->GetConnection();
+    return (this->m_connected && (connection != nullptr) && (connection->connected() == vrpn_true));
+}
+
+
+template <class R>
+bool tracking::VrpnDevice<R>::open_remote_device(void) {
+
+    std::string url;
 
     // Translate protocol to string
     std::string prot = "";
@@ -291,7 +365,7 @@ bool tracking::VrpnDevice<R>::Connect(void) {
     /// Create remote_device object calling CTOR with make_unique() for type R (e.g. vrpn_Button_remote_device, vrpn_Tracker_remote_device)
     this->m_remote_device = std::make_unique<R>(url.c_str(), connection); 
     this->m_remote_device->shutup = true;
-    std::cout << "[INFO] [VrpnDevice] >>> AVAILABEL BUTTON DEVICE: \"" << this->m_device_name.c_str() << "\"" << std::endl;
+    std::cout << "[INFO] [VrpnDevice] >>> AVAILABLE VRPN DEVICE: \"" << this->m_device_name.c_str() << "\"" << std::endl;
 
     std::cout << "[INFO] [VrpnDevice] Successfully connected to VRPN server." << std::endl;
 
@@ -380,13 +454,13 @@ bool tracking::VrpnDevice<R>::MainLoop(void) {
     catch (const std::exception& e) {
         std::cerr << std::endl << "[ERROR] [Tracker] Error executing remote device main loop: " << e.what() <<
             " [" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;    
-        this->Disconnect();
+        VrpnDevice<R>::Disconnect(); /// Not virtual, called by the reactor thread.
         return false;
     }
     catch (...) {
         std::cerr << std::endl << "[ERROR] [Tracker] Unknown error executing remote device main loop. " <<
             " [" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        this->Disconnect();
+        VrpnDevice<R>::Disconnect();
         return false;
     }
 
@@ -0,0 +1,140 @@
+/**
+ * VrpnReactor.h
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef TRACKING_VRPNREACTOR_H_INCLUDED
+#define TRACKING_VRPNREACTOR_H_INCLUDED
+
+#include "stdafx.h"
+#include "vrpn_Connection.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * Single thread running the main loops of all VRPN devices.
+    *
+    * The thread waits on the sockets of all connected VRPN connections with
+    * one select until data arrives or the wait time elapses, and then runs
+    * the main loops of all devices, so it sleeps while no data arrives
+    * independent of the number of connections. Devices of the same server
+    * share one connection, which is waited for only once. VRPN does not
+    * expose the sockets of a connection, they are read from the protected
+    * endpoints of the connection. Connections without sockets are waited
+    * for one after the other by their main loops with the response time
+    * split between them.
+    *
+    * The thread is started with the first device added and stopped and
+    * joined after the last device is removed. Devices are only accessed
+    * while holding the lock, so a device is never accessed anymore once
+    * Remove() returned. Remote devices are created and deleted through
+    * Run(), since they register with the connection shared with other
+    * devices, which must not happen during its main loop.
+    *
+    ***************************************************************************/
+    class VrpnReactor {
+
+    public:
+
+        /** Interface of devices run by the reactor. */
+        class Device {
+
+        public:
+
+            virtual ~Device(void) { }
+
+            /**
+            * Get the connection to wait for (called by the reactor thread).
+            *
+            * @return The connection of the device, nullptr if there is none.
+            */
+            virtual vrpn_Connection* GetReactorConnection(void) = 0;
+
+            /** Run the main loop of the device (called by the reactor thread). */
+            virtual void React(void) = 0;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        */
+        VrpnReactor(void);
+
+        /**
+        * DTOR
+        */
+        ~VrpnReactor(void);
+
+        /**
+        * Add a device and start the reactor thread if not yet running.
+        *
+        * @param device The device (not owned).
+        *
+        * @return True on success, false if the device is already added.
+        */
+        bool Add(Device* device);
+
+        /**
+        * Remove a device and stop the reactor thread after the last device.
+        * Must not be called by the reactor thread (e.g. from React()).
+        *
+        * @param device The device.
+        *
+        * @return True on success, false if the device is unknown.
+        */
+        bool Remove(Device* device);
+
+        /**
+        * Run a function while the reactor thread does not run any main loop
+        * (e.g. creating or deleting remote devices on a shared connection).
+        * Must not be called by the reactor thread (e.g. from React()).
+        *
+        * @param function The function.
+        *
+        * @return The result of the function.
+        */
+        bool Run(const std::function<bool(void)>& function);
+
+    private:
+
+        /** Time in microseconds to wait for data of all connections (or a single connection without sockets). */
+        static const long WAIT_TIME = 10000;
+
+        /** Time in microseconds to wait for data of several connections without sockets together (bounds the latency of each connection). */
+        static const long RESPONSE_TIME = 500;
+
+        /** Time in milliseconds to sleep while no connection is established. */
+        static const int IDLE_TIME = 10;
+
+        /**********************************************************************
+        * variables
+        **********************************************************************/
+
+        std::mutex m_mutex;                              // Guards the devices, held while running their main loops
+        std::vector<Device*> m_devices;
+        std::thread m_thread;
+        uint64_t m_generation;                           // Incremented to stop the thread of the current generation
+
+        /**********************************************************************
+        * functions
+        **********************************************************************/
+
+        /**
+        * Main loop of the reactor thread.
+        *
+        * @param generation The generation of the thread (the thread ends if the generation changes).
+        */
+        void run(uint64_t generation);
+
+        /** Stop and join the reactor thread. */
+        void stop(void);
+
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_VRPNREACTOR_H_INCLUDED */
@@ -0,0 +1,161 @@
+/**
+* VrpnTrackerDevice.h
+*
+* Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+* Alle Rechte vorbehalten.
+*/
+
+#ifndef TRACKING_VRPNTRACKERDEVICE_H_INCLUDED
+#define TRACKING_VRPNTRACKERDEVICE_H_INCLUDED
+
+#include "stdafx.h"
+#include "VrpnDevice.h"
+#include "VrpnReactor.h"
+#include "NatNetDevicePool.h"
+
+namespace tracking {
+
+    /***************************************************************************
+    *
+    * VRPN tracker device feeding the poses of one sensor into a rigid body
+    * of the NatNet device pool (see NatNetDevicePool::AddExternalRigidBody()),
+    * so the rigid body is read like any other rigid body (e.g. with
+    * Tracker::GetData()) while its NatNet data is ignored.
+    *
+    * The main loop is run by the reactor shared with the other devices
+    * while connected. A watchdog in the main loop flags the latest pose
+    * stale when the link to the VRPN server is lost and recreates the
+    * remote device with exponential backoff until the link is up again.
+    *
+    * VRPN message times stem from the clock of the VRPN server, so poses
+    * are stamped with the local receive time as exposure time.
+    *
+    ***************************************************************************/
+    class VrpnTrackerDevice : public tracking::VrpnDevice<vrpn_Tracker_Remote>, public tracking::VrpnReactor::Device {
+
+    public:
+
+        /** Data structure for setting parameters as batch. */
+        struct Params {
+            tracking::VrpnDevice<vrpn_Tracker_Remote>::Params device;              /** The VRPN tracker device. */
+            const char*                                       rigid_body_name;     /** The rigid body the poses of the sensor are stored as. */
+            size_t                                            rigid_body_name_len;
+            int                                               sensor;              /** The sensor of the tracker device. */
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+
+        /**
+        * CTOR
+        *
+        * @param reactor The reactor running the main loop (has to outlive the device).
+        * @param pool    The pool storing the poses (has to outlive the device).
+        */
+        VrpnTrackerDevice(tracking::VrpnReactor& reactor, tracking::NatNetDevicePool& pool);
+
+        /**
+        * DTOR
+        */
+        ~VrpnTrackerDevice(void);
+
+        /**
+        * Initialisation. Adds the rigid body to the pool, so the pool has
+        * to be initialised before.
+        *
+        * @return True for success, false otherwise.
+        */
+        bool Initialise(const VrpnTrackerDevice::Params& params);
+
+        /**
+        * Connect to vrpn tracker device.
+        *
+        * @return True on success, false otherwise.
+        */
+        bool Connect(void);
+
+        /**
+        * Disconnect from vrpn tracker device (the latest pose is kept and flagged stale).
+        *
+        * @return True on success, false otherwise.
+        */
+        bool Disconnect(void);
+
+        /**********************************************************************/
+        // GET
+
+        /**
+        * Get the handle of the rigid body fed by the device.
+        *
+        * @return The rigid body handle (see NatNetDevicePool::ResolveRigidBody()), -1 if not initialised.
+        */
+        inline int GetRigidBody(void) const {
+            return this->m_rigid_body;
+        }
+
+        /**
+        * Check whether the device is connected (e.g. after Tracker::ConnectAsync()).
+        *
+        * @return True if the device is connected.
+        */
+        inline bool IsConnected(void) const {
+            return this->m_connected.load();
+        }
+
+        /**
+        * Get the connection to wait for (called by the reactor thread).
+        *
+        * @return The connection, nullptr if there is none.
+        */
+        vrpn_Connection* GetReactorConnection(void);
+
+        /** Run the main loop including the watchdog (called by the reactor thread). */
+        void React(void);
+
+    private:
+
+        /** Delay in seconds after losing the link before the first reconnect attempt (doubled for each further attempt). */
+        static constexpr double RECONNECT_DELAY = 1.0;
+
+        /** Maximum delay in seconds between two reconnect attempts. */
+        static constexpr double RECONNECT_DELAY_MAX = 16.0;
+
+        /***********************************************************************
+        * variables
+        **********************************************************************/
+
+        bool m_initialised;
+        std::atomic<bool> m_connected;
+        tracking::VrpnReactor& m_reactor;
+        tracking::NatNetDevicePool& m_pool;
+        int m_rigid_body;                                // Handle of the rigid body in the pool (-1 if not initialised)
+        int m_frame;                                     // Number of poses received (frame number of the poses, reactor thread only)
+        double m_lost_time;                              // Time the link was found down (0 if up, reactor thread only)
+        double m_retry_time;                             // Time of the next reconnect attempt (reactor thread only)
+        double m_retry_delay;                            // Delay before the next reconnect attempt (reactor thread only)
+
+        /** parameters ********************************************************/
+
+        std::string m_rigid_body_name;
+        int m_sensor;
+
+        /***********************************************************************
+        * functions
+        **********************************************************************/
+
+        void print_params(void);
+
+        /**
+        * Vrpn device callback for poses.
+        *
+        * @param userData Pointer to class, which registered the callback (that).
+        * @param vrpnData Data struct holding the pose of one sensor.
+        */
+        static void VRPN_CALLBACK on_pose_changed(void *userData, const vrpn_TRACKERCB vrpnData);
+
+        /** Flag the latest pose of the rigid body stale. */
+        void set_stale(void);
+    };
+
+} /** end namespace tracking */
+
+#endif /** TRACKING_VRPNTRACKERDEVICE_H_INCLUDED */
@@ -13,9 +13,20 @@
 #define WIN32_LEAN_AND_MEAN // Exclude rarely-used stuff from Windows headers
 #include <windows.h>
 #include <winsock2.h> 
+#include <ws2tcpip.h>
 #else 
- /** other OS */
-#error Platform not supported!
+ /** other OS (only built-in NatNet client is available) */
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif /** __linux__ */
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#define __cdecl
 #endif /** _WIN32 */
 
 /// HEADERS ///////////////////////////////////////////////////////////////////
@@ -29,10 +40,19 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
+#include <future>
 #include <cmath>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
 #include <limits>
 #include <array>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <functional>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -47,6 +67,9 @@ namespace tracking
     // If defined, playback logs of vrpn device are written (see VrpnDevice.h line 222).
     ///  #define TRACKING_VRPN_DEVICE_WRITE_PLAYBACKLOG 
 
+    // Size of a cache line in bytes (used for aligning data shared between threads).
+    #define TRACKING_CACHE_LINE_SIZE 64
+
     /// TYPES /////////////////////////////////////////////////////////////////////
 
     typedef unsigned int Button;
@@ -56,6 +79,18 @@ namespace tracking
     /// [1] = left_bottom 
     /// [2] = right_top
     /// [3] = right_bottom
+
+    /// FUNCTIONS /////////////////////////////////////////////////////////////////
+
+    /**
+    * Get the local monotonic time, which is the common time base of all 
+    * local timestamps (e.g. exposure and receive time of tracking data).
+    *
+    * @return The local time in seconds.
+    */
+    inline double GetLocalTime(void) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 }
 
 #endif /** TRACKING_STDAFX_INCLUDED */
@@ -0,0 +1,115 @@
+/**
+ * FrameSequence.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "FrameSequence.h"
+
+tracking::FrameSequence::FrameSequence(void)
+    : m_frames(0)
+    , m_gaps(0)
+    , m_lost(0)
+    , m_duplicates(0)
+    , m_out_of_order(0)
+    , m_restarts(0)
+    , m_loss_rate(0.0)
+    , m_last_frame(-1)
+    , m_last_receive_time(0.0)
+    , m_first_receive_time(0.0)
+    , m_reset(false)
+    , m_started(false)
+    , m_window_expected(0)
+    , m_window_lost(0)
+    , m_previous_expected(0)
+    , m_previous_lost(0) {
+
+    // intentionally empty...
+}
+
+
+bool tracking::FrameSequence::Accept(int frame, double receive_time) {
+
+    if (this->m_reset.load(std::memory_order_relaxed) && this->m_reset.exchange(false, std::memory_order_acquire)) {
+        this->m_started = false;
+        this->m_window_expected = 0;
+        this->m_window_lost = 0;
+        this->m_previous_expected = 0;
+        this->m_previous_lost = 0;
+    }
+
+    uint64_t lost = 0;
+    if (this->m_started) {
+        int64_t diff = static_cast<int64_t>(frame) - static_cast<int64_t>(this->m_last_frame.load(std::memory_order_relaxed));
+        if ((diff > MAX_FRAME_JUMP) || (diff < -MAX_FRAME_JUMP)) {
+            this->m_restarts.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (diff == 0) {
+            this->m_duplicates.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else if (diff < 0) {
+            this->m_out_of_order.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else if (diff > 1) {
+            lost = static_cast<uint64_t>(diff - 1);
+            this->m_gaps.fetch_add(1, std::memory_order_relaxed);
+            this->m_lost.fetch_add(lost, std::memory_order_relaxed);
+        }
+    }
+    if (!this->m_started) {
+        this->m_first_receive_time.store(receive_time, std::memory_order_relaxed);
+    }
+    this->m_started = true;
+    this->m_frames.fetch_add(1, std::memory_order_relaxed);
+    this->m_last_frame.store(frame, std::memory_order_relaxed);
+    this->m_last_receive_time.store(receive_time, std::memory_order_relaxed);
+
+    // Rolling loss rate over the current and the previous window.
+    this->m_window_expected += lost + 1;
+    this->m_window_lost += lost;
+    if (this->m_window_expected >= LOSS_WINDOW) {
+        this->m_previous_expected = this->m_window_expected;
+        this->m_previous_lost = this->m_window_lost;
+        this->m_window_expected = 0;
+        this->m_window_lost = 0;
+    }
+    uint64_t expected = this->m_previous_expected + this->m_window_expected;
+    this->m_loss_rate.store(static_cast<double>(this->m_previous_lost + this->m_window_lost) / static_cast<double>(expected), std::memory_order_relaxed);
+    return true;
+}
+
+
+void tracking::FrameSequence::Reset(void) {
+
+    this->m_frames.store(0, std::memory_order_relaxed);
+    this->m_gaps.store(0, std::memory_order_relaxed);
+    this->m_lost.store(0, std::memory_order_relaxed);
+    this->m_duplicates.store(0, std::memory_order_relaxed);
+    this->m_out_of_order.store(0, std::memory_order_relaxed);
+    this->m_restarts.store(0, std::memory_order_relaxed);
+    this->m_loss_rate.store(0.0, std::memory_order_relaxed);
+    this->m_last_frame.store(-1, std::memory_order_relaxed);
+    this->m_last_receive_time.store(0.0, std::memory_order_relaxed);
+    this->m_first_receive_time.store(0.0, std::memory_order_relaxed);
+    this->m_reset.store(true, std::memory_order_release);
+}
+
+
+void tracking::FrameSequence::GetStatistics(Statistics& o_stats) const {
+
+    // Counters are read one after another, so they may be off by frames
+    // accepted in the meantime.
+    o_stats.frames            = this->m_frames.load(std::memory_order_relaxed);
+    o_stats.gaps              = this->m_gaps.load(std::memory_order_relaxed);
+    o_stats.lost              = this->m_lost.load(std::memory_order_relaxed);
+    o_stats.duplicates        = this->m_duplicates.load(std::memory_order_relaxed);
+    o_stats.out_of_order      = this->m_out_of_order.load(std::memory_order_relaxed);
+    o_stats.restarts          = this->m_restarts.load(std::memory_order_relaxed);
+    o_stats.loss_rate         = this->m_loss_rate.load(std::memory_order_relaxed);
+    o_stats.last_frame        = this->m_last_frame.load(std::memory_order_relaxed);
+    o_stats.last_receive_time = this->m_last_receive_time.load(std::memory_order_relaxed);
+    o_stats.first_receive_time = this->m_first_receive_time.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,148 @@
+/**
+ * FrameSignal.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "FrameSignal.h"
+
+tracking::FrameSignal::FrameSignal(void)
+    : m_sequence(0)
+    , m_waiters(0)
+    , m_mutex()
+    , m_cv()
+    , m_signaled(false)
+    , m_descriptor()
+#if !defined(_WIN32) && !defined(__linux__)
+    , m_pipe_write(-1)
+#endif
+    {
+
+#if defined(_WIN32)
+    this->m_descriptor = CreateEvent(nullptr, TRUE, FALSE, nullptr); /// Manual reset, not signaled.
+    bool valid = (this->m_descriptor != nullptr);
+#elif defined(__linux__)
+    this->m_descriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    bool valid = (this->m_descriptor >= 0);
+#else
+    /// No eventfd, the read end of a non blocking pipe is readable while a byte is pending.
+    int ends[2] = { -1, -1 };
+    bool valid = (pipe(ends) == 0);
+    for (int i = 0; valid && (i < 2); ++i) {
+        valid = (fcntl(ends[i], F_SETFL, fcntl(ends[i], F_GETFL) | O_NONBLOCK) == 0) && (fcntl(ends[i], F_SETFD, FD_CLOEXEC) == 0);
+    }
+    if (!valid) {
+        for (int end : ends) {
+            if (end >= 0) {
+                close(end);
+            }
+        }
+        ends[0] = -1;
+        ends[1] = -1;
+    }
+    this->m_descriptor = ends[0];
+    this->m_pipe_write = ends[1];
+#endif
+    if (!valid) {
+        std::cerr << std::endl << "[ERROR] [FrameSignal] Failed to create pollable descriptor, only Wait() is available. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+    }
+}
+
+
+tracking::FrameSignal::~FrameSignal(void) {
+
+#ifdef _WIN32
+    if (this->m_descriptor != nullptr) {
+        CloseHandle(this->m_descriptor);
+    }
+#else
+    if (this->m_descriptor >= 0) {
+        close(this->m_descriptor);
+    }
+#ifndef __linux__
+    if (this->m_pipe_write >= 0) {
+        close(this->m_pipe_write);
+    }
+#endif
+#endif
+}
+
+
+void tracking::FrameSignal::Notify(void) {
+
+    this->m_sequence.fetch_add(1);
+
+    // Waiters check the sequence number with the lock held, so taking the lock once suffices not to miss them.
+    if (this->m_waiters.load() > 0) {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+        }
+        this->m_cv.notify_all();
+    }
+
+    // Descriptor stays signaled until reset, so only the first notification writes it.
+    if (!this->m_signaled.load(std::memory_order_relaxed) && !this->m_signaled.exchange(true)) {
+#if defined(_WIN32)
+        if (this->m_descriptor != nullptr) {
+            SetEvent(this->m_descriptor);
+        }
+#elif defined(__linux__)
+        if (this->m_descriptor >= 0) {
+            eventfd_write(this->m_descriptor, 1);
+        }
+#else
+        if (this->m_pipe_write >= 0) {
+            char byte = 1;
+            (void)write(this->m_pipe_write, &byte, 1);
+        }
+#endif
+    }
+}
+
+
+uint64_t tracking::FrameSignal::Wait(uint64_t sequence, double timeout) {
+
+    auto changed = [this, sequence]() { return (this->m_sequence.load() != sequence); };
+    if (changed()) {
+        return this->m_sequence.load();
+    }
+
+    this->m_waiters.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+        if (timeout < 0.0) {
+            this->m_cv.wait(lock, changed);
+        }
+        else {
+            this->m_cv.wait_for(lock, std::chrono::duration<double>(timeout), changed);
+        }
+    }
+    this->m_waiters.fetch_sub(1);
+
+    return this->m_sequence.load();
+}
+
+
+uint64_t tracking::FrameSignal::ResetDescriptor(void) {
+
+#if defined(_WIN32)
+    if (this->m_descriptor != nullptr) {
+        ResetEvent(this->m_descriptor);
+    }
+#elif defined(__linux__)
+    if (this->m_descriptor >= 0) {
+        eventfd_t value = 0;
+        eventfd_read(this->m_descriptor, &value); /// Non blocking, fails if not signaled.
+    }
+#else
+    if (this->m_descriptor >= 0) {
+        char bytes[16];
+        while (read(this->m_descriptor, bytes, sizeof(bytes)) > 0) { } /// Non blocking, stops once the pipe is empty.
+    }
+#endif
+    this->m_signaled.store(false);
+
+    return this->m_sequence.load();
+}
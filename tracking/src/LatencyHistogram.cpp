@@ -0,0 +1,97 @@
+/**
+ * LatencyHistogram.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "LatencyHistogram.h"
+
+tracking::LatencyHistogram::LatencyHistogram(void)
+    : m_buckets()
+    , m_count(0)
+    , m_sum(0)
+    , m_min((std::numeric_limits<uint64_t>::max)())
+    , m_max(0) {
+
+    for (auto& b : this->m_buckets) {
+        b.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+void tracking::LatencyHistogram::Record(double seconds) {
+
+    uint64_t us = (seconds > 0.0) ? (static_cast<uint64_t>(seconds * 1000000.0)) : (0);
+    size_t index = static_cast<size_t>(us / BUCKET_WIDTH);
+    if (index > BUCKET_COUNT) {
+        index = BUCKET_COUNT;
+    }
+
+    this->m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+    this->m_count.fetch_add(1, std::memory_order_relaxed);
+    this->m_sum.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t min = this->m_min.load(std::memory_order_relaxed);
+    while ((us < min) && !this->m_min.compare_exchange_weak(min, us, std::memory_order_relaxed)) { }
+    uint64_t max = this->m_max.load(std::memory_order_relaxed);
+    while ((us > max) && !this->m_max.compare_exchange_weak(max, us, std::memory_order_relaxed)) { }
+}
+
+
+void tracking::LatencyHistogram::Reset(void) {
+
+    for (auto& b : this->m_buckets) {
+        b.store(0, std::memory_order_relaxed);
+    }
+    this->m_count.store(0, std::memory_order_relaxed);
+    this->m_sum.store(0, std::memory_order_relaxed);
+    this->m_min.store((std::numeric_limits<uint64_t>::max)(), std::memory_order_relaxed);
+    this->m_max.store(0, std::memory_order_relaxed);
+}
+
+
+void tracking::LatencyHistogram::GetStatistics(Statistics& o_stats) const {
+
+    // Counters are read one after another, so the summary may be off by
+    // latencies recorded in the meantime.
+    std::array<uint64_t, BUCKET_COUNT + 1> counts;
+    uint64_t count = 0;
+    for (size_t i = 0; i <= BUCKET_COUNT; ++i) {
+        counts[i] = this->m_buckets[i].load(std::memory_order_relaxed);
+        count += counts[i];
+    }
+
+    o_stats.count = count;
+    if (count == 0) {
+        o_stats.mean = 0.0;
+        o_stats.min  = 0.0;
+        o_stats.max  = 0.0;
+        o_stats.p50  = 0.0;
+        o_stats.p95  = 0.0;
+        o_stats.p99  = 0.0;
+        return;
+    }
+
+    uint64_t sum_count = this->m_count.load(std::memory_order_relaxed);
+    o_stats.mean = (sum_count > 0) ? (static_cast<double>(this->m_sum.load(std::memory_order_relaxed)) / static_cast<double>(sum_count) / 1000000.0) : (0.0);
+    o_stats.min  = static_cast<double>(this->m_min.load(std::memory_order_relaxed)) / 1000000.0;
+    o_stats.max  = static_cast<double>(this->m_max.load(std::memory_order_relaxed)) / 1000000.0;
+    o_stats.p50  = LatencyHistogram::percentile(counts, count, 0.50, o_stats.max);
+    o_stats.p95  = LatencyHistogram::percentile(counts, count, 0.95, o_stats.max);
+    o_stats.p99  = LatencyHistogram::percentile(counts, count, 0.99, o_stats.max);
+}
+
+
+double tracking::LatencyHistogram::percentile(const std::array<uint64_t, BUCKET_COUNT + 1>& counts, uint64_t count, double percent, double max) {
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percent * static_cast<double>(count)));
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        accumulated += counts[i];
+        if ((accumulated >= rank) && (accumulated > 0)) {
+            return static_cast<double>((i + 1) * BUCKET_WIDTH) / 1000000.0;
+        }
+    }
+    return max;
+}
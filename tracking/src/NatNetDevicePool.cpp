@@ -10,19 +10,89 @@
 tracking::NatNetDevicePool::NatNetDevicePool(void)
     : m_initialised(false)
     , m_connected(false)
+#ifdef TRACKING_NATNET_SDK
     , m_natnet_client(nullptr)
+#endif
+    , m_native_client(nullptr)
+    , m_decoder()
     , m_rigid_bodies()
+    , m_rigid_body_count(0)
+    , m_id_table()
+    , m_id_table_used(0)
+    , m_table_mutex()
+    , m_refresh_thread()
+    , m_refresh_mutex()
+    , m_refresh_cv()
+    , m_refresh_requested(false)
+    , m_subscription_requested(false)
+    , m_server_subscription(false)
+    , m_refresh_stop(false)
+    , m_frames()
+    , m_latencies()
+    , m_read_frame(-1)
+    , m_sequence()
     , m_callback_counter(0)
     , m_rigid_body_names()
+    , m_skeletons()
+    , m_skeleton_count(0)
+    , m_skeleton_names()
+    , m_server_version()
+    , m_cache()
+    , m_cache_valid(false)
+    , m_sources()
+    , m_merge_target(nullptr)
+    , m_source_orientation()
+    , m_source_position()
+    , m_source_transform(false)
+    , m_merging()
+    , m_source_handles()
+    , m_source_mapped()
+    , m_merge_time(0.0)
+    , m_merge_frame(0)
+    , m_servers()
+    , m_server_index(0)
+    , m_connect_time(0.0)
+    , m_failover_begin(0.0)
+    , m_failovers(0)
+    , m_failover_latency(0.0)
+    , m_failover_latency_max(0.0)
+    , m_link_lost(false)
+    , m_stale_changes(0)
+    , m_frame_signal(nullptr)
+    , m_reconnect_attempts(0)
+    , m_reconnect_time(0.0)
     , m_client_ip("129.69.205.76") // minyou
     , m_server_ip("129.69.205.86") // mini
     , m_cmd_port(1510)
     , m_data_port(1511)
     , m_con_type(NatNetDevicePool::ConnectionType::UniCast)
-    , m_verbose_client(false) {
-
-    // intentionally empty...
-
+    , m_multicast_ip()
+    , m_receive_buffer_size(0)
+    , m_verbose_client(false)
+#ifdef TRACKING_NATNET_SDK
+    , m_use_native_client(false)
+#else
+    , m_use_native_client(true)
+#endif
+    , m_prediction()
+    , m_subscription(false)
+    , m_connect_timeout(0.0f)
+    , m_cache_file()
+    , m_failover_timeout(0.0f) {
+
+    this->m_prediction.model             = tracking::PosePredictor::Model::None;
+    this->m_prediction.horizon           = 0.05f;
+    this->m_prediction.process_noise     = 500.0f;
+    this->m_prediction.measurement_noise = 0.0000005f;
+
+    // Allocate rigid body table once, rigid bodies are only (re)assigned on connect and refresh.
+    this->m_rigid_bodies.Allocate(MAX_RIGIDBODIES);
+    this->m_frames.Allocate(FRAME_POOL_SIZE);
+    this->m_rigid_body_names.Allocate(MAX_RIGIDBODIES); /// Names never move in memory.
+    this->m_skeletons.resize(MAX_SKELETONS);
+    this->m_skeleton_names.resize(MAX_SKELETONS);
+    this->unmap_rigid_bodies();
+    this->m_merging.clear();
 }
 
 
@@ -30,7 +100,7 @@ bool tracking::NatNetDevicePool::Initialise(const NatNetDevicePool::Params & par
 
     bool check = true;
     this->m_initialised = false;
-    this->m_natnet_client = nullptr;
+    this->Disconnect();
 
     std::string client_ip;
     try {
@@ -40,7 +110,7 @@ bool tracking::NatNetDevicePool::Initialise(const NatNetDevicePool::Params & par
                 "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
             check = false;
         }
-        if (client_ip.empty()) {
+        if (client_ip.empty() && (params.server_ip_len > 0)) {
             std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"client_ip\" must not be empty string. " <<
                 "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
             check = false;
@@ -60,8 +130,8 @@ bool tracking::NatNetDevicePool::Initialise(const NatNetDevicePool::Params & par
                 "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
             check = false;
         }
-        if (server_ip.empty()) {
-            std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"server_ip\" must not be empty string. " <<
+        if (server_ip.empty() && ((params.server_count > 0) || (params.standby_count > 0))) {
+            std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"server_ip\" must not be empty string with further or standby servers. " <<
                 "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
             check = false;
         }
@@ -72,6 +142,75 @@ bool tracking::NatNetDevicePool::Initialise(const NatNetDevicePool::Params & par
         check = false;
     }
 
+    std::string multicast_ip;
+    if (params.multicast_ip != nullptr) {
+        multicast_ip = std::string(params.multicast_ip);
+        if (multicast_ip.length() != params.multicast_ip_len) {
+            std::cerr << std::endl << "[ERROR] [NatNetClient] String \"multicast_ip\" has not expected length. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+        }
+    }
+
+    std::string cache_file;
+    if (params.cache_file != nullptr) {
+        cache_file = std::string(params.cache_file);
+        if (cache_file.length() != params.cache_file_len) {
+            std::cerr << std::endl << "[ERROR] [NatNetClient] String \"cache_file\" has not expected length. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+        }
+    }
+
+    if ((params.server_count > 0) && (params.servers == nullptr)) {
+        std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"servers\" must not be nullptr for \"server_count\" greater than 0. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+    for (size_t i = 0; check && (i < params.server_count); ++i) {
+        if (params.servers[i].server_ip == nullptr) {
+            std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"server_ip\" of further server " << i << " must not be nullptr. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+        }
+    }
+
+    if ((params.standby_count > 0) && (params.standby_servers == nullptr)) {
+        std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"standby_servers\" must not be nullptr for \"standby_count\" greater than 0. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+    std::vector<Server> servers;
+    for (size_t i = 0; check && (i < params.standby_count); ++i) {
+        const NatNetDevicePool::ServerParams& standby = params.standby_servers[i];
+        if ((standby.server_ip == nullptr) || (std::string(standby.server_ip).length() != standby.server_ip_len) || (standby.server_ip_len == 0)) {
+            std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"server_ip\" of standby server " << i << " must be a non empty string of expected length. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+            break;
+        }
+        if ((standby.cmd_port >= 65535) || (standby.data_port >= 65535)) {
+            std::cerr << std::endl << "[ERROR] [NatNetClient] Ports of standby server " << i << " must be less than 65535. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+            break;
+        }
+        Server server;
+        server.ip          = std::string(standby.server_ip);
+        server.cmd_port    = standby.cmd_port;
+        server.data_port   = standby.data_port;
+        server.orientation = glm::normalize(standby.orientation);
+        server.position    = standby.position;
+        server.transform   = true;
+        servers.emplace_back(server);
+    }
+
+    if (params.failover_timeout < 0.0f) {
+        std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"failover_timeout\" must not be negative. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+
     if (params.cmd_port >= 65535) {
         std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"cmd_port\" must be less than 65535. " <<
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
@@ -84,6 +223,24 @@ bool tracking::NatNetDevicePool::Initialise(const NatNetDevicePool::Params & par
         check = false;
     }
 
+    if ((params.prediction.model < tracking::PosePredictor::Model::None) || (params.prediction.model > tracking::PosePredictor::Model::ConstantAcceleration)) {
+        std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"prediction.model\" is unknown. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+
+    if ((params.prediction.horizon < 0.0f) || (params.prediction.process_noise < 0.0f) || (params.prediction.measurement_noise <= 0.0f)) {
+        std::cerr << std::endl << "[ERROR] [NatNetClient] Parameters \"prediction.horizon\" and \"prediction.process_noise\" must not be negative, \"prediction.measurement_noise\" must be positive. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+
+    if (params.connect_timeout < 0.0f) {
+        std::cerr << std::endl << "[ERROR] [NatNetClient] Parameter \"connect_timeout\" must not be negative. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+
     if (check) {
         this->m_callback_counter = 0;
         this->m_client_ip = client_ip;
@@ -92,10 +249,83 @@ bool tracking::NatNetDevicePool::Initialise(const NatNetDevicePool::Params & par
         this->m_cmd_port = params.cmd_port;
         this->m_data_port = params.data_port;
         this->m_con_type = params.con_type;
+        this->m_multicast_ip = multicast_ip;
+        this->m_receive_buffer_size = params.receive_buffer_size;
         this->m_verbose_client = params.verbose_client;
+#ifdef TRACKING_NATNET_SDK
+        this->m_use_native_client = params.native_client;
+#else
+        if (!params.native_client) {
+            std::cout << "[WARNING] [NatNetDevicePool] Built without NatNet SDK, using built-in NatNet client." << std::endl;
+        }
+        this->m_use_native_client = true;
+#endif
+        this->m_prediction = params.prediction;
+        this->m_subscription = params.subscription;
+        this->m_connect_timeout = params.connect_timeout;
+        this->m_cache_file = cache_file;
+        this->m_failover_timeout = params.failover_timeout;
+
+        // Priority list of servers, the server of params first.
+        Server server;
+        server.ip          = server_ip;
+        server.cmd_port    = params.cmd_port;
+        server.data_port   = params.data_port;
+        server.orientation = glm::quat();
+        server.position    = glm::vec3();
+        server.transform   = false;
+        servers.insert(servers.begin(), server);
+        this->m_servers = servers;
+        this->m_server_index.store(0);
 
         this->print_params();
         this->m_initialised = true;
+
+        // Each server is handled by its own pool if further servers are merged.
+        this->m_sources.clear();
+        for (size_t i = 0; (params.server_count > 0) && (i <= params.server_count); ++i) {
+            NatNetDevicePool::Params source_params = params;
+            source_params.subscription = false; /// Filtered when merging.
+            source_params.servers      = nullptr;
+            source_params.server_count = 0;
+            std::string source_cache_file = (cache_file.empty()) ? ("") : (cache_file + "." + std::to_string(i));
+            source_params.cache_file     = source_cache_file.c_str();
+            source_params.cache_file_len = source_cache_file.length();
+            if (i > 0) {
+                const NatNetDevicePool::ServerParams& server = params.servers[i - 1];
+                source_params.server_ip       = server.server_ip;
+                source_params.server_ip_len   = server.server_ip_len;
+                source_params.cmd_port        = server.cmd_port;
+                source_params.data_port       = server.data_port;
+                source_params.standby_servers = nullptr; /// Standby servers replace the first server only.
+                source_params.standby_count   = 0;
+            }
+
+            std::cout << "[INFO] [NatNetDevicePool] Initialising merged server " << i << " ..." << std::endl;
+            auto source = std::make_unique<NatNetDevicePool>();
+            if (!source->Initialise(source_params)) {
+                this->m_sources.clear();
+                this->m_initialised = false;
+                break;
+            }
+            source->m_merge_target = this;
+            if (i > 0) {
+                source->m_servers[0].orientation = glm::normalize(params.servers[i - 1].orientation);
+                source->m_servers[0].position    = params.servers[i - 1].position;
+                source->m_servers[0].transform   = true;
+            }
+            this->m_sources.emplace_back(std::move(source));
+        }
+        this->m_source_handles.assign(MAX_RIGIDBODIES * this->m_sources.size(), -1);
+        this->m_source_mapped.assign(this->m_sources.size(), 0);
+
+        // Rigid bodies of the last session can be resolved right away.
+        if (this->m_sources.empty()) {
+            this->load_cache();
+        }
+        else {
+            this->update_sources(); /// Sources are not connected yet.
+        }
     }
 
     return this->m_initialised;
@@ -108,7 +338,20 @@ void tracking::NatNetDevicePool::print_params(void) {
     std::cout << "[PARAMETER] [NatNetDevicePool] Command Port:            " << this->m_cmd_port << std::endl;
     std::cout << "[PARAMETER] [NatNetDevicePool] Data Port:               " << this->m_data_port << std::endl;
     std::cout << "[PARAMETER] [NatNetDevicePool] Connection Type:         " << (int)this->m_con_type << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Multicast Group:         " << ((this->m_multicast_ip.empty()) ? ("(announced by server)") : (this->m_multicast_ip.c_str())) << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Receive Buffer Size:     " << this->m_receive_buffer_size << std::endl;
     std::cout << "[PARAMETER] [NatNetDevicePool] Verbose NatNet client:   " << ((this->m_verbose_client)?("yes"):("no")) << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Built-in NatNet client:  " << ((this->m_use_native_client)?("yes"):("no")) << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Prediction Model:        " << (int)this->m_prediction.model << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Prediction Horizon:      " << this->m_prediction.horizon << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Prediction Noise:        " << this->m_prediction.process_noise << " (process) " << this->m_prediction.measurement_noise << " (measurement)" << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Subscription:            " << ((this->m_subscription)?("yes"):("no")) << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Connect Timeout:         " << this->m_connect_timeout << std::endl;
+    std::cout << "[PARAMETER] [NatNetDevicePool] Cache File:              " << ((this->m_cache_file.empty()) ? ("(disabled)") : (this->m_cache_file.c_str())) << std::endl;
+    for (size_t i = 1; i < this->m_servers.size(); ++i) {
+        std::cout << "[PARAMETER] [NatNetDevicePool] Standby Server " << i << ":        " << this->m_servers[i].ip.c_str() << ":" << this->m_servers[i].cmd_port << std::endl;
+    }
+    std::cout << "[PARAMETER] [NatNetDevicePool] Failover Timeout:        " << this->m_failover_timeout << std::endl;
 }
 
 
@@ -126,13 +369,332 @@ bool tracking::NatNetDevicePool::Connect(void) {
         return false;
     }
 
-    ::sServerDescription  server_desc;
-    ::sDataDescriptions  *data_desc   = nullptr;
-    ::ErrorCode           error_code  = ::ErrorCode_OK;
-
     // Terminate previous connection.
     this->Disconnect();
 
+    if (!this->m_sources.empty()) {
+        return this->connect_sources();
+    }
+
+    if (this->m_server_ip.empty()) {
+        std::cout << "[INFO] [NatNetDevicePool] No NatNet server, only external rigid bodies are available." << std::endl;
+        this->m_connected = true;
+        this->m_stale_changes++;
+        return this->m_connected;
+    }
+
+    // Servers are tried in order of priority.
+    bool connected = false;
+    for (size_t i = 0; !connected && (i < this->m_servers.size()); ++i) {
+        connected = this->open_server(i, true);
+    }
+    if (!connected) {
+        return false;
+    }
+
+    // Pick up rigid bodies added or removed while connected, send subscriptions and monitor frames.
+    this->m_failover_begin = 0.0;
+    this->m_reconnect_attempts = 0;
+    this->m_reconnect_time = 0.0;
+    this->m_link_lost.store(false);
+    this->m_refresh_stop = false;
+    this->m_refresh_thread = std::thread(&NatNetDevicePool::refresh, this);
+
+    this->m_connected = true;
+    this->m_stale_changes++;
+    return this->m_connected;
+}
+
+
+bool tracking::NatNetDevicePool::open_server(size_t index, bool reset) {
+
+    const Server& server = this->m_servers[index];
+    this->m_server_ip          = server.ip;
+    this->m_cmd_port           = server.cmd_port;
+    this->m_data_port          = server.data_port;
+    this->m_source_orientation = server.orientation;
+    this->m_source_position    = server.position;
+    this->m_source_transform   = server.transform;
+    this->m_server_index.store(index);
+    this->m_connect_time = tracking::GetLocalTime();
+
+    bool connected = false;
+    if (this->m_use_native_client) {
+        connected = this->connect_native();
+    }
+#ifdef TRACKING_NATNET_SDK
+    else {
+        connected = this->connect_sdk();
+    }
+#endif
+    if (!connected) {
+        return false;
+    }
+
+    // Look up data descriptions, cached descriptions are validated by the refresh thread once receiving.
+    std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription> rigid_bodies;
+    std::vector<tracking::NatNetPacketDecoder::SkeletonDescription> skeletons;
+    bool cached = (this->m_cache_valid && (this->m_cache.server_ip == this->m_server_ip) && (this->m_cache.cmd_port == this->m_cmd_port) &&
+        (this->m_cache.natnet_version == this->m_server_version));
+    if (cached) {
+        std::cout << "[INFO] [NatNetDevicePool] Using cached rigid bodies of \"" << this->m_cache_file.c_str() << "\" ..." << std::endl;
+        rigid_bodies = this->m_cache.rigid_bodies;
+        skeletons = this->m_cache.skeletons;
+    }
+    else {
+        std::cout << "[INFO] [NatNetDevicePool] Looking up rigid bodies ..." << std::endl;
+        if (!this->fetch_descriptions(rigid_bodies, skeletons)) {
+            this->close_server();
+            return false;
+        }
+        this->save_cache(rigid_bodies, skeletons);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->m_table_mutex);
+        this->unmap_rigid_bodies();
+        for (auto& rb : rigid_bodies) {
+            // Create new table entry for rigid body data
+            if (this->add_rigid_body(rb.id, rb.name, reset)) {
+                std::cout << "[INFO] [NatNetDevicePool] >>> PROVIDED RIGID BODY \"" << rb.name << "\"." << std::endl;
+            }
+        }
+        for (auto& skeleton : skeletons) {
+            if (this->add_skeleton(skeleton)) {
+                std::cout << "[INFO] [NatNetDevicePool] >>> PROVIDED SKELETON \"" << skeleton.name << "\" (" << skeleton.bones.size() << " bones)." << std::endl;
+            }
+        }
+    }
+
+    // Start receiving after rigid body table is complete.
+    this->m_sequence.Reset();
+    std::cout << "[INFO] [NatNetDevicePool] Registering callbacks ..." << std::endl;
+    if (this->m_use_native_client) {
+        if (!this->m_native_client->Start(NatNetDevicePool::on_packet, this)) {
+            this->close_server();
+            return false;
+        }
+    }
+#ifdef TRACKING_NATNET_SDK
+    else {
+        this->m_natnet_client->SetFrameReceivedCallback(NatNetDevicePool::on_data, const_cast<NatNetDevicePool *>(this));
+    }
+#endif
+
+    if (this->m_subscription && !this->m_server_subscription.load()) {
+        std::cout << "[INFO] [NatNetDevicePool] Server does not support subscriptions (requires NatNet 4.0 and unicast), filtering locally." << std::endl;
+    }
+
+    // Validate cached descriptions and send subscriptions (by refresh thread).
+    this->m_refresh_requested.store(cached);
+    this->m_subscription_requested.store(this->m_subscription && this->m_server_subscription.load());
+    return true;
+}
+
+
+void tracking::NatNetDevicePool::close_server(void) {
+
+    if (this->m_native_client != nullptr) {
+        this->m_native_client->Disconnect();
+        this->m_native_client.reset(nullptr);
+        std::cout << "[INFO] [NatNetDevicePool] Successfully disconnected from NatNet server." << std::endl;
+    }
+#ifdef TRACKING_NATNET_SDK
+    if (this->m_natnet_client != nullptr) {
+        ::ErrorCode error_code = this->m_natnet_client->Disconnect();
+        this->m_natnet_client.reset(nullptr);
+        if (error_code == ErrorCode_OK) {
+            std::cout << "[INFO] [NatNetDevicePool] Successfully disconnected from NatNet server." << std::endl;
+        }
+        else {
+            std::cerr << "[ERROR] [NatNetDevicePool] Disconnected from NatNet server. - NATNET ERROR CODE: " << (int)error_code << " (see NatNetTypes.h, line 115). " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        }
+    }
+#endif
+}
+
+
+bool tracking::NatNetDevicePool::check_failover(void) {
+
+    tracking::FrameSequence::Statistics stats;
+    this->m_sequence.GetStatistics(stats);
+
+    // Failover is complete with the first frame of the new server (the statistics still belong to the old server after failed attempts).
+    if ((this->m_failover_begin > 0.0) && (stats.first_receive_time > this->m_failover_begin)) {
+        double latency = stats.first_receive_time - this->m_failover_begin;
+        this->m_failover_latency.store(latency);
+        if (latency > this->m_failover_latency_max.load()) {
+            this->m_failover_latency_max.store(latency);
+        }
+        this->m_failover_begin = 0.0;
+        this->m_reconnect_attempts = 0;
+        this->m_reconnect_time = 0.0;
+        std::cout << "[INFO] [NatNetDevicePool] Failover completed after " << latency << " s without frames." << std::endl;
+    }
+
+    if (this->m_failover_timeout <= 0.0f) {
+        return false;
+    }
+    double now  = tracking::GetLocalTime();
+    double last = (stats.last_receive_time > 0.0) ? (stats.last_receive_time) : (this->m_connect_time);
+    return (((now - last) > static_cast<double>(this->m_failover_timeout)) && (now >= this->m_reconnect_time));
+}
+
+
+void tracking::NatNetDevicePool::failover(void) {
+
+    // Keep the begin of a pending failover, so the latency covers all attempts.
+    if (this->m_failover_begin <= 0.0) {
+        tracking::FrameSequence::Statistics stats;
+        this->m_sequence.GetStatistics(stats);
+        this->m_failover_begin = (stats.last_receive_time > 0.0) ? (stats.last_receive_time) : (this->m_connect_time);
+    }
+    size_t current = this->m_server_index.load();
+    size_t count   = this->m_servers.size();
+    std::cout << "[WARNING] [NatNetDevicePool] No frames from NatNet server " << this->m_server_ip.c_str() << " for " << this->m_failover_timeout <<
+        " s, " << ((count > 1) ? ("switching to next server") : ("reconnecting")) << " ..." << std::endl;
+    if (!this->m_link_lost.exchange(true)) {
+        this->m_stale_changes++;
+    }
+    this->close_server();
+
+    // Other servers in order of priority, the silent server last.
+    bool connected = false;
+    for (size_t i = 0; !connected && (i < count); ++i) {
+        size_t index = (i == count - 1) ? (current) : ((i < current) ? (i) : (i + 1));
+        connected = this->open_server(index, false);
+    }
+
+    // Delay the next attempt exponentially until frames arrive (a server responding without frames counts as failed).
+    double delay = static_cast<double>(this->m_failover_timeout) * static_cast<double>(1 << (std::min)(this->m_reconnect_attempts, 16));
+    if (delay > RECONNECT_DELAY_MAX) {
+        delay = RECONNECT_DELAY_MAX;
+    }
+    this->m_reconnect_attempts++;
+    this->m_reconnect_time = tracking::GetLocalTime() + delay;
+
+    if (connected) {
+        if (this->m_merge_target != nullptr) {
+            this->m_merge_target->update_sources();
+        }
+        this->m_failovers++;
+        std::cout << "[INFO] [NatNetDevicePool] Switched to NatNet server " << this->m_server_ip.c_str() << "." << std::endl;
+    }
+    else {
+        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] No NatNet server available, retrying in " << delay << " s. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+    }
+}
+
+
+bool tracking::NatNetDevicePool::is_stale(void) const {
+
+    if (!this->m_connected.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (this->m_sources.empty()) {
+        return this->m_link_lost.load(std::memory_order_relaxed);
+    }
+    for (auto& source : this->m_sources) {
+        if (!source->is_stale()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void tracking::NatNetDevicePool::GetFailoverStatistics(FailoverStatistics& o_stats) const {
+
+    if (!this->m_sources.empty()) {
+        this->m_sources[0]->GetFailoverStatistics(o_stats);
+        return;
+    }
+    o_stats.failovers    = this->m_failovers.load();
+    o_stats.server       = this->m_server_index.load();
+    o_stats.last_latency = this->m_failover_latency.load();
+    o_stats.max_latency  = this->m_failover_latency_max.load();
+}
+
+
+bool tracking::NatNetDevicePool::connect_sources(void) {
+
+    for (size_t i = 0; i < this->m_sources.size(); ++i) {
+        std::cout << "[INFO] [NatNetDevicePool] Connecting merged server " << i << " ..." << std::endl;
+        if (!this->m_sources[i]->Connect()) {
+            std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Failed to connect merged server " << i << ". " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            this->Disconnect();
+            return false;
+        }
+    }
+
+    // Sources are already merging, wait for the merging source to finish.
+    std::lock_guard<std::mutex> lock(this->m_table_mutex);
+    while (this->m_merging.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    this->m_merge_time = 0.0;
+    this->m_merge_frame = 0;
+    this->m_sequence.Reset();
+    this->map_sources();
+    this->m_merging.clear(std::memory_order_release);
+
+    this->m_connected = true;
+    this->m_stale_changes++;
+    return this->m_connected;
+}
+
+
+bool tracking::NatNetDevicePool::connect_native(void) {
+
+    tracking::NatNetNativeClient::Params connect_params;
+    connect_params.local_address       = this->m_client_ip;
+    connect_params.server_address      = this->m_server_ip;
+    connect_params.command_port        = static_cast<uint16_t>(this->m_cmd_port);
+    connect_params.data_port           = static_cast<uint16_t>(this->m_data_port);
+    connect_params.multicast           = (this->m_con_type == NatNetDevicePool::ConnectionType::MultiCast);
+    connect_params.multicast_address   = this->m_multicast_ip;
+    connect_params.receive_buffer_size = static_cast<size_t>(this->m_receive_buffer_size);
+    connect_params.timeout             = static_cast<double>(this->m_connect_timeout);
+
+    this->m_native_client = std::make_unique<tracking::NatNetNativeClient>();
+
+    std::cout << "[INFO] [NatNetDevicePool] Connecting to NatNet server (built-in client) ..." << std::endl;
+    sSender_Server server;
+    if (!this->m_native_client->Connect(connect_params, server)) {
+        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Failed to connect to NatNet server. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        this->m_native_client.reset(nullptr);
+        return false;
+    }
+
+    // Print some information on connection.
+    std::cout << "[INFO] [NatNetDevicePool] Successfully connected to NatNet server: " << this->m_server_ip << std::endl;
+    std::cout << "[INFO] [NatNetDevicePool] NatNet host application: " << server.Common.szName << " " <<
+        (int)server.Common.Version[0] << "." << (int)server.Common.Version[1] << "." <<
+        (int)server.Common.Version[2] << "." << (int)server.Common.Version[3] << std::endl;
+    std::cout << "[INFO] [NatNetDevicePool] Server side NatNet version: " << (int)server.Common.NatNetVersion[0] << "." <<
+        (int)server.Common.NatNetVersion[1] << "." << (int)server.Common.NatNetVersion[2] << "." <<
+        (int)server.Common.NatNetVersion[3] << std::endl;
+
+    if (!this->m_decoder.SetVersion(server.Common.NatNetVersion[0], server.Common.NatNetVersion[1])) {
+        this->m_native_client.reset(nullptr);
+        return false;
+    }
+    this->m_server_subscription.store((server.Common.NatNetVersion[0] >= 4) && !connect_params.multicast);
+    std::copy(server.Common.NatNetVersion, server.Common.NatNetVersion + 4, this->m_server_version.begin());
+
+    return true;
+}
+
+
+#ifdef TRACKING_NATNET_SDK
+bool tracking::NatNetDevicePool::connect_sdk(void) {
+
+    ::sServerDescription  server_desc;
+    ::ErrorCode           error_code  = ::ErrorCode_OK;
+
     // Print local natnet version.
     //unsigned char        version[4];
     //::NatNet_GetVersion(version);
@@ -145,11 +707,8 @@ bool tracking::NatNetDevicePool::Connect(void) {
     connect_params.serverAddress     = this->m_server_ip.c_str();
     connect_params.serverCommandPort = static_cast<uint16_t>(this->m_cmd_port);
     connect_params.serverDataPort    = static_cast<uint16_t>(this->m_data_port);
-    if (connect_params.connectionType == ::ConnectionType::ConnectionType_Multicast) {
-        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] MultiCast is currently not supported. " <<
-            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        return false;
-        //connect_params.multicastAddress = "224.0.0.1";
+    if ((connect_params.connectionType == ::ConnectionType::ConnectionType_Multicast) && !this->m_multicast_ip.empty()) {
+        connect_params.multicastAddress = this->m_multicast_ip.c_str();
     }
     
     // Create the natnet client.
@@ -182,6 +741,9 @@ bool tracking::NatNetDevicePool::Connect(void) {
         std::cout << "[INFO] [NatNetDevicePool] Server side NatNet version: " << (int)server_desc.NatNetVersion[0] << "." << 
             (int)server_desc.NatNetVersion[1] << "." << (int)server_desc.NatNetVersion[2] << "." <<
             (int)server_desc.NatNetVersion[3] << std::endl;
+
+        this->m_server_subscription.store((server_desc.NatNetVersion[0] >= 4) && (connect_params.connectionType == ::ConnectionType::ConnectionType_Unicast));
+        std::copy(server_desc.NatNetVersion, server_desc.NatNetVersion + 4, this->m_server_version.begin());
     }
     else {
         std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Failed to connect to NatNet server. - NATNET ERROR CODE: " << (int)error_code  << " (see NatNetTypes.h, line 115). " <<
@@ -190,9 +752,6 @@ bool tracking::NatNetDevicePool::Connect(void) {
         return false;
     }
 
-    // Register callback handlers.
-    std::cout << "[INFO] [NatNetDevicePool] Registering callbacks ..." << std::endl;
-    this->m_natnet_client->SetFrameReceivedCallback(NatNetDevicePool::on_data, const_cast<NatNetDevicePool *>(this));
     if (this->m_verbose_client) {
         NatNet_SetLogCallback(NatNetDevicePool::on_message);
     }
@@ -201,7 +760,13 @@ bool tracking::NatNetDevicePool::Connect(void) {
     float *frResponse  = nullptr;
     int    cntResponse = 0;
     // FrameRate
-    error_code = this->m_natnet_client->SendMessageAndWait("FrameRate", (void **)&frResponse, &cntResponse);
+    if (this->m_connect_timeout > 0.0f) {
+        error_code = this->m_natnet_client->SendMessageAndWait("FrameRate", SDK_REQUEST_ATTEMPTS, 
+            static_cast<int>(this->m_connect_timeout * 1000.0f / SDK_REQUEST_ATTEMPTS), (void **)&frResponse, &cntResponse);
+    }
+    else {
+        error_code = this->m_natnet_client->SendMessageAndWait("FrameRate", (void **)&frResponse, &cntResponse);
+    }
     if (error_code == ErrorCode_OK) {
         std::cout << "[INFO] [NatNetDevicePool] NatNet remote command test PASSED. Current framerate: " << (*frResponse) << std::endl;
     }
@@ -212,11 +777,37 @@ bool tracking::NatNetDevicePool::Connect(void) {
         return false;
     }
 
-    // Look up rigid body data descriptions.
-    this->m_rigid_body_names.clear();
-    std::cout << "[INFO] [NatNetDevicePool] Looking up rigid bodies ..." << std::endl;
-    error_code = this->m_natnet_client->GetDataDescriptionList(&data_desc);
-    if (error_code == ErrorCode_OK) {
+    return true;
+}
+#endif
+
+
+bool tracking::NatNetDevicePool::fetch_descriptions(std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& o_rigid_bodies,
+    std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& o_skeletons) {
+
+    o_rigid_bodies.clear();
+    o_skeletons.clear();
+
+    if (this->m_native_client != nullptr) {
+        std::vector<char> payload;
+        if (!this->m_native_client->RequestModelDef(payload) ||
+            !this->m_decoder.DecodeModelDef(payload.data(), payload.size(), o_rigid_bodies, o_skeletons)) {
+            std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Unable to retrieve rigid body data descriptions. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+#ifdef TRACKING_NATNET_SDK
+    if (this->m_natnet_client != nullptr) {
+        ::sDataDescriptions *data_desc = nullptr;
+        ::ErrorCode error_code = this->m_natnet_client->GetDataDescriptionList(&data_desc);
+        if ((error_code != ErrorCode_OK) || (data_desc == nullptr)) {
+            std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Unable to retrieve rigid body data descriptions. - NATNET ERROR CODE: " << (int)error_code << " (see NatNetTypes.h, line 115). " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return false;
+        }
         for (int i = 0; i < data_desc->nDataDescriptions; ++i) {
             if (data_desc->arrDataDescriptions[i].type == Descriptor_RigidBody) { // DataDescriptors
                 auto *rb = data_desc->arrDataDescriptions[i].Data.RigidBodyDescription;
@@ -225,69 +816,661 @@ bool tracking::NatNetDevicePool::Connect(void) {
                         "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
                     continue;
                 }
-                // Create new lock free ring for rigid body data
-                this->m_rigid_bodies.emplace_back(std::make_shared<RigidBody>(rb->ID, rb->szName));
-                this->m_rigid_body_names.emplace_back(this->m_rigid_bodies.back()->name);
-
-                std::cout << "[INFO] [NatNetDevicePool] >>> PROVIDED RIGID BODY \"" << this->m_rigid_bodies.back()->name.c_str() << "\"."<< std::endl;
+                tracking::NatNetPacketDecoder::RigidBodyDescription description;
+                description.name      = rb->szName;
+                description.id        = rb->ID;
+                description.parent_id = rb->parentID;
+                description.offset    = glm::vec3(rb->offsetx, rb->offsety, rb->offsetz);
+                o_rigid_bodies.emplace_back(description);
+            }
+            else if (data_desc->arrDataDescriptions[i].type == Descriptor_Skeleton) {
+                auto *sk = data_desc->arrDataDescriptions[i].Data.SkeletonDescription;
+                if (sk == nullptr) {
+                    continue;
+                }
+                tracking::NatNetPacketDecoder::SkeletonDescription skeleton;
+                skeleton.name = sk->szName;
+                skeleton.id   = sk->skeletonID;
+                for (int b = 0; (b < sk->nRigidBodies) && (b < MAX_SKELRIGIDBODIES); ++b) {
+                    tracking::NatNetPacketDecoder::RigidBodyDescription bone;
+                    bone.name      = sk->RigidBodies[b].szName;
+                    bone.id        = sk->RigidBodies[b].ID;
+                    bone.parent_id = sk->RigidBodies[b].parentID;
+                    bone.offset    = glm::vec3(sk->RigidBodies[b].offsetx, sk->RigidBodies[b].offsety, sk->RigidBodies[b].offsetz);
+                    skeleton.bones.emplace_back(bone);
+                }
+                o_skeletons.emplace_back(skeleton);
             }
         }
+        ::NatNet_FreeDescriptions(data_desc);
+        return true;
     }
-    else {
-        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Unable to retrieve rigid body data descriptions. - NATNET ERROR CODE: " << (int)error_code << " (see NatNetTypes.h, line 115). " <<
-            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        this->Disconnect();
-        return false;
-    }
-
-    this->m_connected = true;
-
-    return true;
+#endif
+    return false;
 }
 
 
-bool tracking::NatNetDevicePool::Disconnect(void) {
+void tracking::NatNetDevicePool::refresh(void) {
 
-    if (this->m_natnet_client != nullptr) {
-        ::ErrorCode error_code = this->m_natnet_client->Disconnect();
-        this->m_natnet_client.reset(nullptr);
-        if (error_code == ErrorCode_OK) {
-            std::cout << "[INFO] [NatNetDevicePool] Successfully disconnected from NatNet server." << std::endl;
+    double next_refresh = 0.0;
+    double next_subscription = 0.0;
+    std::unique_lock<std::mutex> lock(this->m_refresh_mutex);
+    while (!this->m_refresh_stop) {
+        // Requests are only signalled by flags (natnet callback never locks), so wake up periodically.
+        this->m_refresh_cv.wait_for(lock, std::chrono::milliseconds(100));
+        if (this->m_refresh_stop) {
+            break;
         }
-        else {
-            std::cerr << "[ERROR] [NatNetDevicePool] Disconnected from NatNet server. - NATNET ERROR CODE: " << (int)error_code << " (see NatNetTypes.h, line 115). " <<
-                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        // Switch to the next server after silence (reconnecting requests refresh and subscriptions as needed).
+        if (this->check_failover()) {
+            lock.unlock();
+            this->failover();
+            lock.lock();
+            continue;
+        }
+        // Limit rate of refreshes (e.g. for streaming IDs without description) and of retries after failed subscriptions.
+        bool refresh = ((tracking::GetLocalTime() >= next_refresh) && this->m_refresh_requested.exchange(false));
+        bool subscriptions = ((tracking::GetLocalTime() >= next_subscription) && this->m_subscription_requested.exchange(false));
+        if (!refresh && !subscriptions) {
+            continue;
+        }
+        lock.unlock();
+        if (refresh) {
+            next_refresh = tracking::GetLocalTime() + REFRESH_INTERVAL;
         }
-    }
 
-    // Clear rigid body data after disconnecting (otherwise callback for natnet might still be accessing data).
-    for (unsigned int i = 0; i < this->m_rigid_bodies.size(); ++i) {
-        this->m_rigid_bodies[i].reset();
+        std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription> rigid_bodies;
+        std::vector<tracking::NatNetPacketDecoder::SkeletonDescription> skeletons;
+        bool fetched = (refresh && this->fetch_descriptions(rigid_bodies, skeletons));
+        if (refresh && !fetched) {
+            this->m_refresh_requested.store(true); /// Retry after REFRESH_INTERVAL, the request must not get lost.
+        }
+        if (fetched) {
+            {
+                std::lock_guard<std::mutex> table_lock(this->m_table_mutex);
+                // Remove rigid bodies which are not streamed anymore or changed their streaming ID.
+                size_t count = this->m_rigid_body_count.load();
+                for (size_t i = 0; i < count; ++i) {
+                    int id = this->m_rigid_bodies[i].id;
+                    if (id < 0) {
+                        continue;
+                    }
+                    bool streamed = false;
+                    for (auto& rb : rigid_bodies) {
+                        if ((rb.id == id) && (rb.name == this->m_rigid_body_names[i])) {
+                            streamed = true;
+                            break;
+                        }
+                    }
+                    if (!streamed) {
+                        this->remove_rigid_body(i);
+                        std::cout << "[INFO] [NatNetDevicePool] >>> REMOVED RIGID BODY \"" << this->m_rigid_body_names[i] << "\"." << std::endl;
+                    }
+                }
+                // Add new rigid bodies, unchanged rigid bodies are not touched.
+                for (auto& rb : rigid_bodies) {
+                    if ((this->find_rigid_body(rb.id) < 0) && this->add_rigid_body(rb.id, rb.name, false)) {
+                        std::cout << "[INFO] [NatNetDevicePool] >>> ADDED RIGID BODY \"" << rb.name << "\"." << std::endl;
+                    }
+                }
+            }
+            // Rigid bodies of a source are mapped here instead of in the natnet callback (merging must not change the table).
+            if (this->m_merge_target != nullptr) {
+                this->m_merge_target->update_sources();
+            }
+            // Skeletons are only added while connecting (cached skeletons match the table).
+            if (this->m_cache_valid && !tracking::SessionCache::Equal(skeletons, this->m_cache.skeletons)) {
+                std::cout << "[WARNING] [NatNetDevicePool] Skeletons changed on the server, reconnect to pick them up." << std::endl;
+            }
+            this->save_cache(rigid_bodies, skeletons);
+        }
+        if (subscriptions && !this->update_subscriptions()) {
+            next_subscription = tracking::GetLocalTime() + REFRESH_INTERVAL;
+            this->m_subscription_requested.store(true);
+        }
+        lock.lock();
+    }
+}
+
+
+bool tracking::NatNetDevicePool::update_subscriptions(void) {
+
+    auto send = [this](const std::string& command) {
+        if (this->m_native_client != nullptr) {
+            std::vector<char> response;
+            return this->m_native_client->SendCommand(command, response);
+        }
+#ifdef TRACKING_NATNET_SDK
+        else if (this->m_natnet_client != nullptr) {
+            void* response = nullptr;
+            int   bytes    = 0;
+            return (this->m_natnet_client->SendMessageAndWait(command.c_str(), &response, &bytes) == ErrorCode_OK);
+        }
+#endif
+        return false;
+    };
+
+    // Subscriptions are disabled after a failed update, only restoring all data is retried.
+    if (!this->m_server_subscription.load()) {
+        return send("SubscribeToData,AllTypes,All");
+    }
+
+    // Subscriptions of the server are replaced as a whole (unsubscribe all, then subscribe each rigid body by name).
+    std::vector<std::string> commands;
+    commands.emplace_back("SubscribeToData,AllTypes,None");
+    size_t count = this->m_rigid_body_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (this->m_rigid_bodies[i].subscribers.load() > 0) {
+            commands.emplace_back("SubscribeToData,RigidBody," + this->m_rigid_body_names[i]);
+        }
+    }
+
+    for (auto& command : commands) {
+        if (!send(command)) {
+            // A partial update may leave the server streaming nothing, so restore all data and stop subscribing on this server.
+            this->m_server_subscription.store(false);
+            bool restored = send("SubscribeToData,AllTypes,All");
+            std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Unable to update subscriptions of the server, " <<
+                ((restored) ? ("filtering locally") : ("failed to restore streaming of all data")) << ". " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return restored;
+        }
+    }
+    std::cout << "[INFO] [NatNetDevicePool] Subscribed to " << (commands.size() - 1) << " rigid bodies." << std::endl;
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::SubscribeRigidBody(int rigid_body) {
+
+    if ((rigid_body < 0) || (static_cast<size_t>(rigid_body) >= this->m_rigid_body_count)) {
+        return false;
+    }
+    if (this->m_rigid_bodies[rigid_body].subscribers.fetch_add(1) == 0) {
+        this->m_subscription_requested.store(this->m_subscription && this->m_server_subscription.load());
+    }
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::UnsubscribeRigidBody(int rigid_body) {
+
+    if ((rigid_body < 0) || (static_cast<size_t>(rigid_body) >= this->m_rigid_body_count)) {
+        return false;
+    }
+    int subscribers = this->m_rigid_bodies[rigid_body].subscribers.load();
+    do {
+        if (subscribers <= 0) {
+            return false;
+        }
+    } while (!this->m_rigid_bodies[rigid_body].subscribers.compare_exchange_weak(subscribers, subscribers - 1));
+    if (subscribers == 1) {
+        this->m_subscription_requested.store(this->m_subscription && this->m_server_subscription.load());
+    }
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::Disconnect(void) {
+
+    // Sources stop merging before merged data is cleared.
+    for (auto& source : this->m_sources) {
+        source->Disconnect();
+    }
+
+    if (this->m_refresh_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->m_refresh_mutex);
+            this->m_refresh_stop = true;
+        }
+        this->m_refresh_cv.notify_all();
+        this->m_refresh_thread.join();
+    }
+
+    this->close_server();
+
+    // Clear rigid body data after disconnecting (otherwise callback for natnet might still be accessing data).
+    // Frames still held by readers stay valid until they are released.
+    this->m_frames.Clear();
+    this->unmap_rigid_bodies();
+
+    if (this->m_connected.exchange(false)) {
+        this->m_stale_changes++;
+    }
+
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::add_rigid_body(int id, const std::string& name, bool reset) {
+
+    if (this->find_rigid_body(id) >= 0) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Duplicate streaming ID " << id << ", ignoring \"" << name.c_str() << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    if (this->m_id_table_used >= ID_TABLE_SIZE - 1) { /// At least one empty entry terminates each lookup.
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Streaming ID table is full (reconnect to reclaim removed entries), ignoring \"" << name.c_str() << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Keep table index (= handle) and latest pose of already known rigid bodies.
+    int index = this->find_rigid_body(name);
+    if (index < 0) {
+        index = this->append_rigid_body(name);
+        if (index < 0) {
+            return false;
+        }
+    }
+    else if (this->m_rigid_bodies[index].id >= 0) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Duplicate rigid body name, ignoring \"" << name.c_str() << "\" with streaming ID " << id << ". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    else if (reset && !this->m_rigid_bodies[index].external) { /// Predictor of external rigid bodies is updated by their device.
+        this->m_rigid_bodies[index].predictor.Configure(this->m_prediction);
+    }
+    this->m_rigid_bodies[index].id = id;
+
+    // Insert into open addressing table (linear probing), removed entries are not reused.
+    size_t h = static_cast<size_t>(id) & (ID_TABLE_SIZE - 1);
+    while (this->m_id_table[h].index.load(std::memory_order_relaxed) != ID_EMPTY) {
+        h = (h + 1) & (ID_TABLE_SIZE - 1);
+    }
+    this->m_id_table[h].id.store(id, std::memory_order_relaxed);
+    this->m_id_table[h].index.store(index, std::memory_order_release);
+    this->m_id_table_used++;
+
+    return true;
+}
+
+
+int tracking::NatNetDevicePool::append_rigid_body(const std::string& name) {
+
+    size_t count = this->m_rigid_body_count.load();
+    if (count >= this->m_rigid_bodies.Size()) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Maximum number of rigid bodies exceeded, ignoring \"" << name.c_str() << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return -1;
+    }
+
+    RigidBodyData data;
+    data.orientation   = glm::quat();
+    data.position      = glm::vec3();
+    data.frame         = -1;
+    data.timestamp     = 0.0;
+    data.exposure_time = 0.0;
+    data.receive_time  = 0.0;
+    data.mean_error    = 0.0f;
+    data.stale         = false;
+
+    // New entry is not visible to readers before the count is published.
+    int index = static_cast<int>(count);
+    auto& rb = this->m_rigid_bodies[index];
+    rb.history.Allocate(HISTORY_SIZE);
+    rb.data.Store(data);
+    rb.predictor.Configure(this->m_prediction);
+    this->m_rigid_body_names[index] = name;
+    this->m_rigid_body_count.store(count + 1, std::memory_order_release);
+    return index;
+}
+
+
+void tracking::NatNetDevicePool::map_sources(void) {
+
+    size_t source_count = this->m_sources.size();
+    for (size_t s = 0; s < source_count; ++s) {
+        const NatNetDevicePool& source = *this->m_sources[s];
+        size_t count = source.GetRigidBodyCount();
+        for (size_t h = this->m_source_mapped[s]; h < count; ++h) {
+            const std::string& name = source.m_rigid_body_names[h];
+            int index = this->find_rigid_body(name);
+            if (index < 0) {
+                index = this->append_rigid_body(name);
+                if (index < 0) {
+                    continue;
+                }
+                std::cout << "[INFO] [NatNetDevicePool] >>> MERGED RIGID BODY \"" << name << "\"." << std::endl;
+            }
+            this->m_source_handles[static_cast<size_t>(index) * source_count + s] = static_cast<int>(h);
+        }
+        this->m_source_mapped[s] = count;
+    }
+}
+
+
+void tracking::NatNetDevicePool::update_sources(void) {
+
+    std::lock_guard<std::mutex> lock(this->m_table_mutex);
+    while (this->m_merging.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    this->map_sources();
+    this->m_merging.clear(std::memory_order_release);
+}
+
+
+void tracking::NatNetDevicePool::merge_sources(double time) {
+
+    // Merged data has a single writer at a time, the merging source covers this frame.
+    if (this->m_merging.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+
+    if (time > this->m_merge_time) {
+        this->m_merge_time = time;
+
+        double receive_time = tracking::GetLocalTime();
+        this->m_merge_frame++;
+        this->m_sequence.Accept(this->m_merge_frame, receive_time);
+        RigidBodyData data;
+        FrameData* frame = this->begin_frame(this->m_merge_frame, time, time, 0.0, receive_time, data);
+
+        size_t source_count = this->m_sources.size();
+        size_t count = this->m_rigid_body_count.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            if ((this->m_subscription && (this->m_rigid_bodies[i].subscribers.load(std::memory_order_relaxed) == 0)) ||
+                this->m_rigid_bodies[i].external) {
+                continue;
+            }
+            // Select the source with the lowest mean error of all sources which tracked the rigid body recently.
+            int best_handle = -1;
+            size_t best_source = 0;
+            float best_error = (std::numeric_limits<float>::max)();
+            for (size_t s = 0; s < source_count; ++s) {
+                int handle = this->m_source_handles[i * source_count + s];
+                if (handle < 0) {
+                    continue;
+                }
+                RigidBodyData latest;
+                this->m_sources[s]->m_rigid_bodies[handle].data.Load(latest);
+                if ((latest.frame >= 0) && ((time - latest.exposure_time) <= MERGE_MAX_AGE) && (latest.mean_error < best_error)) {
+                    best_handle = handle;
+                    best_source = s;
+                    best_error = latest.mean_error;
+                }
+            }
+            // Align pose of the selected source to the merged frame.
+            if ((best_handle >= 0) && this->m_sources[best_source]->GetPoseAt(best_handle, time, data)) {
+                data.frame = this->m_merge_frame;
+                this->store_rigid_body(frame, static_cast<int>(i), data);
+            }
+        }
+        this->end_frame(frame);
+    }
+
+    this->m_merging.clear(std::memory_order_release);
+}
+
+
+bool tracking::NatNetDevicePool::load_cache(void) {
+
+    this->m_cache_valid = false;
+    if (this->m_cache_file.empty() || !tracking::SessionCache::Read(this->m_cache_file, this->m_cache)) {
+        return false;
+    }
+    if ((this->m_cache.server_ip != this->m_server_ip) || (this->m_cache.cmd_port != this->m_cmd_port)) {
+        std::cout << "[INFO] [NatNetDevicePool] Ignoring cache \"" << this->m_cache_file.c_str() << "\" of other server " << this->m_cache.server_ip.c_str() << "." << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->m_table_mutex);
+    for (auto& rb : this->m_cache.rigid_bodies) {
+        this->add_rigid_body(rb.id, rb.name, true);
+    }
+    for (auto& skeleton : this->m_cache.skeletons) {
+        this->add_skeleton(skeleton);
+    }
+    std::cout << "[INFO] [NatNetDevicePool] Loaded " << this->m_cache.rigid_bodies.size() << " rigid bodies and " << 
+        this->m_cache.skeletons.size() << " skeletons from cache \"" << this->m_cache_file.c_str() << "\"." << std::endl;
+    this->m_cache_valid = true;
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::save_cache(const std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& rigid_bodies,
+    const std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& skeletons) {
+
+    // The cache holds the descriptions of the server of params only.
+    if (this->m_cache_file.empty() || (this->m_server_index.load() != 0)) {
+        return false;
+    }
+    if (this->m_cache_valid && (this->m_cache.natnet_version == this->m_server_version) &&
+        tracking::SessionCache::Equal(rigid_bodies, this->m_cache.rigid_bodies) && tracking::SessionCache::Equal(skeletons, this->m_cache.skeletons)) {
+        return true;
+    }
+
+    this->m_cache.server_ip      = this->m_server_ip;
+    this->m_cache.cmd_port       = static_cast<uint16_t>(this->m_cmd_port);
+    this->m_cache.natnet_version = this->m_server_version;
+    this->m_cache.rigid_bodies   = rigid_bodies;
+    this->m_cache.skeletons      = skeletons;
+    this->m_cache_valid = tracking::SessionCache::Write(this->m_cache_file, this->m_cache);
+    return this->m_cache_valid;
+}
+
+
+void tracking::NatNetDevicePool::remove_rigid_body(size_t index) {
+
+    int id = this->m_rigid_bodies[index].id;
+    size_t h = static_cast<size_t>(id) & (ID_TABLE_SIZE - 1);
+    for (size_t i = 0; i < ID_TABLE_SIZE; ++i) {
+        int entry = this->m_id_table[h].index.load(std::memory_order_relaxed);
+        if (entry == ID_EMPTY) {
+            break;
+        }
+        if ((entry == static_cast<int>(index)) && (this->m_id_table[h].id.load(std::memory_order_relaxed) == id)) {
+            this->m_id_table[h].index.store(ID_REMOVED, std::memory_order_release);
+            break;
+        }
+        h = (h + 1) & (ID_TABLE_SIZE - 1);
+    }
+    this->m_rigid_bodies[index].id = -1;
+}
+
+
+bool tracking::NatNetDevicePool::add_skeleton(const tracking::NatNetPacketDecoder::SkeletonDescription& description) {
+
+    if (this->find_skeleton(description.id) >= 0) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Duplicate skeleton ID " << description.id << ", ignoring \"" << description.name.c_str() << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Published skeletons are immutable (consumers read them without lock), known skeletons keep their handle and bones.
+    if (this->ResolveSkeleton(description.name) >= 0) {
+        if (!this->map_skeleton(description)) {
+            std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Bones of skeleton \"" << description.name.c_str() << "\" changed, ignoring it until restart. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return false;
+        }
+        return true;
+    }
+    size_t published = this->m_skeleton_count.load(std::memory_order_relaxed);
+    if (published >= MAX_SKELETONS) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Maximum number of skeletons exceeded, ignoring \"" << description.name.c_str() << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Bone hierarchy (bone IDs are small, so they index the lookup directly)
+    Skeleton& sk = this->m_skeletons[published];
+    this->m_skeleton_names[published] = description.name;
+    size_t count = description.bones.size();
+    sk.id = description.id;
+    sk.bone_names.resize(count);
+    sk.parents.assign(count, -1);
+    sk.order.clear();
+    sk.bone_index.clear();
+    sk.offsets.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& bone = description.bones[i];
+        int id = bone.id & 0xFFFF;
+        if (static_cast<size_t>(id) >= sk.bone_index.size()) {
+            sk.bone_index.resize(static_cast<size_t>(id) + 1, -1);
+        }
+        sk.bone_index[id] = static_cast<int>(i);
+        sk.bone_names[i] = bone.name;
+        sk.offsets[i] = glm::mat4(1.0f);
+        sk.offsets[i][3] = glm::vec4(bone.offset, 1.0f);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int parent = description.bones[i].parent_id;
+        if ((parent >= 0) && (static_cast<size_t>(parent & 0xFFFF) < sk.bone_index.size())) {
+            sk.parents[i] = sk.bone_index[parent & 0xFFFF];
+        }
+    }
+
+    // Order bones parents first (breadth first from the roots)
+    std::vector<bool> added(count, false);
+    for (size_t i = 0; i < count; ++i) {
+        if ((sk.parents[i] < 0) || (sk.parents[i] == static_cast<int>(i))) {
+            sk.parents[i] = -1;
+            sk.order.push_back(static_cast<int>(i));
+            added[i] = true;
+        }
+    }
+    for (size_t o = 0; o < sk.order.size(); ++o) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!added[i] && (sk.parents[i] == sk.order[o])) {
+                sk.order.push_back(static_cast<int>(i));
+                added[i] = true;
+            }
+        }
+    }
+    if (sk.order.size() != count) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Bone hierarchy of skeleton \"" << description.name.c_str() << "\" contains cycles, treating remaining bones as roots. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        for (size_t i = 0; i < count; ++i) {
+            if (!added[i]) {
+                sk.parents[i] = -1;
+                sk.order.push_back(static_cast<int>(i));
+            }
+        }
+    }
+
+    // New entry is not visible to readers before the count is published.
+    this->m_skeleton_count.store(published + 1, std::memory_order_release);
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::map_skeleton(const tracking::NatNetPacketDecoder::SkeletonDescription& description) {
+
+    int index = this->ResolveSkeleton(description.name);
+    if ((index < 0) || (this->find_skeleton(description.id) >= 0)) {
+        return false;
+    }
+
+    // Bones have to match by name and ID, the hierarchy and offsets of the table are kept.
+    Skeleton& sk = this->m_skeletons[index];
+    if (sk.bone_names.size() != description.bones.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < description.bones.size(); ++i) {
+        const auto& bone = description.bones[i];
+        size_t id = static_cast<size_t>(bone.id & 0xFFFF);
+        if ((bone.name != sk.bone_names[i]) || (id >= sk.bone_index.size()) || (sk.bone_index[id] != static_cast<int>(i))) {
+            return false;
+        }
+    }
+    sk.id = description.id;
+    return true;
+}
+
+
+void tracking::NatNetDevicePool::unmap_rigid_bodies(void) {
+
+    for (auto& entry : this->m_id_table) {
+        entry.id.store(0, std::memory_order_relaxed);
+        entry.index.store(ID_EMPTY, std::memory_order_release);
+    }
+    this->m_id_table_used = 0;
+    size_t count = this->m_rigid_body_count.load();
+    for (size_t i = 0; i < count; ++i) {
+        this->m_rigid_bodies[i].id = -1;
+    }
+    size_t skeleton_count = this->m_skeleton_count.load();
+    for (size_t i = 0; i < skeleton_count; ++i) {
+        this->m_skeletons[i].id = -1;
+    }
+}
+
+
+int tracking::NatNetDevicePool::ResolveSkeleton(const std::string& skeleton) const {
+
+    size_t count = this->GetSkeletonCount();
+    for (size_t i = 0; i < count; ++i) {
+        if (this->m_skeleton_names[i] == skeleton) {
+            return static_cast<int>(i);
+        }
     }
-    this->m_rigid_bodies.clear();
+    return -1;
+}
+
 
-    this->m_connected = false;
+bool tracking::NatNetDevicePool::GetSkeletonBones(int skeleton, std::vector<std::string>& o_names, std::vector<int>& o_parents) const {
 
+    if ((skeleton < 0) || (static_cast<size_t>(skeleton) >= this->GetSkeletonCount())) {
+        return false;
+    }
+    o_names = this->m_skeletons[skeleton].bone_names;
+    o_parents = this->m_skeletons[skeleton].parents;
     return true;
 }
 
 
-glm::quat tracking::NatNetDevicePool::GetOrientation(const std::string& rigid_body) {
+size_t tracking::NatNetDevicePool::GetSkeletonBoneMatrices(int skeleton, size_t capacity, glm::mat4* o_matrices, int& o_frame) {
+
+    o_frame = -1;
+    FramePtr frame = this->GetLatestFrame();
+    if (!frame || (skeleton < 0) || (static_cast<size_t>(skeleton) >= frame->skeletons.size()) || (o_matrices == nullptr)) {
+        return 0;
+    }
+    const SkeletonData& data = frame->skeletons[skeleton];
+    if (data.frame < 0) {
+        return 0;
+    }
+    size_t count = (std::min)(capacity, data.bones.size());
+    std::copy(data.bones.begin(), data.bones.begin() + count, o_matrices);
+    o_frame = data.frame;
+    return count;
+}
+
+
+int tracking::NatNetDevicePool::find_rigid_body(const std::string& name) const {
+
+    size_t count = this->m_rigid_body_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (this->m_rigid_body_names[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+
+bool tracking::NatNetDevicePool::GetRigidBodyData(int rigid_body, RigidBodyData& o_data) {
 
-    glm::quat ret_orientation((std::numeric_limits<float>::max)(),
+    o_data.orientation = glm::quat((std::numeric_limits<float>::max)(),
         (std::numeric_limits<float>::max)(),
         (std::numeric_limits<float>::max)(),
         (std::numeric_limits<float>::max)());
+    o_data.position = glm::vec3((std::numeric_limits<float>::max)(),
+        (std::numeric_limits<float>::max)(),
+        (std::numeric_limits<float>::max)());
+    o_data.frame = -1;
+    o_data.timestamp = 0.0;
+    o_data.exposure_time = 0.0;
+    o_data.receive_time = 0.0;
+    o_data.mean_error = 0.0f;
+    o_data.stale = false;
 
     if (!this->m_initialised) {
         std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Not initialised. " <<
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        return ret_orientation;
-    }
-    if (!this->m_connected) {
-        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Not connected. " <<
-            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        return ret_orientation;
+        return false;
     }
 
     // Check for updated data
@@ -304,62 +1487,451 @@ glm::quat tracking::NatNetDevicePool::GetOrientation(const std::string& rigid_bo
         this->m_callback_counter = 0;
     }
 #endif
-   
-    for (auto& it : this->m_rigid_bodies) {
-        if (rigid_body == it->name) {
-            ret_orientation = it->lockFreeData[it->read.load()].orientation;
-            break;
-        }
+
+    if ((rigid_body < 0) || (static_cast<size_t>(rigid_body) >= this->m_rigid_body_count)) {
+        return false;
     }
-    
-    return ret_orientation;
+    // The latest pose survives disconnects and reconnects, it is only flagged stale meanwhile.
+    // External rigid bodies carry their own stale flag.
+    this->m_rigid_bodies[rigid_body].data.Load(o_data);
+    if (!this->m_rigid_bodies[rigid_body].external) {
+        o_data.stale = this->is_stale();
+    }
+    // Polling consumers read the same frame many times, only the first read counts.
+    if ((o_data.frame >= 0) && !o_data.stale && (this->m_rigid_bodies[rigid_body].read_frame.exchange(o_data.frame) != o_data.frame)) {
+        this->m_latencies[ReceiveToRead].Record(tracking::GetLocalTime() - o_data.receive_time);
+    }
+
+    return true;
 }
 
 
-glm::vec3 tracking::NatNetDevicePool::GetPosition(const std::string& rigid_body) {
+bool tracking::NatNetDevicePool::GetPredictedRigidBodyData(int rigid_body, double time, RigidBodyData& o_data) {
 
-    glm::vec3 ret_position((std::numeric_limits<float>::max)(),
-        (std::numeric_limits<float>::max)(),
-        (std::numeric_limits<float>::max)());
+    if (!this->GetRigidBodyData(rigid_body, o_data)) {
+        return false;
+    }
+    if ((time >= 0.0) && (o_data.frame >= 0) && !o_data.stale && (this->m_prediction.model != tracking::PosePredictor::Model::None)) {
+        this->m_rigid_bodies[rigid_body].predictor.Predict(time, o_data.position, o_data.orientation);
+    }
+    return true;
+}
+
+
+uint64_t tracking::NatNetDevicePool::GetRigidBodySequence(int rigid_body) const {
+
+    if ((rigid_body < 0) || (static_cast<size_t>(rigid_body) >= this->m_rigid_body_count)) {
+        return 0;
+    }
+    uint64_t sequence = this->m_rigid_bodies[rigid_body].history.GetEnd() + this->m_stale_changes.load();
+    for (auto& source : this->m_sources) {
+        sequence += source->m_stale_changes.load();
+    }
+    return sequence;
+}
+
+
+int tracking::NatNetDevicePool::AddExternalRigidBody(const std::string& rigid_body) {
 
     if (!this->m_initialised) {
         std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Not initialised. " <<
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        return ret_position;
+        return -1;
     }
-    if (!this->m_connected) {
-        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Not connected. " <<
+    if (rigid_body.empty()) {
+        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Name of external rigid body must not be empty string. " <<
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        return ret_position;
+        return -1;
     }
 
-    // Check for updated data
-#ifdef TRACKING_DEBUG_OUTPUT
-    std::cout << "[DEBUG]  [NatNetDevicePool] Callback Counter = " << this->m_callback_counter << std::endl;
-    if (this->m_callback_counter <= 0) {
-        this->m_callback_counter--;
-        if (this->m_callback_counter < -10) {
-        std::cout << std::endl << "[DEBUG] [NatNetDevicePool] Didn't receive updated tracking data yet. " <<
-            ">>> Please check your firewall settings if this warning appears repeatedly! ." << std::endl;
+    // Keep handle of rigid bodies already known from the cache or a previous connection.
+    std::lock_guard<std::mutex> lock(this->m_table_mutex);
+    int index = this->find_rigid_body(rigid_body);
+    if (index < 0) {
+        index = this->append_rigid_body(rigid_body);
+        if (index < 0) {
+            return -1;
         }
     }
+    this->m_rigid_bodies[index].external = true;
+    std::cout << "[INFO] [NatNetDevicePool] >>> EXTERNAL RIGID BODY \"" << rigid_body.c_str() << "\"." << std::endl;
+    return index;
+}
+
+
+bool tracking::NatNetDevicePool::StoreExternalRigidBodyData(int rigid_body, const RigidBodyData& data) {
+
+    if ((rigid_body < 0) || (static_cast<size_t>(rigid_body) >= this->m_rigid_body_count) || !this->m_rigid_bodies[rigid_body].external) {
+        return false;
+    }
+
+    // Stale data only flags the latest pose, the sequence number changes after the data (see GetRigidBodySequence()).
+    auto& rb = this->m_rigid_bodies[rigid_body];
+    RigidBodyData latest;
+    rb.data.Load(latest);
+    bool stale = latest.stale;
+    if (data.stale) {
+        latest.stale = true;
+        rb.data.Store(latest);
+    }
     else {
+        this->store_rigid_body(nullptr, rigid_body, data);
+    }
+    if (stale != data.stale) {
+        this->m_stale_changes++;
+    }
+    if (this->m_frame_signal != nullptr) {
+        this->m_frame_signal->Notify();
+    }
+    return true;
+}
+
+
+bool tracking::NatNetDevicePool::GetPoseAt(int rigid_body, double time, RigidBodyData& o_data) const {
+
+    if ((rigid_body < 0) || (static_cast<size_t>(rigid_body) >= this->m_rigid_body_count)) {
+        return false;
+    }
+    const auto& history = this->m_rigid_bodies[rigid_body].history;
+
+    // Search backwards from the latest pose for the poses enclosing the requested time.
+    RigidBodyData newer;
+    RigidBodyData older;
+    bool has_newer = false;
+    uint64_t position = history.GetEnd();
+    while (position > 0) {
+        --position;
+        if (!history.Get(position, older)) {
+            break; /// Reached poses which are already overwritten.
+        }
+        if (older.exposure_time <= time) {
+            if (!has_newer) {
+                o_data = older; /// Requested time is after latest pose.
+                return true;
+            }
+            double span = newer.exposure_time - older.exposure_time;
+            float  t    = (span > 0.0) ? (static_cast<float>((time - older.exposure_time) / span)) : (1.0f);
+            o_data = (t < 0.5f) ? (older) : (newer);
+            o_data.position      = glm::mix(older.position, newer.position, t);
+            o_data.orientation   = glm::slerp(older.orientation, newer.orientation, t);
+            o_data.timestamp     = older.timestamp + (newer.timestamp - older.timestamp) * static_cast<double>(t);
+            o_data.exposure_time = time;
+            return true;
+        }
+        newer = older;
+        has_newer = true;
+    }
+
+    if (has_newer) {
+        o_data = newer; /// Requested time is before oldest pose.
+        return true;
+    }
+    return false;
+}
+
+
+size_t tracking::NatNetDevicePool::CopyMarkers(size_t capacity, float* o_x, float* o_y, float* o_z, float* o_size, float* o_residual,
+    int32_t* o_id, int16_t* o_params, int& o_frame) {
+
+    o_frame = -1;
+    FramePtr frame = this->GetLatestFrame();
+    if (!frame) {
+        return 0;
+    }
+
+    const MarkerData& m = frame->markers;
+    size_t count = (std::min)(capacity, m.count);
+    if (o_x != nullptr)        std::memcpy(o_x,        m.x.data(),        count * sizeof(float));
+    if (o_y != nullptr)        std::memcpy(o_y,        m.y.data(),        count * sizeof(float));
+    if (o_z != nullptr)        std::memcpy(o_z,        m.z.data(),        count * sizeof(float));
+    if (o_size != nullptr)     std::memcpy(o_size,     m.size.data(),     count * sizeof(float));
+    if (o_residual != nullptr) std::memcpy(o_residual, m.residual.data(), count * sizeof(float));
+    if (o_id != nullptr)       std::memcpy(o_id,       m.id.data(),       count * sizeof(int32_t));
+    if (o_params != nullptr)   std::memcpy(o_params,   m.params.data(),   count * sizeof(int16_t));
+    o_frame = frame->frame;
+    return count;
+}
+
+
+bool tracking::NatNetDevicePool::GetLatencyStatistics(LatencyStage stage, tracking::LatencyHistogram::Statistics& o_stats) const {
+
+    if ((stage < 0) || (stage >= LATENCY_STAGE_COUNT)) {
+        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Unknown latency stage " << (int)stage << ". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    this->m_latencies[stage].GetStatistics(o_stats);
+    return true;
+}
+
+
+void tracking::NatNetDevicePool::ResetLatencyStatistics(void) {
+
+    for (auto& l : this->m_latencies) {
+        l.Reset();
+    }
+}
+
+
+tracking::NatNetDevicePool::FrameData* tracking::NatNetDevicePool::begin_frame(int frame, double timestamp,
+    double exposure_time, double transmit_time, double receive_time, RigidBodyData& o_data) {
+
+    // Host times are zero if the host application does not provide them.
+    if ((exposure_time != 0.0) && (transmit_time != 0.0)) {
+        this->m_latencies[ExposureToTransmit].Record(transmit_time - exposure_time);
+    }
+    if (transmit_time != 0.0) {
+        this->m_latencies[TransmitToReceive].Record(receive_time - transmit_time);
+    }
+    if (exposure_time == 0.0) {
+        exposure_time = receive_time;
+    }
+    if (transmit_time == 0.0) {
+        transmit_time = receive_time;
+    }
+
+#ifdef TRACKING_DEBUG_OUTPUT
+    // Simple counter to be able to check if callback has been called
+    this->m_callback_counter++;
+    // Prevent overflow
+    if ((this->m_callback_counter > ((std::numeric_limits<int>::max)() - 2)) || 
+        (this->m_callback_counter < ((std::numeric_limits<int>::min)() + 2))) {
         this->m_callback_counter = 0;
     }
 #endif
 
-    for (auto& it : this->m_rigid_bodies) { 
-        if (rigid_body == it->name) {
-            ret_position = it->lockFreeData[it->read.load()].position;
-            break;
+    o_data.orientation   = glm::quat();
+    o_data.position      = glm::vec3();
+    o_data.frame         = frame;
+    o_data.timestamp     = timestamp;
+    o_data.exposure_time = exposure_time;
+    o_data.receive_time  = receive_time;
+    o_data.mean_error    = 0.0f;
+    o_data.stale         = false;
+
+    // Get free frame for publishing all rigid bodies of this frame at once.
+    FrameData* frame_data = this->m_frames.BeginWrite();
+    if (frame_data != nullptr) {
+        RigidBodyData untracked;
+        untracked.orientation = glm::quat((std::numeric_limits<float>::max)(),
+            (std::numeric_limits<float>::max)(),
+            (std::numeric_limits<float>::max)(),
+            (std::numeric_limits<float>::max)());
+        untracked.position = glm::vec3((std::numeric_limits<float>::max)(),
+            (std::numeric_limits<float>::max)(),
+            (std::numeric_limits<float>::max)());
+        untracked.frame = -1;
+        untracked.timestamp = 0.0;
+        untracked.exposure_time = 0.0;
+        untracked.receive_time = 0.0;
+        untracked.mean_error = 0.0f;
+        untracked.stale = false;
+
+        frame_data->frame = frame;
+        frame_data->timestamp = timestamp;
+        frame_data->exposure_time = exposure_time;
+        frame_data->transmit_time = transmit_time;
+        frame_data->receive_time = receive_time;
+        frame_data->rigid_bodies.assign(this->m_rigid_body_count, untracked); /// Only allocates if number of rigid bodies has grown.
+        frame_data->markers.count = 0;
+        size_t skeleton_count = this->m_skeleton_count.load(std::memory_order_relaxed);
+        frame_data->skeletons.resize(skeleton_count);
+        for (size_t i = 0; i < skeleton_count; ++i) {
+            frame_data->skeletons[i].frame = -1;
+            frame_data->skeletons[i].bones.resize(this->m_skeletons[i].parents.size()); /// Only allocates if number of bones has grown.
+        }
+    }
+    return frame_data;
+}
+
+
+void tracking::NatNetDevicePool::write_rigid_body(FrameData* frame, int id, const RigidBodyData& data) {
+
+    // Set data for current rigid body (O(1) lookup by streaming ID)
+    int index = this->find_rigid_body(id);
+    if (index < 0) {
+        this->request_refresh();
+        return;
+    }
+
+    // Skip rigid bodies nobody subscribed to or fed by other devices before copying any data.
+    if ((this->m_subscription && (this->m_rigid_bodies[index].subscribers.load(std::memory_order_relaxed) == 0)) ||
+        this->m_rigid_bodies[index].external) {
+        return;
+    }
+
+    // Poses of merged servers are transformed into the merged coordinates.
+    if (this->m_source_transform) {
+        RigidBodyData transformed = data;
+        transformed.position    = this->m_source_orientation * data.position + this->m_source_position;
+        transformed.orientation = this->m_source_orientation * data.orientation;
+        this->store_rigid_body(frame, index, transformed);
+    }
+    else {
+        this->store_rigid_body(frame, index, data);
+    }
+}
+
+
+void tracking::NatNetDevicePool::store_rigid_body(FrameData* frame, int index, const RigidBodyData& data) {
+
+    // Publish complete data at once
+    auto& rb = this->m_rigid_bodies[index];
+    rb.data.Store(data);
+    rb.history.Push(data);
+    if (this->m_prediction.model != tracking::PosePredictor::Model::None) {
+        rb.predictor.Update(data.position, data.orientation, data.exposure_time);
+    }
+    if ((frame != nullptr) && (static_cast<size_t>(index) < frame->rigid_bodies.size())) {
+        frame->rigid_bodies[index] = data;
+    }
+}
+
+
+int tracking::NatNetDevicePool::begin_skeleton(FrameData* frame, int id) {
+
+    int index = this->find_skeleton(id);
+    if ((frame == nullptr) || (index < 0) || (static_cast<size_t>(index) >= frame->skeletons.size())) {
+        return -1;
+    }
+    SkeletonData& data = frame->skeletons[index];
+    const Skeleton& sk = this->m_skeletons[index];
+    std::copy(sk.offsets.begin(), sk.offsets.end(), data.bones.begin());
+    data.frame = frame->frame;
+    return index;
+}
+
+
+void tracking::NatNetDevicePool::write_bone(FrameData* frame, int skeleton, int id, const glm::vec3& position, const glm::quat& orientation) {
+
+    const Skeleton& sk = this->m_skeletons[skeleton];
+    size_t bone_id = static_cast<size_t>(id & 0xFFFF);
+    if ((bone_id >= sk.bone_index.size()) || (sk.bone_index[bone_id] < 0)) {
+        return;
+    }
+    glm::mat4& local = frame->skeletons[skeleton].bones[sk.bone_index[bone_id]];
+    local = glm::mat4_cast(orientation);
+    local[3] = glm::vec4(position, 1.0f);
+}
+
+
+void tracking::NatNetDevicePool::end_skeleton(FrameData* frame, int skeleton) {
+
+    // Compose parent chains in place, each parent is already in world space (O(bones)).
+    const Skeleton& sk = this->m_skeletons[skeleton];
+    std::vector<glm::mat4>& bones = frame->skeletons[skeleton].bones;
+    for (int i : sk.order) {
+        int parent = sk.parents[i];
+        if (parent >= 0) {
+            bones[i] = bones[parent] * bones[i];
         }
     }
+}
+
+
+void tracking::NatNetDevicePool::end_frame(FrameData* frame) {
 
-    return ret_position;
+    // Frames arrive again after a lost link.
+    if (this->m_link_lost.load(std::memory_order_relaxed) && this->m_link_lost.exchange(false)) {
+        this->m_stale_changes++;
+    }
+
+    // Publish complete frame at once
+    if (frame != nullptr) {
+        double time = frame->exposure_time;
+        this->m_frames.Publish();
+        if (this->m_merge_target != nullptr) {
+            this->m_merge_target->merge_sources(time);
+        }
+    }
+
+    // Wake up consumers waiting for the frame (the rigid bodies are stored even without published frame).
+    if (this->m_frame_signal != nullptr) {
+        this->m_frame_signal->Notify();
+    }
 }
 
 
+void __cdecl tracking::NatNetDevicePool::on_packet(const char* payload, size_t size, double receive_time, void* pUserData) {
 
+    auto that = static_cast<NatNetDevicePool *>(pUserData);
+    if ((that == nullptr) || (that->m_native_client == nullptr)) {
+        std::cerr << std::endl << "[ERROR] [NatNetDevicePool] Pointer to userData is NULL. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return;
+    }
+
+    tracking::NatNetPacketDecoder::Frame packet;
+    if (!that->m_decoder.DecodeFrame(payload, size, packet)) {
+        std::cerr << std::endl << "[WARNING] [NatNetDevicePool] Dropping malformed frame. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return;
+    }
+
+    // Drop duplicate and out of order frames (e.g. reordered UDP packets).
+    if (!that->m_sequence.Accept(packet.frame, receive_time)) {
+        return;
+    }
+
+    // Convert host timestamps to local time (clock offset is synchronised by the built-in client).
+    double exposure_time = 0.0;
+    double transmit_time = 0.0;
+    if ((packet.mid_exposure_timestamp != 0) && (packet.transmit_timestamp != 0)) {
+        exposure_time = that->m_native_client->HostToLocalTime(packet.mid_exposure_timestamp);
+        transmit_time = that->m_native_client->HostToLocalTime(packet.transmit_timestamp);
+    }
+
+    if ((packet.params & 0x02) != 0) {
+        that->request_refresh(); /// Tracked models changed.
+    }
+
+    RigidBodyData rb_data;
+    FrameData* frame = that->begin_frame(packet.frame, packet.timestamp, exposure_time, transmit_time, receive_time, rb_data);
+
+    // Rigid bodies are read directly from the packet.
+    tracking::NatNetPacketDecoder::RigidBody rb;
+    for (int32_t i = 0; i < packet.rigid_body_count; ++i) {
+        tracking::NatNetPacketDecoder::ReadRigidBody(packet.rigid_bodies + static_cast<size_t>(i) * tracking::NatNetPacketDecoder::RIGID_BODY_SIZE, rb);
+        if ((rb.params & 0x01) == 0) {
+            continue; /// Not tracked in this frame.
+        }
+        rb_data.orientation = rb.orientation;
+        rb_data.position    = rb.position;
+        rb_data.mean_error  = rb.mean_error;
+        that->write_rigid_body(frame, rb.id, rb_data);
+    }
+
+    // Skeletons, bones are read directly from the packet (dropped with subscription).
+    const char* record = packet.skeletons;
+    for (int32_t i = 0; (frame != nullptr) && !that->m_subscription && (i < packet.skeleton_count); ++i) {
+        int32_t skeleton_id = 0;
+        int32_t bone_count = 0;
+        record = tracking::NatNetPacketDecoder::ReadSkeleton(record, skeleton_id, bone_count);
+        int skeleton = that->begin_skeleton(frame, skeleton_id);
+        for (int32_t b = 0; (skeleton >= 0) && (b < bone_count); ++b) {
+            tracking::NatNetPacketDecoder::ReadRigidBody(record + static_cast<size_t>(b) * tracking::NatNetPacketDecoder::RIGID_BODY_SIZE, rb);
+            if ((rb.params & 0x01) != 0) {
+                that->write_bone(frame, skeleton, rb.id, rb.position, rb.orientation);
+            }
+        }
+        if (skeleton >= 0) {
+            that->end_skeleton(frame, skeleton);
+        }
+        record += static_cast<size_t>(bone_count) * tracking::NatNetPacketDecoder::RIGID_BODY_SIZE;
+    }
+
+    // Labeled markers (including unlabeled markers flagged in params).
+    tracking::NatNetPacketDecoder::LabeledMarker marker;
+    for (int32_t i = 0; (frame != nullptr) && !that->m_subscription && (i < packet.labeled_marker_count); ++i) {
+        tracking::NatNetPacketDecoder::ReadLabeledMarker(packet.labeled_markers + static_cast<size_t>(i) * tracking::NatNetPacketDecoder::LABELED_MARKER_SIZE, marker);
+        that->write_marker(frame, marker.id, marker.position, marker.size, marker.params, marker.residual);
+    }
+
+    that->end_frame(frame);
+}
+
+
+#ifdef TRACKING_NATNET_SDK
 void __cdecl tracking::NatNetDevicePool::on_data(sFrameOfMocapData *pFrameOfData, void *pUserData) {
 
 	auto that = static_cast<NatNetDevicePool *>(pUserData);
@@ -369,15 +1941,29 @@ void __cdecl tracking::NatNetDevicePool::on_data(sFrameOfMocapData *pFrameOfData
         return;
     }
 
-#ifdef TRACKING_DEBUG_OUTPUT
-    // Simple counter to be able to check if callback has been called
-    that->m_callback_counter++;
-    // Prevent overflow
-    if ((that->m_callback_counter > ((std::numeric_limits<int>::max)() - 2)) || 
-        (that->m_callback_counter < ((std::numeric_limits<int>::min)() + 2))) {
-        that->m_callback_counter = 0;
+    // Convert host timestamps to local time (clock offset is synchronised by the natnet client).
+    // Timestamps are zero if the host application does not provide them.
+    double receive_time  = tracking::GetLocalTime();
+    if (!that->m_sequence.Accept(pFrameOfData->iFrame, receive_time)) {
+        return; /// Duplicate or out of order frame.
+    }
+    double exposure_time = 0.0;
+    double transmit_time = 0.0;
+    if (that->m_natnet_client != nullptr) {
+        if (pFrameOfData->CameraMidExposureTimestamp != 0) {
+            exposure_time = receive_time - that->m_natnet_client->SecondsSinceHostTimestamp(pFrameOfData->CameraMidExposureTimestamp);
+        }
+        if (pFrameOfData->TransmitTimestamp != 0) {
+            transmit_time = receive_time - that->m_natnet_client->SecondsSinceHostTimestamp(pFrameOfData->TransmitTimestamp);
+        }
+    }
+
+    if ((pFrameOfData->params & 0x02) != 0) {
+        that->request_refresh(); /// Tracked models changed.
     }
-#endif
+
+    RigidBodyData rb_data;
+    FrameData* frame = that->begin_frame(pFrameOfData->iFrame, pFrameOfData->fTimestamp, exposure_time, transmit_time, receive_time, rb_data);
 
     for (int i = 0; i < pFrameOfData->nRigidBodies; ++i) {
         // All zero seems to be an indicator that the rigid body is not
@@ -399,37 +1985,42 @@ void __cdecl tracking::NatNetDevicePool::on_data(sFrameOfMocapData *pFrameOfData
 #endif
 
         if (is_valid) {
-            sRigidBodyData data = pFrameOfData->RigidBodies[i];
-
-            // Set data for current rigid body
-            for (auto& it : that->m_rigid_bodies) {
-                if (data.ID == it->id) {
-
-                    // Write new data to object with index denoted as 'write'
-                    it->lockFreeData[it->write.load()].orientation.x = data.qx;
-                    it->lockFreeData[it->write.load()].orientation.y = data.qy;
-                    it->lockFreeData[it->write.load()].orientation.z = data.qz;
-                    it->lockFreeData[it->write.load()].orientation.w = data.qw;
-
-                    it->lockFreeData[it->write.load()].position.x = data.x;
-                    it->lockFreeData[it->write.load()].position.y = data.y;
-                    it->lockFreeData[it->write.load()].position.z = data.z;
+            const sRigidBodyData& data = pFrameOfData->RigidBodies[i];
+            rb_data.orientation.x = data.qx;
+            rb_data.orientation.y = data.qy;
+            rb_data.orientation.z = data.qz;
+            rb_data.orientation.w = data.qw;
+            rb_data.position.x    = data.x;
+            rb_data.position.y    = data.y;
+            rb_data.position.z    = data.z;
+            rb_data.mean_error    = data.MeanError;
+            that->write_rigid_body(frame, data.ID, rb_data);
+        }
+    }
 
-                    // Determine index of currently unused free object
-                    unsigned int free = (it->read.load() + 1) % 3;
-                    free = (it->write.load() == free) ? ((it->write.load() + 1) % 3) : (free);
-#ifdef TRACKING_DEBUG_OUTPUT
-                    //std::cout << "[DEBUG] [NatNetDevicePool] READ = " << it->read.load() << " - WRTIE = " << it->write.load() << " - FREE = " << free << "." << std::endl;
-#endif
-                    // Swap lock free read/write buffers
-                    it->read.store(it->write.load());
-                    it->write.store(free);
-                    
-                    break; /// Break loop if rigid body is found
-                }
+    // Skeletons (dropped with subscription)
+    for (int i = 0; (frame != nullptr) && !that->m_subscription && (i < pFrameOfData->nSkeletons); ++i) {
+        const sSkeletonData& data = pFrameOfData->Skeletons[i];
+        int skeleton = that->begin_skeleton(frame, data.skeletonID);
+        if (skeleton < 0) {
+            continue;
+        }
+        for (int b = 0; b < data.nRigidBodies; ++b) {
+            const sRigidBodyData& bone = data.RigidBodyData[b];
+            if ((bone.params & 0x01) != 0) {
+                that->write_bone(frame, skeleton, bone.ID, glm::vec3(bone.x, bone.y, bone.z), glm::quat(bone.qw, bone.qx, bone.qy, bone.qz));
             }
         }
+        that->end_skeleton(frame, skeleton);
+    }
+
+    // Labeled markers (including unlabeled markers flagged in params, which also cover the deprecated other markers).
+    for (int i = 0; (frame != nullptr) && !that->m_subscription && (i < pFrameOfData->nLabeledMarkers); ++i) {
+        const sMarker& marker = pFrameOfData->LabeledMarkers[i];
+        that->write_marker(frame, marker.ID, glm::vec3(marker.x, marker.y, marker.z), marker.size, marker.params, marker.residual);
     }
+
+    that->end_frame(frame);
 }
 
 
@@ -444,4 +2035,4 @@ void __cdecl tracking::NatNetDevicePool::on_message(Verbosity level, const char
         default: break;
     }
 }
-
+#endif
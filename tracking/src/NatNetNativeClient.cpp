@@ -0,0 +1,534 @@
+/**
+ * NatNetNativeClient.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetNativeClient.h"
+
+#ifndef _WIN32
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR   (-1)
+#define closesocket    close
+#endif
+
+
+const char* const tracking::NatNetNativeClient::DEFAULT_MULTICAST_ADDRESS = "239.255.42.99";
+
+
+namespace {
+
+    /** Default timeout for responses of the server in seconds (per attempt). */
+    const double RESPONSE_TIMEOUT = 0.5;
+
+    /** Number of attempts for requests to the server. */
+    const int REQUEST_ATTEMPTS = 4;
+
+    /** Interval of keep alive and clock synchronisation messages in seconds. */
+    const double KEEP_ALIVE_INTERVAL = 1.0;
+
+    /** Factor the round trip time of the current clock offset grows per synchronisation (accepts newer estimates over time). */
+    const double CLOCK_RTT_AGING = 1.1;
+
+    /** Get local time in nanoseconds (payload of echo requests). */
+    inline uint64_t local_time_ns(void) {
+        return static_cast<uint64_t>(tracking::GetLocalTime() * 1000000000.0);
+    }
+}
+
+
+tracking::NatNetNativeClient::NatNetNativeClient(void)
+    : m_command_socket(INVALID_SOCKET)
+    , m_data_socket(INVALID_SOCKET)
+    , m_server_address()
+    , m_multicast(false)
+    , m_response_timeout(RESPONSE_TIMEOUT)
+    , m_thread()
+    , m_running(false)
+    , m_callback(nullptr)
+    , m_user_data(nullptr)
+    , m_clock_frequency(0)
+    , m_clock_offset(0.0)
+    , m_clock_synchronised(false)
+    , m_clock_rtt(0.0)
+    , m_buffers()
+    , m_response_mutex()
+    , m_response_cv()
+    , m_response()
+    , m_response_message(0)
+    , m_response_ready(false) {
+
+#ifdef _WIN32
+    WSADATA wsa_data;
+    WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+}
+
+
+tracking::NatNetNativeClient::~NatNetNativeClient(void) {
+
+    this->Disconnect();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+
+bool tracking::NatNetNativeClient::Connect(const NatNetNativeClient::Params& params, sSender_Server& o_server) {
+
+    this->Disconnect();
+    this->m_response_timeout = (params.timeout > 0.0) ? (params.timeout / REQUEST_ATTEMPTS) : (RESPONSE_TIMEOUT);
+
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = 0;
+    if (inet_pton(AF_INET, params.local_address.c_str(), &local.sin_addr) != 1) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Invalid local address \"" << params.local_address << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    std::memset(&this->m_server_address, 0, sizeof(this->m_server_address));
+    this->m_server_address.sin_family = AF_INET;
+    this->m_server_address.sin_port = htons(params.command_port);
+    if (inet_pton(AF_INET, params.server_address.c_str(), &this->m_server_address.sin_addr) != 1) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Invalid server address \"" << params.server_address << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Open command socket (ephemeral port, the server replies to the sender)
+    this->m_command_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if ((this->m_command_socket == INVALID_SOCKET) ||
+        (bind(this->m_command_socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) == SOCKET_ERROR)) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Failed to open command socket on \"" << params.local_address << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        this->Disconnect();
+        return false;
+    }
+    this->m_buffers.resize(RECEIVE_BATCH_SIZE * RECEIVE_BUFFER_SIZE);
+
+    // Request server info
+    sSender sender;
+    std::memset(&sender, 0, sizeof(sender));
+    std::strncpy(sender.szName, "tracking", MAX_NAMELENGTH - 1);
+    sender.NatNetVersion[0] = 3;
+    sender.NatNetVersion[1] = 0;
+
+    std::vector<char> payload;
+    bool connected = false;
+    for (int i = 0; (i < REQUEST_ATTEMPTS) && !connected; ++i) {
+        connected = (this->send_message(this->m_command_socket, NAT_CONNECT, &sender, sizeof(sender)) &&
+            this->wait_for_message(NAT_SERVERINFO, this->m_response_timeout, payload));
+    }
+    if (!connected || !NatNetPacketDecoder::DecodeServerInfo(payload.data(), payload.size(), o_server)) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] No response from server \"" << params.server_address << ":" << params.command_port << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        this->Disconnect();
+        return false;
+    }
+    if (o_server.IsMulticast != params.multicast) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Server streams " << ((o_server.IsMulticast) ? ("multicast") : ("unicast")) <<
+            ", which does not match the requested connection type. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        this->Disconnect();
+        return false;
+    }
+    this->m_clock_frequency = o_server.HighResClockFrequency;
+
+    if (!this->open_data_socket(params, o_server)) {
+        this->Disconnect();
+        return false;
+    }
+    return true;
+}
+
+
+bool tracking::NatNetNativeClient::open_data_socket(const NatNetNativeClient::Params& params, const sSender_Server& server) {
+
+    this->m_multicast = params.multicast;
+    this->m_data_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (this->m_data_socket == INVALID_SOCKET) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Failed to open data socket. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    int buffer_size = static_cast<int>((params.receive_buffer_size > 0) ? (params.receive_buffer_size) : (RECEIVE_BATCH_SIZE * RECEIVE_BUFFER_SIZE));
+    if (setsockopt(this->m_data_socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&buffer_size), sizeof(buffer_size)) == SOCKET_ERROR) {
+        std::cerr << std::endl << "[WARNING] [NatNetNativeClient] Failed to set receive buffer size to " << buffer_size << " bytes. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+    }
+
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    inet_pton(AF_INET, params.local_address.c_str(), &local.sin_addr);
+
+    if (!this->m_multicast) {
+        // Bind to ephemeral port and register data socket as unicast receiver
+        local.sin_port = 0;
+        if (bind(this->m_data_socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) == SOCKET_ERROR) {
+            std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Failed to bind data socket on \"" << params.local_address << "\". " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return false;
+        }
+        return this->send_message(this->m_data_socket, NAT_KEEPALIVE, nullptr, 0);
+    }
+
+    // Multicast group: parameter, group announced by server or default group
+    ip_mreq membership;
+    std::memset(&membership, 0, sizeof(membership));
+    membership.imr_interface = local.sin_addr;
+    bool announced = ((server.MulticastGroupAddress[0] | server.MulticastGroupAddress[1] | server.MulticastGroupAddress[2] | server.MulticastGroupAddress[3]) != 0);
+    std::string group = params.multicast_address;
+    if (group.empty()) {
+        if (announced) {
+            group = std::to_string(server.MulticastGroupAddress[0]) + "." + std::to_string(server.MulticastGroupAddress[1]) + "." +
+                std::to_string(server.MulticastGroupAddress[2]) + "." + std::to_string(server.MulticastGroupAddress[3]);
+        }
+        else {
+            group = DEFAULT_MULTICAST_ADDRESS;
+        }
+    }
+    if (inet_pton(AF_INET, group.c_str(), &membership.imr_multiaddr) != 1) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Invalid multicast address \"" << group << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Several clients on one host share the data port
+    int reuse = 1;
+    setsockopt(this->m_data_socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+#ifdef SO_REUSEPORT
+    setsockopt(this->m_data_socket, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+#endif
+    sockaddr_in any;
+    std::memset(&any, 0, sizeof(any));
+    any.sin_family = AF_INET;
+    any.sin_addr.s_addr = htonl(INADDR_ANY);
+    any.sin_port = htons((server.DataPort != 0) ? (server.DataPort) : (params.data_port));
+    if (bind(this->m_data_socket, reinterpret_cast<const sockaddr*>(&any), sizeof(any)) == SOCKET_ERROR) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Failed to bind data socket to port " << ntohs(any.sin_port) << ". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    if (setsockopt(this->m_data_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<const char*>(&membership), sizeof(membership)) == SOCKET_ERROR) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Failed to join multicast group \"" << group << "\" on interface \"" << params.local_address << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    std::cout << "[INFO] [NatNetNativeClient] Joined multicast group " << group << ":" << ntohs(any.sin_port) << " on interface " << params.local_address << "." << std::endl;
+    return true;
+}
+
+
+bool tracking::NatNetNativeClient::RequestModelDef(std::vector<char>& o_payload) {
+
+    if (!this->request(NAT_REQUEST_MODELDEF, nullptr, 0, NAT_MODELDEF, o_payload)) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] No model definitions received. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool tracking::NatNetNativeClient::SendCommand(const std::string& command, std::vector<char>& o_response) {
+
+    if (!this->request(NAT_REQUEST, command.c_str(), command.length() + 1, NAT_RESPONSE, o_response)) {
+        std::cerr << std::endl << "[WARNING] [NatNetNativeClient] Command \"" << command.c_str() << "\" was not accepted by the server. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool tracking::NatNetNativeClient::request(uint16_t message, const void* payload, size_t size, uint16_t response, std::vector<char>& o_payload) {
+
+    if (this->m_command_socket == INVALID_SOCKET) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Requests can only be sent after connecting. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    for (int i = 0; i < REQUEST_ATTEMPTS; ++i) {
+        if (!this->m_running.load()) {
+            if (this->send_message(this->m_command_socket, message, payload, size) &&
+                this->wait_for_message(response, this->m_response_timeout, o_payload)) {
+                return true;
+            }
+            continue;
+        }
+        // Receive thread owns the command socket, wait for it to hand over the response.
+        std::unique_lock<std::mutex> lock(this->m_response_mutex);
+        this->m_response_ready = false;
+        this->m_response_message = response;
+        if (this->send_message(this->m_command_socket, message, payload, size) &&
+            this->m_response_cv.wait_for(lock, std::chrono::duration<double>(this->m_response_timeout), [this]() { return this->m_response_ready; })) {
+            if (this->m_response_message != response) {
+                return false; /// Unrecognized request, retrying does not help.
+            }
+            o_payload.swap(this->m_response);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool tracking::NatNetNativeClient::Start(FrameCallback callback, void* user_data) {
+
+    if (this->m_running.load() || (this->m_data_socket == INVALID_SOCKET) || (callback == nullptr)) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Client is not connected or already started. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Data socket is drained until it would block
+#ifdef _WIN32
+    u_long non_blocking = 1;
+    ioctlsocket(this->m_data_socket, FIONBIO, &non_blocking);
+#else
+    fcntl(this->m_data_socket, F_SETFL, fcntl(this->m_data_socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    this->m_callback = callback;
+    this->m_user_data = user_data;
+    this->m_clock_synchronised.store(false);
+    this->m_clock_rtt = (std::numeric_limits<double>::max)();
+    this->m_running.store(true);
+    this->m_thread = std::thread(&NatNetNativeClient::receive, this);
+    return true;
+}
+
+
+void tracking::NatNetNativeClient::Disconnect(void) {
+
+    this->m_running.store(false);
+    if (this->m_thread.joinable()) {
+        this->m_thread.join();
+    }
+    if (this->m_command_socket != INVALID_SOCKET) {
+        this->send_message(this->m_command_socket, NAT_DISCONNECT, nullptr, 0);
+    }
+    NatNetNativeClient::close_socket(this->m_command_socket);
+    NatNetNativeClient::close_socket(this->m_data_socket);
+    this->m_clock_synchronised.store(false);
+}
+
+
+double tracking::NatNetNativeClient::HostToLocalTime(uint64_t ticks) const {
+
+    if (!this->IsClockSynchronised() || (this->m_clock_frequency == 0)) {
+        return 0.0;
+    }
+    return static_cast<double>(ticks) / static_cast<double>(this->m_clock_frequency) + this->m_clock_offset.load(std::memory_order_acquire);
+}
+
+
+void tracking::NatNetNativeClient::receive(void) {
+
+    double last_keep_alive = 0.0;
+    char* buffers = this->m_buffers.data();
+
+#ifdef __linux__
+    std::array<mmsghdr, RECEIVE_BATCH_SIZE> messages;
+    std::array<iovec, RECEIVE_BATCH_SIZE> vectors;
+    for (size_t i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+        vectors[i].iov_base = buffers + i * RECEIVE_BUFFER_SIZE;
+        vectors[i].iov_len = RECEIVE_BUFFER_SIZE;
+        std::memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+
+    while (this->m_running.load()) {
+
+        // Keep unicast stream alive and synchronise clocks
+        double now = tracking::GetLocalTime();
+        if ((now - last_keep_alive) >= KEEP_ALIVE_INTERVAL) {
+            uint64_t request = local_time_ns();
+            if (!this->m_multicast) {
+                this->send_message(this->m_data_socket, NAT_KEEPALIVE, nullptr, 0);
+            }
+            this->send_message(this->m_command_socket, NAT_ECHOREQUEST, &request, sizeof(request));
+            last_keep_alive = now;
+        }
+
+        bool data_ready = false;
+        bool command_ready = false;
+        if (!this->wait_readable(0.1, false, data_ready, command_ready)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        if (command_ready) {
+            int bytes = recv(this->m_command_socket, buffers, static_cast<int>(RECEIVE_BUFFER_SIZE), 0);
+            if (bytes > 0) {
+                this->on_command(buffers, static_cast<size_t>(bytes), tracking::GetLocalTime());
+            }
+        }
+
+        if (data_ready) {
+            uint16_t message = 0;
+            const char* payload = nullptr;
+            size_t payload_size = 0;
+#ifdef __linux__
+            // Receive all pending frames at once
+            int count = 0;
+            while ((count = recvmmsg(this->m_data_socket, messages.data(), static_cast<unsigned int>(RECEIVE_BATCH_SIZE), MSG_DONTWAIT, nullptr)) > 0) {
+                double receive_time = tracking::GetLocalTime();
+                for (int i = 0; i < count; ++i) {
+                    const char* packet = buffers + static_cast<size_t>(i) * RECEIVE_BUFFER_SIZE;
+                    if (NatNetPacketDecoder::DecodeHeader(packet, messages[i].msg_len, message, payload, payload_size) && (message == NAT_FRAMEOFDATA)) {
+                        this->m_callback(payload, payload_size, receive_time, this->m_user_data);
+                    }
+                }
+            }
+#else
+            int bytes = 0;
+            while ((bytes = recv(this->m_data_socket, buffers, static_cast<int>(RECEIVE_BUFFER_SIZE), 0)) > 0) {
+                double receive_time = tracking::GetLocalTime();
+                if (NatNetPacketDecoder::DecodeHeader(buffers, static_cast<size_t>(bytes), message, payload, payload_size) && (message == NAT_FRAMEOFDATA)) {
+                    this->m_callback(payload, payload_size, receive_time, this->m_user_data);
+                }
+            }
+#endif
+        }
+    }
+}
+
+
+bool tracking::NatNetNativeClient::send_message(SocketType socket, uint16_t message, const void* payload, size_t size) {
+
+    char packet[4 + MAX_NAMELENGTH + 64];
+    if ((socket == INVALID_SOCKET) || (size > (sizeof(packet) - 4))) {
+        return false;
+    }
+    uint16_t bytes = static_cast<uint16_t>(size);
+    std::memcpy(packet, &message, sizeof(uint16_t));
+    std::memcpy(packet + 2, &bytes, sizeof(uint16_t));
+    if (size > 0) {
+        std::memcpy(packet + 4, payload, size);
+    }
+    int sent = sendto(socket, packet, static_cast<int>(4 + size), 0, reinterpret_cast<const sockaddr*>(&this->m_server_address), sizeof(this->m_server_address));
+    if (sent == SOCKET_ERROR) {
+        std::cerr << std::endl << "[ERROR] [NatNetNativeClient] Failed to send message " << message << " to server. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool tracking::NatNetNativeClient::wait_for_message(uint16_t message, double timeout, std::vector<char>& o_payload) {
+
+    std::vector<char> packet(RECEIVE_BUFFER_SIZE);
+    double end = tracking::GetLocalTime() + timeout;
+    double remaining = timeout;
+    while (remaining > 0.0) {
+        bool data_ready = false;
+        bool command_ready = false;
+        // Frames on the data socket are not read here, so they must not end the wait.
+        if (!this->wait_readable(remaining, true, data_ready, command_ready)) {
+            return false;
+        }
+        if (command_ready) {
+            int bytes = recv(this->m_command_socket, packet.data(), static_cast<int>(packet.size()), 0);
+            uint16_t received = 0;
+            const char* payload = nullptr;
+            size_t payload_size = 0;
+            if ((bytes > 0) && NatNetPacketDecoder::DecodeHeader(packet.data(), static_cast<size_t>(bytes), received, payload, payload_size) && (received == message)) {
+                o_payload.assign(payload, payload + payload_size);
+                return true;
+            }
+        }
+        remaining = end - tracking::GetLocalTime();
+    }
+    return false;
+}
+
+
+void tracking::NatNetNativeClient::on_command(const char* packet, size_t size, double receive_time) {
+
+    uint16_t message = 0;
+    const char* payload = nullptr;
+    size_t payload_size = 0;
+    if (!NatNetPacketDecoder::DecodeHeader(packet, size, message, payload, payload_size)) {
+        return;
+    }
+
+    if ((message == NAT_ECHORESPONSE) && (payload_size >= 2 * sizeof(uint64_t)) && (this->m_clock_frequency > 0)) {
+        // Payload: echoed request time (local ns) and host ticks at response
+        uint64_t request = 0;
+        uint64_t ticks = 0;
+        std::memcpy(&request, payload, sizeof(uint64_t));
+        std::memcpy(&ticks, payload + sizeof(uint64_t), sizeof(uint64_t));
+        double send_time = static_cast<double>(request) / 1000000000.0;
+        double rtt = receive_time - send_time;
+        if (rtt < 0.0) {
+            return;
+        }
+        // Keep estimate with smallest round trip time (least asymmetric delay)
+        this->m_clock_rtt *= CLOCK_RTT_AGING;
+        if (rtt <= this->m_clock_rtt) {
+            this->m_clock_rtt = rtt;
+            double offset = (send_time + receive_time) / 2.0 - static_cast<double>(ticks) / static_cast<double>(this->m_clock_frequency);
+            this->m_clock_offset.store(offset, std::memory_order_release);
+            this->m_clock_synchronised.store(true, std::memory_order_release);
+        }
+    }
+    else if ((message == NAT_MODELDEF) || (message == NAT_RESPONSE) || (message == NAT_UNRECOGNIZED_REQUEST)) {
+        std::lock_guard<std::mutex> lock(this->m_response_mutex);
+        if ((message == this->m_response_message) || (message == NAT_UNRECOGNIZED_REQUEST)) {
+            this->m_response.assign(payload, payload + payload_size);
+            this->m_response_message = message;
+            this->m_response_ready = true;
+            this->m_response_cv.notify_all();
+        }
+    }
+}
+
+
+bool tracking::NatNetNativeClient::wait_readable(double timeout, bool command_only, bool& o_data_ready, bool& o_command_ready) {
+
+    o_data_ready = false;
+    o_command_ready = false;
+
+    fd_set sockets;
+    FD_ZERO(&sockets);
+    SocketType max_socket = 0;
+    if (this->m_command_socket != INVALID_SOCKET) {
+        FD_SET(this->m_command_socket, &sockets);
+        max_socket = (std::max)(max_socket, this->m_command_socket);
+    }
+    if ((this->m_data_socket != INVALID_SOCKET) && !command_only) {
+        FD_SET(this->m_data_socket, &sockets);
+        max_socket = (std::max)(max_socket, this->m_data_socket);
+    }
+
+    timeval tv;
+    tv.tv_sec = static_cast<long>(timeout);
+    tv.tv_usec = static_cast<long>((timeout - static_cast<double>(tv.tv_sec)) * 1000000.0);
+    int result = select(static_cast<int>(max_socket) + 1, &sockets, nullptr, nullptr, &tv);
+    if (result == SOCKET_ERROR) {
+        return false;
+    }
+    if (result > 0) {
+        o_command_ready = ((this->m_command_socket != INVALID_SOCKET) && FD_ISSET(this->m_command_socket, &sockets));
+        o_data_ready = ((this->m_data_socket != INVALID_SOCKET) && !command_only && FD_ISSET(this->m_data_socket, &sockets));
+    }
+    return true;
+}
+
+
+void tracking::NatNetNativeClient::close_socket(SocketType& socket) {
+
+    if (socket != INVALID_SOCKET) {
+        closesocket(socket);
+        socket = INVALID_SOCKET;
+    }
+}
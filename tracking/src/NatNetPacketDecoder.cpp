@@ -0,0 +1,296 @@
+/**
+ * NatNetPacketDecoder.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "NatNetPacketDecoder.h"
+
+tracking::NatNetPacketDecoder::NatNetPacketDecoder(void)
+    : m_major(3)
+    , m_minor(0)
+    , m_section_sizes(false) {
+
+    // intentionally empty...
+}
+
+
+bool tracking::NatNetPacketDecoder::SetVersion(int major, int minor) {
+
+    if (major < 3) {
+        std::cerr << std::endl << "[ERROR] [NatNetPacketDecoder] NatNet version " << major << "." << minor << " is not supported (requires 3.0 or later). " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    this->m_major = major;
+    this->m_minor = minor;
+    this->m_section_sizes = ((major > 4) || ((major == 4) && (minor >= 1)));
+    return true;
+}
+
+
+bool tracking::NatNetPacketDecoder::DecodeHeader(const char* packet, size_t size, uint16_t& o_message, const char*& o_payload, size_t& o_payload_size) {
+
+    if ((packet == nullptr) || (size < 4)) {
+        return false;
+    }
+    uint16_t bytes = 0;
+    std::memcpy(&o_message, packet, sizeof(uint16_t));
+    std::memcpy(&bytes, packet + 2, sizeof(uint16_t));
+    if (static_cast<size_t>(bytes) > (size - 4)) {
+        return false;
+    }
+    o_payload = packet + 4;
+    o_payload_size = bytes;
+    return true;
+}
+
+
+bool tracking::NatNetPacketDecoder::DecodeServerInfo(const char* payload, size_t size, sSender_Server& o_server) {
+
+    std::memset(&o_server, 0, sizeof(o_server));
+    if ((payload == nullptr) || (size < sizeof(sSender))) {
+        return false;
+    }
+    // Clock and connection info is only sent by NatNet 3.0+ servers.
+    std::memcpy(&o_server, payload, (std::min)(size, sizeof(o_server)));
+    o_server.Common.szName[MAX_NAMELENGTH - 1] = '\0';
+    return true;
+}
+
+
+bool tracking::NatNetPacketDecoder::DecodeFrame(const char* payload, size_t size, Frame& o_frame) const {
+
+    Reader r(payload, size);
+    int32_t count = 0;
+    int32_t section_size = 0;
+
+    // Records of a section have to fill its declared size (NatNet 4.1+), otherwise the frame is malformed.
+    auto check_section = [this, &r](const char* begin, int32_t bytes) {
+        if (this->m_section_sizes && r.Ok() && ((r.Position() - begin) != static_cast<ptrdiff_t>(bytes))) {
+            r.Fail();
+        }
+    };
+
+    o_frame.frame = r.Read<int32_t>();
+
+    // Marker sets
+    count = r.ReadCount();
+    if (this->m_section_sizes) {
+        r.Skip(static_cast<size_t>(r.ReadCount()));
+    }
+    else {
+        for (int32_t i = 0; (i < count) && r.Ok(); ++i) {
+            r.ReadString();
+            r.Skip(static_cast<size_t>(r.ReadCount()) * 3 * sizeof(float));
+        }
+    }
+
+    // Unlabeled markers (deprecated)
+    count = r.ReadCount();
+    if (this->m_section_sizes) {
+        r.Skip(static_cast<size_t>(r.ReadCount()));
+    }
+    else {
+        r.Skip(static_cast<size_t>(count) * 3 * sizeof(float));
+    }
+
+    // Rigid bodies (fixed size records)
+    o_frame.rigid_body_count = r.ReadCount();
+    if (this->m_section_sizes) {
+        section_size = r.ReadCount();
+    }
+    o_frame.rigid_bodies = r.Position();
+    r.Skip(static_cast<size_t>(o_frame.rigid_body_count) * RIGID_BODY_SIZE);
+    check_section(o_frame.rigid_bodies, section_size);
+
+    // Skeletons (records are validated, so ReadSkeleton() stays in bounds)
+    o_frame.skeleton_count = r.ReadCount();
+    if (this->m_section_sizes) {
+        section_size = r.ReadCount();
+    }
+    o_frame.skeletons = r.Position();
+    for (int32_t i = 0; (i < o_frame.skeleton_count) && r.Ok(); ++i) {
+        r.Read<int32_t>();
+        int32_t bones = r.ReadCount();
+        r.Skip(static_cast<size_t>(bones) * RIGID_BODY_SIZE);
+    }
+    check_section(o_frame.skeletons, section_size);
+
+    // Assets (NatNet 4.1+)
+    if (this->m_section_sizes) {
+        r.Read<int32_t>();
+        r.Skip(static_cast<size_t>(r.ReadCount()));
+    }
+
+    // Labeled markers (fixed size records)
+    o_frame.labeled_marker_count = r.ReadCount();
+    if (this->m_section_sizes) {
+        section_size = r.ReadCount();
+    }
+    o_frame.labeled_markers = r.Position();
+    r.Skip(static_cast<size_t>(o_frame.labeled_marker_count) * LABELED_MARKER_SIZE);
+    check_section(o_frame.labeled_markers, section_size);
+
+    // Force plates and devices
+    this->skip_analog_section(r);
+    this->skip_analog_section(r);
+
+    // Frame suffix
+    r.Read<uint32_t>(); /// Timecode
+    r.Read<uint32_t>(); /// Timecode sub frame
+    o_frame.timestamp = r.Read<double>();
+    o_frame.mid_exposure_timestamp = r.Read<uint64_t>();
+    o_frame.data_received_timestamp = r.Read<uint64_t>();
+    o_frame.transmit_timestamp = r.Read<uint64_t>();
+    if (this->m_section_sizes) {
+        r.Read<uint32_t>(); /// Precision timestamp seconds
+        r.Read<uint32_t>(); /// Precision timestamp fraction
+    }
+    o_frame.params = r.Read<int16_t>();
+
+    if (!r.Ok() || (o_frame.rigid_body_count < 0) || (o_frame.skeleton_count < 0) || (o_frame.labeled_marker_count < 0)) {
+        o_frame.rigid_body_count = 0;
+        o_frame.skeleton_count = 0;
+        o_frame.labeled_marker_count = 0;
+        return false;
+    }
+    return true;
+}
+
+
+void tracking::NatNetPacketDecoder::ReadRigidBody(const char* record, RigidBody& o_rb) {
+
+    float values[8];
+    std::memcpy(&o_rb.id, record, sizeof(int32_t));
+    std::memcpy(values, record + 4, sizeof(values));
+    std::memcpy(&o_rb.params, record + 36, sizeof(int16_t));
+    o_rb.position    = glm::vec3(values[0], values[1], values[2]);
+    o_rb.orientation = glm::quat(values[6], values[3], values[4], values[5]); /// glm::quat(w, x, y, z)
+    o_rb.mean_error  = values[7];
+}
+
+
+const char* tracking::NatNetPacketDecoder::ReadSkeleton(const char* record, int32_t& o_id, int32_t& o_bone_count) {
+
+    std::memcpy(&o_id, record, sizeof(int32_t));
+    std::memcpy(&o_bone_count, record + 4, sizeof(int32_t));
+    return record + 8;
+}
+
+
+void tracking::NatNetPacketDecoder::ReadLabeledMarker(const char* record, LabeledMarker& o_marker) {
+
+    float values[4];
+    std::memcpy(&o_marker.id, record, sizeof(int32_t));
+    std::memcpy(values, record + 4, sizeof(values));
+    std::memcpy(&o_marker.params, record + 20, sizeof(int16_t));
+    std::memcpy(&o_marker.residual, record + 22, sizeof(float));
+    o_marker.position = glm::vec3(values[0], values[1], values[2]);
+    o_marker.size     = values[3];
+}
+
+
+bool tracking::NatNetPacketDecoder::DecodeModelDef(const char* payload, size_t size, std::vector<RigidBodyDescription>& o_rigid_bodies,
+    std::vector<SkeletonDescription>& o_skeletons) const {
+
+    o_rigid_bodies.clear();
+    o_skeletons.clear();
+    Reader r(payload, size);
+
+    int32_t count = r.ReadCount();
+    for (int32_t i = 0; (i < count) && r.Ok(); ++i) {
+        int32_t type = r.Read<int32_t>();
+        const char* end = nullptr;
+        if (this->m_section_sizes) {
+            int32_t bytes = r.Read<int32_t>();
+            if ((bytes < 0) || (static_cast<size_t>((payload + size) - r.Position()) < static_cast<size_t>(bytes))) {
+                return false;
+            }
+            end = r.Position() + bytes;
+        }
+
+        switch (type) {
+        case (Descriptor_MarkerSet): {
+            r.ReadString();
+            int32_t markers = r.ReadCount();
+            for (int32_t m = 0; (m < markers) && r.Ok(); ++m) {
+                r.ReadString();
+            }
+        } break;
+        case (Descriptor_RigidBody): {
+            RigidBodyDescription rb;
+            this->read_rigid_body_description(r, rb);
+            if (r.Ok()) {
+                o_rigid_bodies.emplace_back(rb);
+            }
+        } break;
+        case (Descriptor_Skeleton): {
+            SkeletonDescription skeleton;
+            skeleton.name = r.ReadString();
+            skeleton.id   = r.Read<int32_t>();
+            int32_t bones = r.ReadCount();
+            for (int32_t b = 0; (b < bones) && r.Ok(); ++b) {
+                RigidBodyDescription bone;
+                this->read_rigid_body_description(r, bone);
+                skeleton.bones.emplace_back(bone);
+            }
+            if (r.Ok()) {
+                o_skeletons.emplace_back(skeleton);
+            }
+        } break;
+        default: {
+            if (end == nullptr) {
+                // Layout of other descriptions is not needed, stop here.
+                return r.Ok();
+            }
+        } break;
+        }
+
+        if (end != nullptr) {
+            if (!r.Ok() || (r.Position() > end)) {
+                return false; /// Description exceeds its size.
+            }
+            r = Reader(end, static_cast<size_t>((payload + size) - end));
+        }
+    }
+    return r.Ok();
+}
+
+
+void tracking::NatNetPacketDecoder::skip_analog_section(Reader& r) const {
+
+    int32_t count = r.ReadCount();
+    if (this->m_section_sizes) {
+        r.Skip(static_cast<size_t>(r.ReadCount()));
+        return;
+    }
+    for (int32_t i = 0; (i < count) && r.Ok(); ++i) {
+        r.Read<int32_t>(); /// ID
+        int32_t channels = r.ReadCount();
+        for (int32_t c = 0; (c < channels) && r.Ok(); ++c) {
+            r.Skip(static_cast<size_t>(r.ReadCount()) * sizeof(float));
+        }
+    }
+}
+
+
+void tracking::NatNetPacketDecoder::read_rigid_body_description(Reader& r, RigidBodyDescription& o_rb) const {
+
+    o_rb.name      = r.ReadString();
+    o_rb.id        = r.Read<int32_t>();
+    o_rb.parent_id = r.Read<int32_t>();
+    float x = r.Read<float>();
+    float y = r.Read<float>();
+    float z = r.Read<float>();
+    o_rb.offset    = glm::vec3(x, y, z);
+
+    int32_t markers = r.ReadCount();
+    r.Skip(static_cast<size_t>(markers) * (3 * sizeof(float) + sizeof(int32_t))); /// Positions and required labels
+    if (this->m_major >= 4) {
+        for (int32_t m = 0; (m < markers) && r.Ok(); ++m) {
+            r.ReadString();
+        }
+    }
+}
@@ -0,0 +1,264 @@
+/**
+ * PosePredictor.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "PosePredictor.h"
+
+const double tracking::PosePredictor::MAX_GAP = 0.5;
+const float tracking::PosePredictor::ANGULAR_SMOOTHING = 0.5f;
+
+
+tracking::PosePredictor::PosePredictor(void)
+    : m_params()
+    , m_published()
+    , m_x()
+    , m_p()
+    , m_orientation()
+    , m_angular_velocity()
+    , m_time(-1.0) {
+
+    this->m_params.model             = PosePredictor::Model::None;
+    this->m_params.horizon           = 0.05f;
+    this->m_params.process_noise     = 500.0f;
+    this->m_params.measurement_noise = 0.0000005f;
+    this->Reset();
+}
+
+
+void tracking::PosePredictor::Configure(const PosePredictor::Params& params) {
+
+    this->m_params = params;
+    if (this->m_params.horizon < 0.0f) {
+        this->m_params.horizon = 0.0f;
+    }
+    this->Reset();
+}
+
+
+void tracking::PosePredictor::Reset(void) {
+
+    this->m_x.fill(glm::dvec3(0.0));
+    this->m_p.fill(0.0);
+    this->m_orientation = glm::quat();
+    this->m_angular_velocity = glm::vec3(0.0f);
+    this->m_time = -1.0;
+
+    State state;
+    state.model            = this->m_params.model;
+    state.horizon          = this->m_params.horizon;
+    state.position         = glm::vec3(0.0f);
+    state.velocity         = glm::vec3(0.0f);
+    state.acceleration     = glm::vec3(0.0f);
+    state.orientation      = glm::quat();
+    state.angular_velocity = glm::vec3(0.0f);
+    state.time             = -1.0;
+    this->m_published.Store(state);
+}
+
+
+void tracking::PosePredictor::Update(const glm::vec3& position, const glm::quat& orientation, double time) {
+
+    const glm::dvec3 z(position);
+    const glm::quat  q = glm::normalize(orientation);
+    const double     dt = time - this->m_time;
+    const double     r = static_cast<double>(this->m_params.measurement_noise);
+    const bool       ca = (this->m_params.model == PosePredictor::Model::ConstantAcceleration);
+
+    if ((this->m_params.model == PosePredictor::Model::None) || (this->m_time < 0.0) || (dt <= 0.0) || (dt > MAX_GAP)) {
+        // (Re)start filter at measured pose.
+        this->m_x[0] = z;
+        this->m_x[1] = glm::dvec3(0.0);
+        this->m_x[2] = glm::dvec3(0.0);
+        this->m_p.fill(0.0);
+        this->m_p[0] = r;
+        this->m_p[4] = 1.0;                        /// Velocity variance (m/s)^2
+        this->m_p[8] = (ca) ? (10.0) : (0.0);      /// Acceleration variance (m/s^2)^2
+        this->m_orientation = q;
+        this->m_angular_velocity = glm::vec3(0.0f);
+    }
+    else {
+        // Predict state: x = F x
+        const double dt2 = dt * dt / 2.0;
+        if (ca) {
+            this->m_x[0] += this->m_x[1] * dt + this->m_x[2] * dt2;
+            this->m_x[1] += this->m_x[2] * dt;
+        }
+        else {
+            this->m_x[0] += this->m_x[1] * dt;
+        }
+
+        // Predict covariance: P = F P F^T + Q
+        double f[9] = { 1.0, dt, (ca) ? (dt2) : (0.0),
+                        0.0, 1.0, (ca) ? (dt) : (0.0),
+                        0.0, 0.0, (ca) ? (1.0) : (0.0) };
+        double fp[9];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                fp[i * 3 + j] = f[i * 3 + 0] * this->m_p[0 * 3 + j] + f[i * 3 + 1] * this->m_p[1 * 3 + j] + f[i * 3 + 2] * this->m_p[2 * 3 + j];
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                this->m_p[i * 3 + j] = fp[i * 3 + 0] * f[j * 3 + 0] + fp[i * 3 + 1] * f[j * 3 + 1] + fp[i * 3 + 2] * f[j * 3 + 2];
+            }
+        }
+        const double q_noise = static_cast<double>(this->m_params.process_noise);
+        const double dt3 = dt * dt * dt;
+        if (ca) {
+            /// White noise jerk
+            const double dt4 = dt3 * dt;
+            const double dt5 = dt4 * dt;
+            this->m_p[0] += q_noise * dt5 / 20.0; this->m_p[1] += q_noise * dt4 / 8.0; this->m_p[2] += q_noise * dt3 / 6.0;
+            this->m_p[3] += q_noise * dt4 / 8.0;  this->m_p[4] += q_noise * dt3 / 3.0; this->m_p[5] += q_noise * dt * dt / 2.0;
+            this->m_p[6] += q_noise * dt3 / 6.0;  this->m_p[7] += q_noise * dt * dt / 2.0; this->m_p[8] += q_noise * dt;
+        }
+        else {
+            /// White noise acceleration
+            this->m_p[0] += q_noise * dt3 / 3.0;  this->m_p[1] += q_noise * dt * dt / 2.0;
+            this->m_p[3] += q_noise * dt * dt / 2.0; this->m_p[4] += q_noise * dt;
+        }
+
+        // Correct with measured position (H = [1 0 0])
+        const double s = this->m_p[0] + r;
+        const double k[3] = { this->m_p[0] / s, this->m_p[3] / s, this->m_p[6] / s };
+        const glm::dvec3 y = z - this->m_x[0];
+        for (int i = 0; i < 3; ++i) {
+            this->m_x[i] += y * k[i];
+        }
+        const double p0[3] = { this->m_p[0], this->m_p[1], this->m_p[2] };
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                this->m_p[i * 3 + j] -= k[i] * p0[j];
+            }
+        }
+
+        // Angular velocity from rotation between consecutive orientations (world frame).
+        glm::quat delta = q * glm::inverse(this->m_orientation);
+        if (delta.w < 0.0f) {
+            delta = -delta;
+        }
+        float sin_half = glm::length(glm::vec3(delta.x, delta.y, delta.z));
+        glm::vec3 angular_velocity(0.0f);
+        if (sin_half > 0.000001f) {
+            float angle = 2.0f * std::atan2(sin_half, delta.w);
+            angular_velocity = glm::vec3(delta.x, delta.y, delta.z) / sin_half * (angle / static_cast<float>(dt));
+        }
+        this->m_angular_velocity += (angular_velocity - this->m_angular_velocity) * ANGULAR_SMOOTHING;
+        this->m_orientation = q;
+    }
+    this->m_time = time;
+
+    // Publish filtered state at once
+    State state;
+    state.model            = this->m_params.model;
+    state.horizon          = this->m_params.horizon;
+    state.position         = glm::vec3(this->m_x[0]);
+    state.velocity         = glm::vec3(this->m_x[1]);
+    state.acceleration     = glm::vec3(this->m_x[2]);
+    state.orientation      = this->m_orientation;
+    state.angular_velocity = this->m_angular_velocity;
+    state.time             = this->m_time;
+    this->m_published.Store(state);
+}
+
+
+bool tracking::PosePredictor::Predict(double time, glm::vec3& o_position, glm::quat& o_orientation) const {
+
+    State state;
+    this->m_published.Load(state);
+    if (state.time < 0.0) {
+        return false;
+    }
+
+    float dt = static_cast<float>(time - state.time);
+    if ((dt < 0.0f) || (state.model == PosePredictor::Model::None)) {
+        dt = 0.0f;
+    }
+    if (dt > state.horizon) {
+        dt = state.horizon;
+    }
+
+    o_position = state.position + state.velocity * dt + state.acceleration * (dt * dt / 2.0f);
+    o_orientation = state.orientation;
+    float speed = glm::length(state.angular_velocity);
+    if (speed * dt > 0.000001f) {
+        o_orientation = glm::normalize(glm::angleAxis(speed * dt, state.angular_velocity / speed) * state.orientation);
+    }
+    return true;
+}
+
+
+bool tracking::PosePredictor::EvaluateTrace(const std::vector<PosePredictor::Sample>& trace, const PosePredictor::Params& params,
+    const std::vector<float>& horizons, double warmup, std::vector<PosePredictor::Error>& o_errors) {
+
+    o_errors.clear();
+    if (trace.size() < 2) {
+        std::cerr << std::endl << "[ERROR] [PosePredictor] Trace requires at least two samples. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    PosePredictor predictor;
+    PosePredictor::Params p = params;
+    p.horizon = 0.0f;
+    for (auto h : horizons) {
+        p.horizon = (std::max)(p.horizon, h);
+    }
+    predictor.Configure(p);
+
+    std::vector<double> position_sum(horizons.size(), 0.0);
+    std::vector<double> angle_sum(horizons.size(), 0.0);
+    std::vector<size_t> counts(horizons.size(), 0);
+    std::vector<size_t> cursors(horizons.size(), 0);  /// Index of first recorded pose after predicted time.
+
+    for (size_t i = 0; i < trace.size(); ++i) {
+        predictor.Update(trace[i].position, trace[i].orientation, trace[i].time);
+        if (trace[i].time < trace[0].time + warmup) {
+            continue;
+        }
+
+        for (size_t h = 0; h < horizons.size(); ++h) {
+            double time = trace[i].time + static_cast<double>(horizons[h]);
+            size_t& c = cursors[h];
+            while ((c < trace.size()) && (trace[c].time < time)) {
+                ++c;
+            }
+            if (c >= trace.size()) {
+                continue; /// Recorded poses end before predicted time.
+            }
+
+            // Recorded pose at predicted time
+            glm::vec3 position = trace[c].position;
+            glm::quat orientation = trace[c].orientation;
+            if ((c > 0) && (trace[c].time > trace[c - 1].time)) {
+                float t = static_cast<float>((time - trace[c - 1].time) / (trace[c].time - trace[c - 1].time));
+                position = glm::mix(trace[c - 1].position, trace[c].position, t);
+                orientation = glm::slerp(trace[c - 1].orientation, trace[c].orientation, t);
+            }
+
+            glm::vec3 predicted_position;
+            glm::quat predicted_orientation;
+            if (predictor.Predict(time, predicted_position, predicted_orientation)) {
+                float distance = glm::length(predicted_position - position);
+                float dot = (std::min)(1.0f, std::abs(glm::dot(glm::normalize(predicted_orientation), glm::normalize(orientation))));
+                float angle = 2.0f * std::acos(dot);
+                position_sum[h] += static_cast<double>(distance * distance);
+                angle_sum[h] += static_cast<double>(angle * angle);
+                counts[h]++;
+            }
+        }
+    }
+
+    for (size_t h = 0; h < horizons.size(); ++h) {
+        PosePredictor::Error error;
+        error.horizon      = horizons[h];
+        error.count        = counts[h];
+        error.position_rms = (counts[h] > 0) ? (static_cast<float>(std::sqrt(position_sum[h] / static_cast<double>(counts[h])))) : (0.0f);
+        error.angle_rms    = (counts[h] > 0) ? (static_cast<float>(std::sqrt(angle_sum[h] / static_cast<double>(counts[h])))) : (0.0f);
+        o_errors.emplace_back(error);
+    }
+    return true;
+}
@@ -0,0 +1,170 @@
+/**
+ * SessionCache.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "SessionCache.h"
+
+bool tracking::SessionCache::Read(const std::string& filename, Contents& o_contents) {
+
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.good()) {
+        return false;
+    }
+
+    uint32_t magic   = 0;
+    uint32_t version = 0;
+    if (!read_value(file, magic) || !read_value(file, version) || (magic != MAGIC) || (version != FORMAT_VERSION)) {
+        std::cout << "[WARNING] [SessionCache] Ignoring \"" << filename.c_str() << "\" with unknown format." << std::endl;
+        return false;
+    }
+
+    uint32_t rigid_body_count = 0;
+    uint32_t skeleton_count   = 0;
+    bool check = read_string(file, o_contents.server_ip) && read_value(file, o_contents.cmd_port) &&
+        read_value(file, o_contents.natnet_version) && read_value(file, rigid_body_count) && (rigid_body_count <= MAX_RIGIDBODIES);
+    if (check) {
+        o_contents.rigid_bodies.resize(rigid_body_count);
+        for (auto& rb : o_contents.rigid_bodies) {
+            check = check && read_description(file, rb);
+        }
+    }
+    check = check && read_value(file, skeleton_count) && (skeleton_count <= MAX_SKELETONS);
+    if (check) {
+        o_contents.skeletons.resize(skeleton_count);
+        for (auto& sk : o_contents.skeletons) {
+            uint32_t bone_count = 0;
+            check = check && read_string(file, sk.name) && read_value(file, sk.id) &&
+                read_value(file, bone_count) && (bone_count <= MAX_SKELRIGIDBODIES);
+            if (check) {
+                sk.bones.resize(bone_count);
+                for (auto& bone : sk.bones) {
+                    check = check && read_description(file, bone);
+                }
+            }
+        }
+    }
+    if (!check) {
+        std::cout << "[WARNING] [SessionCache] Ignoring malformed \"" << filename.c_str() << "\"." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool tracking::SessionCache::Write(const std::string& filename, const Contents& contents) {
+
+    const std::string temp_filename = filename + ".tmp";
+    {
+        std::ofstream file(temp_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.good()) {
+            std::cerr << std::endl << "[ERROR] [SessionCache] Failed to open \"" << temp_filename.c_str() << "\" for writing. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return false;
+        }
+
+        const std::array<uint32_t, 2> header = { MAGIC, FORMAT_VERSION };
+        write_value(file, header);
+        write_string(file, contents.server_ip);
+        write_value(file, contents.cmd_port);
+        write_value(file, contents.natnet_version);
+        write_value(file, static_cast<uint32_t>(contents.rigid_bodies.size()));
+        for (auto& rb : contents.rigid_bodies) {
+            write_description(file, rb);
+        }
+        write_value(file, static_cast<uint32_t>(contents.skeletons.size()));
+        for (auto& sk : contents.skeletons) {
+            write_string(file, sk.name);
+            write_value(file, sk.id);
+            write_value(file, static_cast<uint32_t>(sk.bones.size()));
+            for (auto& bone : sk.bones) {
+                write_description(file, bone);
+            }
+        }
+
+        file.flush();
+        if (!file.good()) {
+            std::cerr << std::endl << "[ERROR] [SessionCache] Failed to write \"" << temp_filename.c_str() << "\". " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            return false;
+        }
+    }
+
+    // Replace cache at once (rename does not overwrite existing files on Windows).
+    std::remove(filename.c_str());
+    if (std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+        std::cerr << std::endl << "[ERROR] [SessionCache] Failed to replace \"" << filename.c_str() << "\". " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool tracking::SessionCache::Equal(const std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& a,
+    const std::vector<tracking::NatNetPacketDecoder::RigidBodyDescription>& b) {
+
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if ((a[i].id != b[i].id) || (a[i].parent_id != b[i].parent_id) || (a[i].offset != b[i].offset) || (a[i].name != b[i].name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool tracking::SessionCache::Equal(const std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& a,
+    const std::vector<tracking::NatNetPacketDecoder::SkeletonDescription>& b) {
+
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if ((a[i].id != b[i].id) || (a[i].name != b[i].name) || !Equal(a[i].bones, b[i].bones)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void tracking::SessionCache::write_string(std::ostream& stream, const std::string& value) {
+
+    uint16_t length = static_cast<uint16_t>((std::min)(value.length(), static_cast<size_t>(MAX_NAME_LENGTH)));
+    write_value(stream, length);
+    stream.write(value.data(), length);
+}
+
+
+bool tracking::SessionCache::read_string(std::istream& stream, std::string& o_value) {
+
+    uint16_t length = 0;
+    if (!read_value(stream, length) || (length > MAX_NAME_LENGTH)) {
+        return false;
+    }
+    o_value.resize(length);
+    return (length == 0) || static_cast<bool>(stream.read(&o_value[0], length));
+}
+
+
+void tracking::SessionCache::write_description(std::ostream& stream, const tracking::NatNetPacketDecoder::RigidBodyDescription& description) {
+
+    write_string(stream, description.name);
+    write_value(stream, description.id);
+    write_value(stream, description.parent_id);
+    write_value(stream, description.offset.x);
+    write_value(stream, description.offset.y);
+    write_value(stream, description.offset.z);
+}
+
+
+bool tracking::SessionCache::read_description(std::istream& stream, tracking::NatNetPacketDecoder::RigidBodyDescription& o_description) {
+
+    return read_string(stream, o_description.name) && read_value(stream, o_description.id) && read_value(stream, o_description.parent_id) &&
+        read_value(stream, o_description.offset.x) && read_value(stream, o_description.offset.y) && read_value(stream, o_description.offset.z);
+}
@@ -10,11 +10,17 @@
 tracking::Tracker::Tracker(void)
     : m_initialised(false)
     , m_connected(false)
+    , m_frame_signal()
+    , m_vrpn_reactor()
     , m_button_devices()
     , m_motion_devices()
+    , m_tracker_devices()
+    , m_button_connects()
+    , m_motion_connect()
+    , m_connect()
     , m_active_node() {
 
-    // intentionally empty...
+    this->m_motion_devices.SetFrameSignal(&this->m_frame_signal);
 }
 
 
@@ -25,6 +31,9 @@ tracking::Tracker::~Tracker(void) {
     for (auto& v : this->m_button_devices) {
         v.reset(nullptr);
     }
+    for (auto& v : this->m_tracker_devices) {
+        v.reset(nullptr);
+    }
 }
 
 
@@ -61,6 +70,17 @@ bool tracking::Tracker::Initialise(const tracking::Tracker::Params& params)
         check = false;
     }
 
+    this->m_tracker_devices.clear();
+    std::vector<tracking::VrpnTrackerDevice::Params> vrpn_tracker_params;
+    if ((params.vrpn_tracker_params_count > 0) && (params.vrpn_tracker_params == nullptr)) {
+        std::cerr << std::endl << "[ERROR] [Tracker] Parameter \"vrpn_tracker_params\" must not be nullptr for \"vrpn_tracker_params_count\" greater than 0. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+    for (size_t i = 0; check && (i < params.vrpn_tracker_params_count); i++) {
+        vrpn_tracker_params.emplace_back(params.vrpn_tracker_params[i]);
+    }
+
     if (!this->m_motion_devices.Initialise(params.natnet_params)) {
         check = false;
     }
@@ -69,12 +89,20 @@ bool tracking::Tracker::Initialise(const tracking::Tracker::Params& params)
         m_active_node = active_node;
 
         for (int i = 0; i < vrpn_params.size(); ++i) {
-            this->m_button_devices.emplace_back(std::make_unique<tracking::VrpnButtonDevice>());
+            this->m_button_devices.emplace_back(std::make_unique<tracking::VrpnButtonDevice>(this->m_vrpn_reactor, &this->m_frame_signal));
             if (!this->m_button_devices.back()->Initialise(vrpn_params[i])) {
                 check = false;
             }
         }
 
+        // Rigid bodies of tracker devices are added to the motion devices.
+        for (auto& p : vrpn_tracker_params) {
+            this->m_tracker_devices.emplace_back(std::make_unique<tracking::VrpnTrackerDevice>(this->m_vrpn_reactor, this->m_motion_devices));
+            if (!this->m_tracker_devices.back()->Initialise(p)) {
+                check = false;
+            }
+        }
+
         this->print_params();
         this->m_initialised = true;
     }
@@ -90,16 +118,61 @@ void tracking::Tracker::print_params(void) {
 
 bool tracking::Tracker::Connect(void) {
 
+    std::shared_future<bool> connect = this->ConnectAsync();
+    this->m_connected = (connect.valid() && connect.get());
+    if (!this->m_connected) {
+        this->Disconnect();
+    }
+    return this->m_connected;
+}
+
+
+std::shared_future<bool> tracking::Tracker::ConnectAsync(void) {
+
     if (!this->m_initialised) {
         std::cerr << std::endl << "[ERROR] [Tracker] Not initialised. " <<
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
-        return false;
+        return std::shared_future<bool>();
     }
 
     // Terminate previous connection.
     this->Disconnect();
 
-    // Check active node.
+    if (!this->is_active_node()) {
+        return std::shared_future<bool>();
+    }
+
+    // Connect button devices and motion devices in parallel, each one with its own timeout
+    // (VRPN devices create their remote devices one at a time under the reactor lock, see VrpnReactor::Run()).
+    std::vector<std::shared_future<bool>> endpoints;
+    for (auto& v : this->m_button_devices) {
+        tracking::VrpnButtonDevice* device = v.get();
+        this->m_button_connects.emplace_back(std::async(std::launch::async, [device]() { return device->Connect(); }).share());
+        endpoints.emplace_back(this->m_button_connects.back());
+    }
+    for (auto& v : this->m_tracker_devices) {
+        tracking::VrpnTrackerDevice* device = v.get();
+        endpoints.emplace_back(std::async(std::launch::async, [device]() { return device->Connect(); }).share());
+    }
+    tracking::NatNetDevicePool* pool = &this->m_motion_devices;
+    this->m_motion_connect = std::async(std::launch::async, [pool]() { return pool->Connect(); }).share();
+    endpoints.emplace_back(this->m_motion_connect);
+
+    this->m_connect = std::async(std::launch::async, [endpoints]() {
+        bool connected = true;
+        for (auto& e : endpoints) {
+            connected = (e.get() && connected);
+        }
+        return connected;
+    }).share();
+
+    this->m_connected = true;
+    return this->m_connect;
+}
+
+
+bool tracking::Tracker::is_active_node(void) const {
+
     std::string computerName;
 
     const size_t bufSize = 255;
@@ -113,40 +186,36 @@ bool tracking::Tracker::Connect(void) {
 // Linux
 #else
     char hostname[bufSize];
-    gethostname(hostname, bufSize);
+    if (gethostname(hostname, bufSize) == 0) {
+        hostname[bufSize - 1] = '\0';
+        computerName = hostname;
+    }
 #endif /** _WIN32 */
 
     if (!this->m_active_node.empty() && (computerName != m_active_node)) {
         std::cout << std::endl << "[WARNING] [Tracker] Node \"" << computerName.c_str() << "\" is not enabled to receive tracker updates (otherwise set as active node)." << std::endl << std::endl;
         return false;
     }
-	
-    // Connect button devices.
-    bool vrpn_con_status = true;
-    for (auto& v: this->m_button_devices) {
-        if (!v->Connect()) {
-            this->Disconnect();
-            vrpn_con_status = false;
-        }
-    }
-
-    // Connect motion devices.
-    bool natnetConStatus = true;
-    if (!this->m_motion_devices.Connect()) {
-        this->Disconnect();
-        natnetConStatus = false;
-    }
-
-    this->m_connected = (vrpn_con_status && natnetConStatus);
-    return this->m_connected;
+    return true;
 }
 
 
 bool tracking::Tracker::Disconnect(void) {
 
+    // Pending connects have to finish first (bounded by the connect timeouts).
+    if (this->m_connect.valid()) {
+        this->m_connect.wait();
+    }
+    this->m_connect = std::shared_future<bool>();
+    this->m_motion_connect = std::shared_future<bool>();
+    this->m_button_connects.clear();
+
     for (auto& v : this->m_button_devices) {
         v->Disconnect();
     }
+    for (auto& v : this->m_tracker_devices) {
+        v->Disconnect();
+    }
     this->m_motion_devices.Disconnect();
 
     this->m_connected = false;
@@ -154,7 +223,45 @@ bool tracking::Tracker::Disconnect(void) {
 }
 
 
-bool tracking::Tracker::GetData(const std::string& i_rigid_body, const std::string& i_button_device, tracking::Tracker::TrackingData& o_data) {
+tracking::Tracker::ConnectionState tracking::Tracker::get_state(const std::shared_future<bool>& connect) {
+
+    if (!connect.valid()) {
+        return ConnectionState::Disconnected;
+    }
+    if (connect.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return ConnectionState::Connecting;
+    }
+    return (connect.get()) ? (ConnectionState::Connected) : (ConnectionState::Failed);
+}
+
+
+tracking::Tracker::ConnectionState tracking::Tracker::GetMotionDevicesState(void) const {
+
+    return get_state(this->m_motion_connect);
+}
+
+
+tracking::Tracker::ConnectionState tracking::Tracker::GetButtonDeviceState(int button_device) const {
+
+    if ((button_device < 0) || (static_cast<size_t>(button_device) >= this->m_button_connects.size())) {
+        return ConnectionState::Disconnected;
+    }
+    return get_state(this->m_button_connects[button_device]);
+}
+
+
+int tracking::Tracker::ResolveButtonDevice(const std::string& button_device) const {
+
+    for (size_t i = 0; i < this->m_button_devices.size(); ++i) {
+        if (button_device == this->m_button_devices[i]->GetDeviceName()) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+
+bool tracking::Tracker::GetData(int i_rigid_body, int i_button_device, double i_display_time, tracking::Tracker::TrackingData& o_data) {
 
     if (!this->m_initialised) {
         std::cerr << std::endl << "[ERROR] [Tracker] Not initialised. " <<
@@ -168,21 +275,38 @@ bool tracking::Tracker::GetData(const std::string& i_rigid_body, const std::stri
     }
 
 #ifdef TRACKING_DEBUG_OUTPUT
-    std::cout << "[DEBUG] [Tracker] Requested: Button Device \"" << i_button_device.c_str() << "\" and Rigid Body \"" << i_rigid_body.c_str() << "\"." << std::endl;
+    std::cout << "[DEBUG] [Tracker] Requested: Button Device " << i_button_device << " and Rigid Body " << i_rigid_body << "." << std::endl;
 #endif
 
-    // Set data of requested rigid body
-    o_data.rigid_body.orientation = this->m_motion_devices.GetOrientation(i_rigid_body);
-    o_data.rigid_body.position    = this->m_motion_devices.GetPosition(i_rigid_body);
+    // Sequence number is read before the data, so changes in between show up with the next call.
+    bool button_device = ((i_button_device >= 0) && (static_cast<size_t>(i_button_device) < this->m_button_devices.size()));
+    o_data.sequence = this->m_motion_devices.GetRigidBodySequence(i_rigid_body);
+    if (button_device) {
+        o_data.sequence += this->m_button_devices[i_button_device]->GetEventCount();
+    }
+
+    // Set data of requested rigid body (predicted to display time)
+    this->m_motion_devices.GetPredictedRigidBodyData(i_rigid_body, i_display_time, o_data.rigid_body);
 
     // Set data of requested button device 
     o_data.button = 0;
-    for (auto& v : this->m_button_devices) {
-        if (i_button_device == v->GetDeviceName()) {
-            o_data.button = (v->GetButton());
-            break; /// Break if button device is found.
+    o_data.button_time = 0.0;
+    if (button_device && this->m_button_devices[i_button_device]->IsConnected()) {
+        tracking::VrpnButtonDevice::Event event;
+        if (this->m_button_devices[i_button_device]->GetLatestEvent(event)) {
+            o_data.button_time = event.receive_time;
         }
+        o_data.button = this->m_button_devices[i_button_device]->GetButton();
     }
 
     return true;
 }
+
+
+size_t tracking::Tracker::DrainButtonEvents(int i_button_device, uint64_t& io_cursor, size_t i_capacity, tracking::VrpnButtonDevice::Event* o_events) const {
+
+    if ((i_button_device < 0) || (static_cast<size_t>(i_button_device) >= this->m_button_devices.size())) {
+        return 0;
+    }
+    return this->m_button_devices[i_button_device]->DrainEvents(io_cursor, i_capacity, o_events);
+}
@@ -9,9 +9,15 @@
 
 #define TRACKING_FLOAT_MAX ((std::numeric_limits<float>::max)())
 
+// Pose is considered stale if no new frame was received for this many seconds.
+#define TRACKING_STALE_POSE_TIMEOUT (0.1)
+
 tracking::TrackingUtilizer::TrackingUtilizer(void) 
     : m_initialised(false)
     , m_tracker(nullptr)
+    , m_rigid_body_handle(-1)
+    , m_rigid_body_count(0)
+    , m_button_device_handle(-1)
     , m_current_cam_position()
     , m_current_cam_up()
     , m_current_cam_view()
@@ -23,9 +29,14 @@ tracking::TrackingUtilizer::TrackingUtilizer(void)
     , m_current_button()
     , m_current_selecting(false)
     , m_last_button(0)
-    , m_buffer_positions()
-    , m_buffer_idx(0)
-    , m_const_position(false)
+    , m_drain_cursor(0)
+    , m_replay_cursor(0)
+    , m_replay_button(0)
+    , m_replay_time(0.0)
+    , m_select_clicked(false)
+    , m_stale_pose(true)
+    , m_sequence(0)
+    , m_screen_sequence(0)
     , m_start_cam_view()
     , m_start_cam_position()
     , m_start_cam_up()
@@ -68,7 +79,7 @@ tracking::TrackingUtilizer::TrackingUtilizer(void)
 
 tracking::TrackingUtilizer::~TrackingUtilizer(void) {
 
-    // nothing to do here ...
+    this->set_rigid_body_handle(-1);
 }
 
 
@@ -82,6 +93,7 @@ bool tracking::TrackingUtilizer::Initialise(const tracking::TrackingUtilizer::Pa
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
         return false;
     }
+    this->set_rigid_body_handle(-1); /// Release subscription at previous tracker.
     this->m_tracker = m_tracker;
 
     std::string btn_device_name;
@@ -207,6 +219,8 @@ bool tracking::TrackingUtilizer::Initialise(const tracking::TrackingUtilizer::Pa
     if (check) {
         this->m_button_device_name = btn_device_name;
         this->m_rigid_body_name = rigid_body_name;
+        this->set_rigid_body_handle(this->m_tracker->ResolveRigidBody(this->m_rigid_body_name));
+        this->m_button_device_handle = this->m_tracker->ResolveButtonDevice(this->m_button_device_name);
         this->m_select_button = params.select_btn;
         this->m_rotate_button = params.rotate_btn;
         this->m_translate_button = params.translate_btn;
@@ -383,7 +397,7 @@ bool tracking::TrackingUtilizer::read_params_from_file(void) {
 }
 
 
-bool tracking::TrackingUtilizer::GetRawData(unsigned int& o_button,
+bool tracking::TrackingUtilizer::GetRawData(double i_display_time, unsigned int& o_button,
     float& o_position_x, float& o_position_y, float& o_position_z,
     float& o_orientation_x, float& o_orientation_y, float& o_orientation_z, float& o_orientation_w) {
 
@@ -396,7 +410,7 @@ bool tracking::TrackingUtilizer::GetRawData(unsigned int& o_button,
     bool state_rawdata = false;
 
     // Request updated tracking data.
-    if (this->update_tracking_data()) {
+    if (this->update_tracking_data(i_display_time)) {
         o_button = this->m_current_button;
         o_position_x = this->m_current_position.x;
         o_position_y = this->m_current_position.y;
@@ -440,18 +454,34 @@ bool tracking::TrackingUtilizer::GetSelectionState(bool& o_selecttion) {
         state_button = this->process_button_changes();
     }
 
+    // Clicks between two calls are reported once, too.
     if (state_button) {
-        o_selecttion = this->m_current_selecting;
+        o_selecttion = (this->m_current_selecting || this->m_select_clicked);
     }
     else {
         o_selecttion = false;
     }
+    this->m_select_clicked = false;
 
     return (state_button);
 }
 
 
-bool tracking::TrackingUtilizer::GetIntersection(float& o_intersection_x, float& o_intersection_y) {
+size_t tracking::TrackingUtilizer::DrainButtonEvents(size_t i_capacity, tracking::VrpnButtonDevice::Event* o_events) {
+
+    if (!this->m_initialised) {
+        std::cerr << std::endl << "[ERROR] [TrackingUtilizer] Not m_initialised. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return 0;
+    }
+    if (this->m_button_device_handle < 0) {
+        this->m_button_device_handle = this->m_tracker->ResolveButtonDevice(this->m_button_device_name);
+    }
+    return this->m_tracker->DrainButtonEvents(this->m_button_device_handle, this->m_drain_cursor, i_capacity, o_events);
+}
+
+
+bool tracking::TrackingUtilizer::GetIntersection(double i_display_time, float& o_intersection_x, float& o_intersection_y) {
 
     if (!this->m_initialised) {
         std::cerr << std::endl << "[ERROR] [TrackingUtilizer] Not m_initialised. " <<
@@ -462,10 +492,14 @@ bool tracking::TrackingUtilizer::GetIntersection(float& o_intersection_x, float&
     bool state_intersection = false;
 
     // Request updated tracking data.
-    if (this->update_tracking_data()) {
+    if (this->update_tracking_data(i_display_time)) {
 
-        // Calculate new current intersection point and fov rectangle.
-        state_intersection = this->process_screen_interaction(false);
+        // Calculate new current intersection point and fov rectangle (unchanged 
+        // data would not move the intersection beyond the jitter threshold anyway).
+        if ((i_display_time >= 0.0) || (this->m_sequence == 0) || (this->m_sequence != this->m_screen_sequence)) {
+            state_intersection = this->process_screen_interaction(false);
+            this->m_screen_sequence = (i_display_time >= 0.0) ? (0) : (this->m_sequence);
+        }
     }
 
     if (state_intersection) {
@@ -497,8 +531,12 @@ bool tracking::TrackingUtilizer::GetFieldOfView(float& o_left_top_x, float& o_le
     // Request updated tracking data.
     if (this->update_tracking_data()) {
 
-        // Calculate new current intersection point and fov rectangle.
-        state_fov = this->process_screen_interaction(true);
+        // Calculate new current intersection point and fov rectangle (unchanged 
+        // data would not move the intersection beyond the jitter threshold anyway).
+        if ((this->m_sequence == 0) || (this->m_sequence != this->m_screen_sequence)) {
+            state_fov = this->process_screen_interaction(true);
+            this->m_screen_sequence = this->m_sequence;
+        }
     }
 
     if (state_fov) {
@@ -607,6 +645,7 @@ bool tracking::TrackingUtilizer::Calibrate(void) {
     else {
         this->m_calibration_orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
     }
+    this->m_screen_sequence = 0;
 
     std::cout << "[INFO] [TrackingUtilizer] >>> RIGID BODY \"" << this->m_rigid_body_name.c_str() << "\" CALIBRATION ORIENTATION " <<
         this->m_calibration_orientation.x << ";" << this->m_calibration_orientation.y << ";" <<
@@ -618,7 +657,7 @@ bool tracking::TrackingUtilizer::Calibrate(void) {
 }
 
 
-bool tracking::TrackingUtilizer::update_tracking_data(void) {
+bool tracking::TrackingUtilizer::update_tracking_data(double display_time) {
 
     if (this->m_tracker == nullptr) {
         std::cerr << std::endl << "[ERROR] [TrackingUtilizer] There is no tracker connected. " <<
@@ -626,32 +665,51 @@ bool tracking::TrackingUtilizer::update_tracking_data(void) {
         return false;
     }
 
+    // Resolve handles only once, names are unknown until the tracker is connected
+    // or the rigid body is added in the host application.
+    if (this->m_rigid_body_handle < 0) {
+        size_t count = this->m_tracker->GetRigidBodyCount();
+        if (count != this->m_rigid_body_count) {
+            this->m_rigid_body_count = count;
+            this->set_rigid_body_handle(this->m_tracker->ResolveRigidBody(this->m_rigid_body_name));
+        }
+    }
+    if (this->m_button_device_handle < 0) {
+        this->m_button_device_handle = this->m_tracker->ResolveButtonDevice(this->m_button_device_name);
+    }
+
     // Get fresh data from m_tracker
     bool retval = false;
     tracking::Tracker::TrackingData data;
-    if (this->m_tracker->GetData(this->m_rigid_body_name, this->m_button_device_name, data)) {
+    if (this->m_tracker->GetData(this->m_rigid_body_handle, this->m_button_device_handle, display_time, data)) {
+        this->m_sequence             = data.sequence;
         this->m_current_button       = data.button;
         this->m_current_position     = data.rigid_body.position;
         this->m_current_orientation  = data.rigid_body.orientation;
 
+        // Rigid body is no longer tracked if no new frame was received for some time (or the link is lost).
+        this->m_stale_pose = ((data.rigid_body.frame < 0) || data.rigid_body.stale || 
+            ((tracking::GetLocalTime() - data.rigid_body.receive_time) > TRACKING_STALE_POSE_TIMEOUT));
+
 #ifdef TRACKING_DEBUG_OUTPUT
-        std::cout << "[DEBUG] [TrackingUtilizer] Buffer Index = " << this->m_buffer_idx << " - Position Buffer Size = " << this->m_buffer_positions.size() << std::endl;
+        std::cout << "[DEBUG] [TrackingUtilizer] Frame = " << data.rigid_body.frame << " - Stale Pose = " << this->m_stale_pose << std::endl;
 #endif
 
-        // Add current position to position buffer
-        const unsigned int bufferSize = 5; // ! Must be greater than 0 !
-        this->m_buffer_positions.resize(bufferSize);
-        this->m_buffer_positions[this->m_buffer_idx] = this->m_current_position;
-        this->m_buffer_idx = (++this->m_buffer_idx) % bufferSize;
-        // Check if all positions are the same which indicates that rigid body is no longer tracked ...
-        this->m_const_position = true;
-        for (size_t i = 0; i < this->m_buffer_positions.size() - 1; ++i) {
-            if (this->m_buffer_positions[i] != this->m_buffer_positions[i+1]) {
-                this->m_const_position = false;
-                break;
+        retval = true;
+    }
+
+    // Replay button events for the time of the latest change and for detecting clicks of the select button between two polls.
+    std::array<tracking::VrpnButtonDevice::Event, 16> events;
+    size_t count = 0;
+    while ((count = this->m_tracker->DrainButtonEvents(this->m_button_device_handle, this->m_replay_cursor, events.size(), events.data())) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            tracking::Button mask = (1 << events[i].button);
+            this->m_replay_button = (events[i].pressed) ? (this->m_replay_button | mask) : (this->m_replay_button & ~mask);
+            this->m_replay_time   = events[i].receive_time;
+            if ((this->m_select_button != 0) && (this->m_replay_button == this->m_select_button)) {
+                this->m_select_clicked = true;
             }
         }
-        retval = true;
     }
 
 #ifdef TRACKING_DEBUG_OUTPUT
@@ -663,9 +721,25 @@ bool tracking::TrackingUtilizer::update_tracking_data(void) {
 }
 
 
+void tracking::TrackingUtilizer::set_rigid_body_handle(int handle) {
+
+    if (this->m_tracker == nullptr) {
+        this->m_rigid_body_handle = -1;
+        return;
+    }
+    if (handle >= 0) {
+        this->m_tracker->SubscribeRigidBody(handle);
+    }
+    if (this->m_rigid_body_handle >= 0) {
+        this->m_tracker->UnsubscribeRigidBody(this->m_rigid_body_handle);
+    }
+    this->m_rigid_body_handle = handle;
+}
+
+
 bool tracking::TrackingUtilizer::process_button_changes(void) {
 
-    if (this->m_const_position) {
+    if (this->m_stale_pose) {
 #ifdef TRACKING_DEBUG_OUTPUT
         std::cout << "[DEBUG] [TrackingUtilizer] Rigid body \"" << this->m_rigid_body_name.c_str() << "\" is not inside tracking area. " << std::endl;
 #endif
@@ -675,6 +749,18 @@ bool tracking::TrackingUtilizer::process_button_changes(void) {
     bool retval = true;
     if (this->m_last_button != this->m_current_button) {
 
+        // Interactions start from the pose at the time the buttons changed (interpolated from the pose history),
+        // not from the pose at the time the application polls. The current pose is used if the replayed 
+        // button events do not match the current buttons (e.g. events arrived after the buttons were read).
+        glm::quat press_orientation = this->m_current_orientation;
+        glm::vec3 press_position    = this->m_current_position;
+        tracking::NatNetDevicePool::RigidBodyData press;
+        if ((this->m_replay_button == this->m_current_button) && (this->m_replay_time > 0.0) &&
+            this->m_tracker->GetPoseAt(this->m_rigid_body_handle, this->m_replay_time, press)) {
+            press_orientation = press.orientation;
+            press_position    = press.position;
+        }
+
         // Detect reconfiguration of button mapping.
         this->m_is_rotating    = false;
         this->m_is_translating = false;
@@ -742,8 +828,8 @@ bool tracking::TrackingUtilizer::process_button_changes(void) {
                 auto q2 = this->xform(q1 * glm::vec3(0.0f, 1.0f, 0.0f), this->m_start_cam_up);
 
                 this->m_start_relative_orientation = q2 * q1;
-                this->m_start_orientation          = this->m_current_orientation;
-                this->m_start_position             = this->m_current_position;
+                this->m_start_orientation          = press_orientation;
+                this->m_start_position             = press_position;
             }
         }
 
@@ -756,7 +842,7 @@ bool tracking::TrackingUtilizer::process_button_changes(void) {
 
 bool tracking::TrackingUtilizer::process_camera_transformations_3d(void) {
 
-    if (this->m_const_position) {
+    if (this->m_stale_pose) {
 #ifdef TRACKING_DEBUG_OUTPUT
         std::cout << "[DEBUG] [TrackingUtilizer] Rigid body \"" << this->m_rigid_body_name.c_str() << "\" is not inside tracking area. " << std::endl;
 #endif
@@ -867,7 +953,7 @@ bool tracking::TrackingUtilizer::process_camera_transformations_3d(void) {
 
 bool tracking::TrackingUtilizer::process_camera_transformations_2d(void) {
 
-    if (this->m_const_position) {
+    if (this->m_stale_pose) {
 #ifdef TRACKING_DEBUG_OUTPUT
         std::cout << "[DEBUG] [TrackingUtilizer] Rigid body \"" << this->m_rigid_body_name.c_str() << "\" is not inside tracking area. " << std::endl;
 #endif
@@ -933,7 +1019,7 @@ bool tracking::TrackingUtilizer::process_camera_transformations_2d(void) {
 
 bool tracking::TrackingUtilizer::process_screen_interaction(bool process_fov) {
 
-    if (this->m_const_position) {
+    if (this->m_stale_pose) {
 #ifdef TRACKING_DEBUG_OUTPUT
         std::cout << "[DEBUG] [TrackingUtilizer] Rigid body \"" << this->m_rigid_body_name.c_str() << "\" is not inside tracking area. " << std::endl;
 #endif
@@ -7,13 +7,18 @@
 
 #include "VrpnButtonDevice.h"
 
-tracking::VrpnButtonDevice::VrpnButtonDevice(void) : tracking::VrpnDevice<vrpn_Button_Remote>()
+tracking::VrpnButtonDevice::VrpnButtonDevice(tracking::VrpnReactor& reactor, tracking::FrameSignal* signal) : tracking::VrpnDevice<vrpn_Button_Remote>()
     , m_initialised(false)
     , m_connected(false)
-    , m_run_thread_loop(false)
-    , m_button(0) {
-
-    // intentionally empty...
+    , m_button(0)
+    , m_events()
+    , m_reactor(reactor)
+    , m_signal(signal)
+    , m_lost_time(0.0)
+    , m_retry_time(0.0)
+    , m_retry_delay(RECONNECT_DELAY) {
+
+    this->m_events.Allocate(EVENT_CAPACITY);
 }
 
 
@@ -40,29 +45,24 @@ bool tracking::VrpnButtonDevice::Connect(void) {
         return false;
     }
 
-    // Establish connection.
-    if (!tracking::VrpnDevice<vrpn_Button_Remote>::Connect()) { 
-        return false;
-    }
-
-    // Register handle for button changes.
-    this->Register<vrpn_BUTTONCHANGEHANDLER>(&VrpnButtonDevice::on_button_changed, this);
-
-    // Start vrpn main loop thread.
-    std::cout << "[INFO] [VrpnButtonDevice] Starting VRPN main loop thread for \"" << this->GetDeviceName().c_str() << "\"" << std::endl;
-    this->m_run_thread_loop.store(true);
-    std::thread thread([this]() {
-        while (this->m_run_thread_loop.load()) {
-#ifdef TRACKING_DEBUG_OUTPUT
-            //std::cout << "[DEBUG] [VrpnButtonDevice] Inside VRPN main loop ..." << std::endl;
-#endif
-            this->MainLoop();
-            std::this_thread::yield();
+    // Establish connection and register handle for button changes (the connection may be shared with devices run by the reactor).
+    bool connected = this->m_reactor.Run([this]() {
+        if (!tracking::VrpnDevice<vrpn_Button_Remote>::Connect()) {
+            return false;
         }
+        this->Register<vrpn_BUTTONCHANGEHANDLER>(&VrpnButtonDevice::on_button_changed, this);
+        return true;
     });
-    thread.detach();
+    if (!connected) {
+        return false;
+    }
 
+    // Run main loop by the shared reactor thread.
+    this->m_lost_time   = 0.0;
+    this->m_retry_time  = 0.0;
+    this->m_retry_delay = RECONNECT_DELAY;
     this->m_connected = true;
+    this->m_reactor.Add(this);
 
     return true;
 }
@@ -70,12 +70,55 @@ bool tracking::VrpnButtonDevice::Connect(void) {
 
 bool tracking::VrpnButtonDevice::Disconnect(void) {
 
-    // End main loop thread
-    this->m_run_thread_loop.store(false);
+    // The reactor does not access the device anymore after removing.
+    this->m_reactor.Remove(this);
 
     this->m_connected = false;
 
-    return tracking::VrpnDevice<vrpn_Button_Remote>::Disconnect();
+    return this->m_reactor.Run([this]() { return tracking::VrpnDevice<vrpn_Button_Remote>::Disconnect(); });
+}
+
+
+vrpn_Connection* tracking::VrpnButtonDevice::GetReactorConnection(void) {
+
+    return this->GetConnection();
+}
+
+
+void tracking::VrpnButtonDevice::React(void) {
+
+#ifdef TRACKING_DEBUG_OUTPUT
+    //std::cout << "[DEBUG] [VrpnButtonDevice] Inside VRPN main loop ..." << std::endl;
+#endif
+
+    // Watchdog: release all buttons while the link is down and recreate the remote device with exponential backoff.
+    if (this->IsLinkUp()) {
+        this->m_lost_time   = 0.0;
+        this->m_retry_delay = RECONNECT_DELAY;
+    }
+    else {
+        double now = tracking::GetLocalTime();
+        if (this->m_lost_time <= 0.0) {
+            this->m_lost_time  = now;
+            this->m_retry_time = now + this->m_retry_delay;
+            this->release_buttons();
+        }
+        else if (now >= this->m_retry_time) {
+            std::cout << "[WARNING] [VrpnButtonDevice] Lost link to \"" << this->GetDeviceName().c_str() << "\" for " << (now - this->m_lost_time) << " s, reconnecting ..." << std::endl;
+            if (this->Reconnect()) {
+                this->Register<vrpn_BUTTONCHANGEHANDLER>(&VrpnButtonDevice::on_button_changed, this);
+            }
+            this->m_retry_delay *= 2.0;
+            if (this->m_retry_delay > RECONNECT_DELAY_MAX) {
+                this->m_retry_delay = RECONNECT_DELAY_MAX;
+            }
+            this->m_retry_time = tracking::GetLocalTime() + this->m_retry_delay;
+        }
+        if (!this->HasRemoteDevice()) {
+            return; /// No remote device until the next attempt.
+        }
+    }
+    this->MainLoop();
 }
 
 
@@ -86,7 +129,7 @@ tracking::Button tracking::VrpnButtonDevice::GetButton(void) const {
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
         return false;
     }
-    if (!this->m_connected) {
+    if (!this->m_connected.load()) {
         std::cerr << std::endl << "[ERROR] [VrpnButtonDevice] Not connected. " <<
             "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
         return false;
@@ -96,6 +139,64 @@ tracking::Button tracking::VrpnButtonDevice::GetButton(void) const {
 }
 
 
+size_t tracking::VrpnButtonDevice::DrainEvents(uint64_t& io_cursor, size_t capacity, Event* o_events) const {
+
+    if ((o_events == nullptr) && (capacity > 0)) {
+        std::cerr << std::endl << "[ERROR] [VrpnButtonDevice] Pointer to events is NULL. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return 0;
+    }
+
+    size_t count = 0;
+    uint64_t end = this->m_events.GetEnd();
+    while ((count < capacity) && (io_cursor < end)) {
+        if (io_cursor < this->m_events.GetBegin()) {
+            io_cursor = this->m_events.GetBegin(); /// Skip overwritten events.
+            continue;
+        }
+        if (this->m_events.Get(io_cursor, o_events[count])) {
+            ++count;
+        }
+        ++io_cursor;
+    }
+    return count;
+}
+
+
+bool tracking::VrpnButtonDevice::GetLatestEvent(Event& o_event) const {
+
+    // Retry if the latest event is overwritten meanwhile (requires EVENT_CAPACITY events in between).
+    uint64_t end = this->m_events.GetEnd();
+    while (end > 0) {
+        if (this->m_events.Get(end - 1, o_event)) {
+            return true;
+        }
+        end = this->m_events.GetEnd();
+    }
+    return false;
+}
+
+
+void tracking::VrpnButtonDevice::release_buttons(void) {
+
+    tracking::Button button = this->m_button.exchange(0);
+    double now = tracking::GetLocalTime();
+    for (int i = 0; button != 0; ++i, button >>= 1) {
+        if ((button & 1) != 0) {
+            Event event;
+            event.button       = i;
+            event.pressed      = false;
+            event.timestamp    = 0.0;
+            event.receive_time = now;
+            this->m_events.Push(event);
+            if (this->m_signal != nullptr) {
+                this->m_signal->Notify();
+            }
+        }
+    }
+}
+
+
 void VRPN_CALLBACK tracking::VrpnButtonDevice::on_button_changed(void *userData, const vrpn_BUTTONCB vrpnData) {
 
     auto that = static_cast<VrpnButtonDevice*>(userData);
@@ -114,6 +215,17 @@ void VRPN_CALLBACK tracking::VrpnButtonDevice::on_button_changed(void *userData,
     else {
         that->m_button.store(m_button &= ~mask);
     }
+
+    // Record the transition (callbacks are only called by the reactor thread).
+    Event event;
+    event.button       = static_cast<int>(vrpnData.button);
+    event.pressed      = (vrpnData.state != 0);
+    event.timestamp    = static_cast<double>(vrpnData.msg_time.tv_sec) + static_cast<double>(vrpnData.msg_time.tv_usec) * 0.000001;
+    event.receive_time = tracking::GetLocalTime();
+    that->m_events.Push(event);
+    if (that->m_signal != nullptr) {
+        that->m_signal->Notify();
+    }
 #ifdef TRACKING_DEBUG_OUTPUT
     std::cout << "[DEBUG] [VrpnButtonDevice] Button = " << vrpnData.button << " | State = " << ((mask & (1 << vrpnData.button)) ? (1) : (0)) << std::endl;
 #endif
@@ -0,0 +1,220 @@
+/**
+ * VrpnReactor.cpp
+ *
+ * Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "VrpnReactor.h"
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (-1)
+#endif
+
+
+namespace {
+
+    /**
+    * Access to the endpoints of a VRPN connection, which VRPN keeps
+    * protected (read through a pointer to the protected member, the class
+    * is never instantiated).
+    */
+    class ConnectionAccess : public vrpn_Connection {
+    public:
+        static const vrpn::EndpointContainer& Endpoints(const vrpn_Connection* connection) {
+            return connection->*(&ConnectionAccess::d_endpoints);
+        }
+    };
+
+    /** Access to the sockets of a VRPN endpoint (see ConnectionAccess). */
+    class EndpointAccess : public vrpn_Endpoint_IP {
+    public:
+        static void Sockets(const vrpn_Endpoint_IP* endpoint, std::vector<SOCKET>& io_sockets) {
+            SOCKET tcp = endpoint->*(&EndpointAccess::d_tcpSocket);
+            SOCKET udp = endpoint->*(&EndpointAccess::d_udpInboundSocket);
+            if (tcp != INVALID_SOCKET) {
+                io_sockets.emplace_back(tcp);
+            }
+            if (udp != INVALID_SOCKET) {
+                io_sockets.emplace_back(udp);
+            }
+        }
+    };
+
+    /** Endpoint containers of VRPN versions iterate over pointers or references. */
+    inline const vrpn_Endpoint_IP* endpoint_ptr(const vrpn_Endpoint_IP* endpoint) {
+        return endpoint;
+    }
+    inline const vrpn_Endpoint_IP* endpoint_ptr(const vrpn_Endpoint_IP& endpoint) {
+        return &endpoint;
+    }
+
+    /**
+    * Append the sockets of a connection.
+    *
+    * @return True for success, false if the connection has no socket.
+    */
+    bool get_sockets(const vrpn_Connection* connection, std::vector<SOCKET>& io_sockets) {
+        size_t count = io_sockets.size();
+        for (auto& endpoint : ConnectionAccess::Endpoints(connection)) {
+            if (endpoint_ptr(endpoint) != nullptr) {
+                EndpointAccess::Sockets(endpoint_ptr(endpoint), io_sockets);
+            }
+        }
+        return (io_sockets.size() > count);
+    }
+}
+
+tracking::VrpnReactor::VrpnReactor(void)
+    : m_mutex()
+    , m_devices()
+    , m_thread()
+    , m_generation(0) {
+
+    // intentionally empty...
+}
+
+
+tracking::VrpnReactor::~VrpnReactor(void) {
+
+    this->stop();
+}
+
+
+bool tracking::VrpnReactor::Add(Device* device) {
+
+    if (device == nullptr) {
+        std::cerr << std::endl << "[ERROR] [VrpnReactor] Pointer to device is NULL. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    for (auto d : this->m_devices) {
+        if (d == device) {
+            return false;
+        }
+    }
+    this->m_devices.emplace_back(device);
+
+    if (!this->m_thread.joinable()) {
+        std::cout << "[INFO] [VrpnReactor] Starting VRPN reactor thread ..." << std::endl;
+        this->m_thread = std::thread(&VrpnReactor::run, this, this->m_generation);
+    }
+    return true;
+}
+
+
+bool tracking::VrpnReactor::Remove(Device* device) {
+
+    bool removed = false;
+    bool empty   = false;
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        for (auto it = this->m_devices.begin(); it != this->m_devices.end(); ++it) {
+            if (*it == device) {
+                this->m_devices.erase(it);
+                removed = true;
+                break;
+            }
+        }
+        empty = this->m_devices.empty();
+    }
+
+    if (empty) {
+        this->stop();
+    }
+    return removed;
+}
+
+
+bool tracking::VrpnReactor::Run(const std::function<bool(void)>& function) {
+
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+    return function();
+}
+
+
+void tracking::VrpnReactor::stop(void) {
+
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        if (!this->m_devices.empty() || !this->m_thread.joinable()) {
+            return; /// Device added meanwhile or already stopped.
+        }
+        this->m_generation++;
+        thread = std::move(this->m_thread);
+    }
+
+    // Join without lock, the thread ends as soon as it gets the lock again.
+    thread.join();
+    std::cout << "[INFO] [VrpnReactor] Stopped VRPN reactor thread." << std::endl;
+}
+
+
+void tracking::VrpnReactor::run(uint64_t generation) {
+
+    std::vector<vrpn_Connection*> connections;
+    std::vector<SOCKET> sockets;
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+    while (this->m_generation == generation) {
+
+        // Devices of the same server share one connection.
+        connections.clear();
+        for (auto d : this->m_devices) {
+            vrpn_Connection* connection = d->GetReactorConnection();
+            if ((connection != nullptr) && (connection->connected() == vrpn_true) &&
+                (std::find(connections.begin(), connections.end(), connection) == connections.end())) {
+                connections.emplace_back(connection);
+            }
+        }
+
+        // Wait for data of all connections at once (connections are established by the main loops of the devices).
+        sockets.clear();
+        bool waitable = !connections.empty();
+        for (auto connection : connections) {
+            waitable = (get_sockets(connection, sockets) && waitable);
+        }
+        if (connections.empty()) {
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(IDLE_TIME)));
+            lock.lock();
+        }
+        else if (waitable) {
+            fd_set readable;
+            FD_ZERO(&readable);
+            SOCKET max_socket = 0;
+            for (auto socket : sockets) {
+                FD_SET(socket, &readable);
+                max_socket = (std::max)(max_socket, socket);
+            }
+            struct timeval timeout;
+            timeout.tv_sec  = 0;
+            timeout.tv_usec = WAIT_TIME;
+            select(static_cast<int>(max_socket) + 1, &readable, nullptr, nullptr, &timeout); /// Errors only end the wait early, data is read by the main loops of the devices.
+        }
+        else {
+            // Fallback for connections without sockets: wait for one connection after the other.
+            long wait = (connections.size() == 1) ? (WAIT_TIME) : (RESPONSE_TIME / static_cast<long>(connections.size()));
+            for (auto connection : connections) {
+                struct timeval timeout;
+                timeout.tv_sec  = 0;
+                timeout.tv_usec = wait;
+                connection->mainloop(&timeout);
+            }
+        }
+        if (this->m_generation != generation) {
+            break;
+        }
+
+        for (auto d : this->m_devices) {
+            d->React();
+        }
+
+        // Give Add() and Remove() a chance to get the lock.
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+    }
+}
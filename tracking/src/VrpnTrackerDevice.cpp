@@ -0,0 +1,216 @@
+/**
+* VrpnTrackerDevice.cpp
+*
+* Copyright (C) 2018 by VISUS (Universitaet Stuttgart)
+* Alle Rechte vorbehalten.
+*/
+
+#include "VrpnTrackerDevice.h"
+
+tracking::VrpnTrackerDevice::VrpnTrackerDevice(tracking::VrpnReactor& reactor, tracking::NatNetDevicePool& pool) : tracking::VrpnDevice<vrpn_Tracker_Remote>()
+    , m_initialised(false)
+    , m_connected(false)
+    , m_reactor(reactor)
+    , m_pool(pool)
+    , m_rigid_body(-1)
+    , m_frame(0)
+    , m_lost_time(0.0)
+    , m_retry_time(0.0)
+    , m_retry_delay(RECONNECT_DELAY)
+    , m_rigid_body_name()
+    , m_sensor(0) {
+
+    // intentionally empty...
+}
+
+
+tracking::VrpnTrackerDevice::~VrpnTrackerDevice(void) {
+
+    this->Disconnect();
+}
+
+
+bool tracking::VrpnTrackerDevice::Initialise(const VrpnTrackerDevice::Params& params) {
+
+    bool check = true;
+    this->m_initialised = false;
+
+    std::string rigid_body_name;
+    try {
+        rigid_body_name = std::string(params.rigid_body_name);
+        if (rigid_body_name.length() != params.rigid_body_name_len) {
+            std::cerr << std::endl << "[ERROR] [VrpnTrackerDevice] String \"rigid_body_name\" has not expected length. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+        }
+        if (rigid_body_name.empty()) {
+            std::cerr << std::endl << "[ERROR] [VrpnTrackerDevice] Parameter \"rigid_body_name\" must not be empty string. " <<
+                "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+            check = false;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << std::endl << "[ERROR] [VrpnTrackerDevice] Error reading string param 'rigid_body_name': " << e.what() <<
+            " [" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+
+    if (params.sensor < 0) {
+        std::cerr << std::endl << "[ERROR] [VrpnTrackerDevice] Parameter \"sensor\" must not be negative. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        check = false;
+    }
+
+    if (!tracking::VrpnDevice<vrpn_Tracker_Remote>::Initialise(params.device)) {
+        check = false;
+    }
+
+    if (check) {
+        this->m_rigid_body = this->m_pool.AddExternalRigidBody(rigid_body_name);
+        if (this->m_rigid_body >= 0) {
+            this->m_rigid_body_name = rigid_body_name;
+            this->m_sensor = params.sensor;
+
+            this->print_params();
+            this->m_initialised = true;
+        }
+    }
+
+    return this->m_initialised;
+}
+
+
+void tracking::VrpnTrackerDevice::print_params(void) {
+    std::cout << "[PARAMETER] [VrpnTrackerDevice] Rigid Body Name:        " << this->m_rigid_body_name.c_str() << std::endl;
+    std::cout << "[PARAMETER] [VrpnTrackerDevice] Sensor:                 " << this->m_sensor << std::endl;
+}
+
+
+bool tracking::VrpnTrackerDevice::Connect(void) {
+
+    if (!this->m_initialised) {
+        std::cerr << std::endl << "[ERROR] [VrpnTrackerDevice] Not initialised. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return false;
+    }
+
+    // Establish connection and register handle for poses of all sensors, filtered in the callback (the connection may be shared with devices run by the reactor).
+    bool connected = this->m_reactor.Run([this]() {
+        if (!tracking::VrpnDevice<vrpn_Tracker_Remote>::Connect()) {
+            return false;
+        }
+        this->Register<vrpn_TRACKERCHANGEHANDLER>(&VrpnTrackerDevice::on_pose_changed, this);
+        return true;
+    });
+    if (!connected) {
+        return false;
+    }
+
+    // Run main loop by the shared reactor thread.
+    this->m_lost_time   = 0.0;
+    this->m_retry_time  = 0.0;
+    this->m_retry_delay = RECONNECT_DELAY;
+    this->m_connected = true;
+    this->m_reactor.Add(this);
+
+    return true;
+}
+
+
+bool tracking::VrpnTrackerDevice::Disconnect(void) {
+
+    // The reactor does not access the device anymore after removing.
+    this->m_reactor.Remove(this);
+
+    if (this->m_connected.exchange(false)) {
+        this->set_stale();
+    }
+
+    return this->m_reactor.Run([this]() { return tracking::VrpnDevice<vrpn_Tracker_Remote>::Disconnect(); });
+}
+
+
+vrpn_Connection* tracking::VrpnTrackerDevice::GetReactorConnection(void) {
+
+    return this->GetConnection();
+}
+
+
+void tracking::VrpnTrackerDevice::React(void) {
+
+    // Watchdog: flag the latest pose stale while the link is down and recreate the remote device with exponential backoff.
+    if (this->IsLinkUp()) {
+        this->m_lost_time   = 0.0;
+        this->m_retry_delay = RECONNECT_DELAY;
+    }
+    else {
+        double now = tracking::GetLocalTime();
+        if (this->m_lost_time <= 0.0) {
+            this->m_lost_time  = now;
+            this->m_retry_time = now + this->m_retry_delay;
+            this->set_stale();
+        }
+        else if (now >= this->m_retry_time) {
+            std::cout << "[WARNING] [VrpnTrackerDevice] Lost link to \"" << this->GetDeviceName().c_str() << "\" for " << (now - this->m_lost_time) << " s, reconnecting ..." << std::endl;
+            if (this->Reconnect()) {
+                this->Register<vrpn_TRACKERCHANGEHANDLER>(&VrpnTrackerDevice::on_pose_changed, this);
+            }
+            this->m_retry_delay *= 2.0;
+            if (this->m_retry_delay > RECONNECT_DELAY_MAX) {
+                this->m_retry_delay = RECONNECT_DELAY_MAX;
+            }
+            this->m_retry_time = tracking::GetLocalTime() + this->m_retry_delay;
+        }
+        if (!this->HasRemoteDevice()) {
+            return; /// No remote device until the next attempt.
+        }
+    }
+    this->MainLoop();
+}
+
+
+void tracking::VrpnTrackerDevice::set_stale(void) {
+
+    tracking::NatNetDevicePool::RigidBodyData data;
+    data.orientation   = glm::quat();
+    data.position      = glm::vec3();
+    data.frame         = -1;
+    data.timestamp     = 0.0;
+    data.exposure_time = 0.0;
+    data.receive_time  = 0.0;
+    data.mean_error    = 0.0f;
+    data.stale         = true;
+    this->m_pool.StoreExternalRigidBodyData(this->m_rigid_body, data);
+}
+
+
+void VRPN_CALLBACK tracking::VrpnTrackerDevice::on_pose_changed(void *userData, const vrpn_TRACKERCB vrpnData) {
+
+    auto that = static_cast<VrpnTrackerDevice*>(userData);
+    if (that == nullptr) {
+        std::cerr << std::endl << "[ERROR] [VrpnTrackerDevice] Invalid user data. " <<
+            "[" << __FILE__ << ", " << __FUNCTION__ << ", line " << __LINE__ << "]" << std::endl << std::endl;
+        return;
+    }
+    if (vrpnData.sensor != that->m_sensor) {
+        return;
+    }
+
+    // Store the pose (callbacks are only called by the reactor thread), VRPN quaternions are ordered x, y, z, w.
+    double now = tracking::GetLocalTime();
+    tracking::NatNetDevicePool::RigidBodyData data;
+    data.orientation   = glm::quat(static_cast<float>(vrpnData.quat[3]), static_cast<float>(vrpnData.quat[0]),
+        static_cast<float>(vrpnData.quat[1]), static_cast<float>(vrpnData.quat[2]));
+    data.position      = glm::vec3(static_cast<float>(vrpnData.pos[0]), static_cast<float>(vrpnData.pos[1]), static_cast<float>(vrpnData.pos[2]));
+    data.frame         = that->m_frame++;
+    data.timestamp     = static_cast<double>(vrpnData.msg_time.tv_sec) + static_cast<double>(vrpnData.msg_time.tv_usec) * 0.000001;
+    data.exposure_time = now;
+    data.receive_time  = now;
+    data.mean_error    = 0.0f;
+    data.stale         = false;
+    that->m_pool.StoreExternalRigidBodyData(that->m_rigid_body, data);
+
+#ifdef TRACKING_DEBUG_OUTPUT
+    std::cout << "[DEBUG] [VrpnTrackerDevice] Sensor = " << vrpnData.sensor << " | Position = " << data.position.x << ";" << data.position.y << ";" << data.position.z << std::endl;
+#endif
+}